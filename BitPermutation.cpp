@@ -0,0 +1,122 @@
+#include "BitPermutation.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// pext/pdep are compiled for x86-64 whatever the build flags and only
+// called once the CPU has been seen to support them.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BITPERMUTATION_BMI2 1
+#include <immintrin.h>
+
+namespace {
+__attribute__((target("bmi2"))) uint64_t extractDeposit(uint64_t value, uint64_t from, uint64_t to) {
+    return _pdep_u64(_pext_u64(value, from), to);
+}
+} // namespace
+#endif
+
+BitPermutation::BitPermutation(const std::vector<std::pair<unsigned int, unsigned int>>& pairs)
+    : logical(0), physical(0), bmi2(false) {
+    for (const auto& pair : pairs) {
+        if (pair.first >= 64 || pair.second >= 64) {
+            throw std::invalid_argument("BitPermutation bits must be below 64");
+        }
+        const uint64_t logicalBit = uint64_t(1) << pair.first;
+        const uint64_t physicalBit = uint64_t(1) << pair.second;
+        if ((logical & logicalBit) || (physical & physicalBit)) {
+            throw std::invalid_argument("BitPermutation bit used twice");
+        }
+        logical |= logicalBit;
+        physical |= physicalBit;
+    }
+
+    // pext/pdep only apply when the i-th lowest logical bit maps to the i-th
+    // lowest physical bit.
+    bool orderPreserving = true;
+    for (const auto& a : pairs) {
+        for (const auto& b : pairs) {
+            if ((a.first < b.first) != (a.second < b.second)) {
+                orderPreserving = false;
+            }
+        }
+    }
+
+#if defined(BITPERMUTATION_BMI2)
+    bmi2 = orderPreserving && __builtin_cpu_supports("bmi2");
+#endif
+    if (!bmi2) {
+        buildTables(pairs);
+    }
+}
+
+void BitPermutation::buildTables(const std::vector<std::pair<unsigned int, unsigned int>>& pairs) {
+    // Only bytes up to the highest mapped bit need a table.
+    std::size_t logicalBytes = 0;
+    std::size_t physicalBytes = 0;
+    for (const auto& pair : pairs) {
+        logicalBytes = std::max<std::size_t>(logicalBytes, pair.first / 8 + 1);
+        physicalBytes = std::max<std::size_t>(physicalBytes, pair.second / 8 + 1);
+    }
+    forward.assign(logicalBytes, Table());
+    reverse.assign(physicalBytes, Table());
+    for (Table& table : forward) {
+        table.fill(0);
+    }
+    for (Table& table : reverse) {
+        table.fill(0);
+    }
+
+    for (const auto& pair : pairs) {
+        const uint64_t logicalBit = uint64_t(1) << pair.first;
+        const uint64_t physicalBit = uint64_t(1) << pair.second;
+        for (unsigned int value = 0; value < 256; ++value) {
+            if (value & (1u << (pair.first % 8))) {
+                forward[pair.first / 8][value] |= physicalBit;
+            }
+            if (value & (1u << (pair.second % 8))) {
+                reverse[pair.second / 8][value] |= logicalBit;
+            }
+        }
+    }
+}
+
+uint64_t BitPermutation::lookup(const std::vector<Table>& tables, uint64_t mask, uint64_t value) {
+    value &= mask;
+    uint64_t result = 0;
+    // The mask keeps value within the tables, which stop at the highest mapped byte.
+    for (std::size_t byte = 0; byte < tables.size() && value; ++byte, value >>= 8) {
+        result |= tables[byte][value & 0xFF];
+    }
+    return result;
+}
+
+uint64_t BitPermutation::toPhysical(uint64_t value) const {
+#if defined(BITPERMUTATION_BMI2)
+    if (bmi2) {
+        return extractDeposit(value, logical, physical);
+    }
+#endif
+    return lookup(forward, logical, value);
+}
+
+uint64_t BitPermutation::toLogical(uint64_t value) const {
+#if defined(BITPERMUTATION_BMI2)
+    if (bmi2) {
+        return extractDeposit(value, physical, logical);
+    }
+#endif
+    return lookup(reverse, physical, value);
+}
+
+uint64_t BitPermutation::logicalMask() const {
+    return logical;
+}
+
+uint64_t BitPermutation::physicalMask() const {
+    return physical;
+}
+
+bool BitPermutation::usesBmi2() const {
+    return bmi2;
+}
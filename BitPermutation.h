@@ -0,0 +1,99 @@
+#ifndef BITPERMUTATION_H
+#define BITPERMUTATION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Precomputed mapping between logical bit positions and physical line bits.
+ *
+ * When the physical bits keep the logical order (only gaps, no crossings) and
+ * the CPU has BMI2 (checked once at run time on x86-64, so no -mbmi2 build is
+ * needed), the mapping is a pair of pext/pdep instructions and no tables are
+ * built. Otherwise it uses one 256-entry table per byte up to the highest
+ * mapped bit, so a 64-bit word costs at most eight lookups instead of 64 bit
+ * tests. Wiring known at build time can use StaticBitPermutation instead.
+ */
+class BitPermutation {
+public:
+    /**
+     * @brief Builds the mapping.
+     * @param pairs (logical bit, physical bit) pairs, both below 64 and unique.
+     * @throws std::invalid_argument if a bit is out of range or used twice.
+     */
+    explicit BitPermutation(const std::vector<std::pair<unsigned int, unsigned int>>& pairs);
+
+    /**
+     * @brief Scatters logical bits to their physical positions.
+     */
+    uint64_t toPhysical(uint64_t logical) const;
+
+    /**
+     * @brief Gathers physical bits back to their logical positions.
+     */
+    uint64_t toLogical(uint64_t physical) const;
+
+    uint64_t logicalMask() const;
+    uint64_t physicalMask() const;
+
+    /**
+     * @brief Returns true if the pext/pdep path is used.
+     */
+    bool usesBmi2() const;
+
+private:
+    using Table = std::array<uint64_t, 256>;
+
+    static uint64_t lookup(const std::vector<Table>& tables, uint64_t mask, uint64_t value);
+    void buildTables(const std::vector<std::pair<unsigned int, unsigned int>>& pairs);
+
+    uint64_t logical;
+    uint64_t physical;
+    bool bmi2;
+    std::vector<Table> forward;     ///< Per logical byte: physical bits for each byte value; empty with BMI2
+    std::vector<Table> reverse;     ///< Per physical byte: logical bits for each byte value; empty with BMI2
+};
+
+/**
+ * @brief Compile-time mapping where logical bit i goes to PhysicalBits[i].
+ *
+ * Expands to a fixed sequence of shifts and masks that the compiler folds,
+ * for buses whose wiring is known at build time.
+ */
+template <unsigned int... PhysicalBits>
+struct StaticBitPermutation {
+    static_assert(sizeof...(PhysicalBits) <= 64, "At most 64 bits");
+    static_assert(((PhysicalBits < 64) && ...), "Physical bits must be below 64");
+
+    static constexpr uint64_t toPhysical(uint64_t logical) {
+        return scatter(logical, std::make_index_sequence<sizeof...(PhysicalBits)>());
+    }
+
+    static constexpr uint64_t toLogical(uint64_t physical) {
+        return gather(physical, std::make_index_sequence<sizeof...(PhysicalBits)>());
+    }
+
+    static constexpr uint64_t physicalMask() {
+        return ((uint64_t(1) << PhysicalBits) | ... | uint64_t(0));
+    }
+
+    static constexpr std::size_t width() {
+        return sizeof...(PhysicalBits);
+    }
+
+private:
+    template <std::size_t... I>
+    static constexpr uint64_t scatter(uint64_t value, std::index_sequence<I...>) {
+        return ((((value >> I) & uint64_t(1)) << PhysicalBits) | ... | uint64_t(0));
+    }
+
+    template <std::size_t... I>
+    static constexpr uint64_t gather(uint64_t value, std::index_sequence<I...>) {
+        return ((((value >> PhysicalBits) & uint64_t(1)) << I) | ... | uint64_t(0));
+    }
+};
+
+#endif // BITPERMUTATION_H
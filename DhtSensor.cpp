@@ -0,0 +1,189 @@
+#include "DhtSensor.h"
+
+#include <fcntl.h>
+#include <linux/gpio.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+// A high pulse longer than this is a 1 bit (0: ~27 us, 1: ~70 us).
+constexpr std::chrono::microseconds BIT_THRESHOLD(48);
+// The response (80 us low, 80 us high, 40 bits of at most 120 us) ends within ~5 ms.
+constexpr std::chrono::milliseconds CAPTURE_WINDOW(10);
+constexpr std::chrono::seconds MIN_INTERVAL(2);
+// Response edges: 2 for the preamble and 2 per bit, plus slack.
+constexpr std::size_t EVENT_BUFFER = 128;
+
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+} // namespace
+
+DhtSensor::DhtSensor(int pin, Model model, const std::string& chipName)
+    : chipFd(-1), lineFd(-1), model(model), started(false) {
+    const std::string path = "/dev/" + chipName;
+    chipFd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (chipFd < 0) {
+        throw systemError("Failed to open GPIO chip " + path);
+    }
+
+    gpio_v2_line_request request{};
+    request.offsets[0] = static_cast<__u32>(pin);
+    request.num_lines = 1;
+    request.event_buffer_size = EVENT_BUFFER;
+    std::strncpy(request.consumer, "DhtSensor", sizeof(request.consumer) - 1);
+    request.config.flags = GPIO_V2_LINE_FLAG_INPUT;
+    if (::ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &request) < 0) {
+        const std::runtime_error error = systemError("Failed to request DHT data line");
+        ::close(chipFd);
+        throw error;
+    }
+    lineFd = request.fd;
+}
+
+DhtSensor::~DhtSensor() {
+    ::close(lineFd);
+    ::close(chipFd);
+}
+
+void DhtSensor::configure(uint64_t flags, bool low) {
+    gpio_v2_line_config config{};
+    config.flags = flags;
+    if (flags & GPIO_V2_LINE_FLAG_OUTPUT) {
+        config.num_attrs = 1;
+        config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+        config.attrs[0].attr.values = low ? 0 : 1;
+        config.attrs[0].mask = 1;
+    }
+    if (::ioctl(lineFd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) < 0) {
+        throw systemError("Failed to reconfigure DHT data line");
+    }
+}
+
+std::vector<EdgeEvent> DhtSensor::exchange() {
+    // DHT11 needs at least 18 ms low; DHT22 at least 1 ms.
+    const auto low = model == Model::DHT11 ? std::chrono::microseconds(20000) : std::chrono::microseconds(1100);
+    configure(GPIO_V2_LINE_FLAG_OUTPUT | GPIO_V2_LINE_FLAG_OPEN_DRAIN, true);
+    std::this_thread::sleep_for(low);
+    // One ioctl ends the start pulse and arms edge detection.
+    configure(GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING, false);
+    lastStart = std::chrono::steady_clock::now();
+    started = true;
+
+    std::vector<EdgeEvent> edges;
+    gpio_v2_line_event events[16];
+    const auto end = lastStart + CAPTURE_WINDOW;
+    while (true) {
+        const auto remaining =
+            std::chrono::duration_cast<std::chrono::milliseconds>(end - std::chrono::steady_clock::now());
+        pollfd descriptor{lineFd, POLLIN, 0};
+        const int ready = ::poll(&descriptor, 1, remaining.count() > 0 ? static_cast<int>(remaining.count()) : 0);
+        if (ready < 0 && errno != EINTR) {
+            configure(GPIO_V2_LINE_FLAG_INPUT, false);
+            throw systemError("Failed to wait for DHT response");
+        }
+        if (ready <= 0) {
+            if (remaining.count() <= 0) {
+                break;
+            }
+            continue;
+        }
+        const ssize_t bytes = ::read(lineFd, events, sizeof(events));
+        if (bytes < 0) {
+            configure(GPIO_V2_LINE_FLAG_INPUT, false);
+            throw systemError("Failed to read DHT response edges");
+        }
+        for (std::size_t i = 0; i < static_cast<std::size_t>(bytes) / sizeof(events[0]); ++i) {
+            edges.push_back({events[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE,
+                             std::chrono::nanoseconds(events[i].timestamp_ns)});
+        }
+    }
+    // Disarm edge detection; the line stays a released input.
+    configure(GPIO_V2_LINE_FLAG_INPUT, false);
+    return edges;
+}
+
+bool DhtSensor::decodeBytes(const std::vector<EdgeEvent>& edges, uint8_t bytes[5]) {
+    // Collect the width of every complete high pulse; the data bits are the
+    // last 40 of them (earlier ones are the 80 us response and any
+    // pull-up high before it).
+    std::vector<std::chrono::nanoseconds> highs;
+    for (std::size_t i = 1; i < edges.size(); ++i) {
+        if (edges[i - 1].rising && !edges[i].rising) {
+            highs.push_back(edges[i].timestamp - edges[i - 1].timestamp);
+        }
+    }
+    if (highs.size() < 40) {
+        return false;
+    }
+
+    const std::size_t first = highs.size() - 40;
+    for (int i = 0; i < 5; ++i) {
+        bytes[i] = 0;
+    }
+    for (std::size_t bit = 0; bit < 40; ++bit) {
+        if (highs[first + bit] > BIT_THRESHOLD) {
+            bytes[bit / 8] |= static_cast<uint8_t>(0x80 >> (bit % 8));
+        }
+    }
+    return true;
+}
+
+std::optional<DhtSensor::Reading> DhtSensor::convert(const uint8_t bytes[5], Model model) {
+    const uint8_t sum = static_cast<uint8_t>(bytes[0] + bytes[1] + bytes[2] + bytes[3]);
+    if (sum != bytes[4]) {
+        return std::nullopt;
+    }
+    Reading reading;
+    if (model == Model::DHT11) {
+        reading.humidity = bytes[0] + bytes[1] / 10.0;
+        reading.temperature = bytes[2] + bytes[3] / 10.0;
+    } else {
+        reading.humidity = ((bytes[0] << 8) | bytes[1]) / 10.0;
+        const int raw = ((bytes[2] & 0x7F) << 8) | bytes[3];
+        reading.temperature = ((bytes[2] & 0x80) ? -raw : raw) / 10.0;
+    }
+    return reading;
+}
+
+std::optional<DhtSensor::Reading> DhtSensor::decode(const std::vector<EdgeEvent>& edges) {
+    std::lock_guard<std::mutex> lock(mtx);
+    ++counters.attempts;
+    uint8_t bytes[5];
+    if (!decodeBytes(edges, bytes)) {
+        ++counters.incomplete;
+        return std::nullopt;
+    }
+    std::optional<Reading> reading = convert(bytes, model);
+    if (!reading) {
+        ++counters.checksumErrors;
+        return std::nullopt;
+    }
+    ++counters.successes;
+    return reading;
+}
+
+std::optional<DhtSensor::Reading> DhtSensor::read(int retries) {
+    for (int attempt = 0; attempt <= retries; ++attempt) {
+        // The sensor ignores start pulses closer together than its sampling period.
+        if (started) {
+            std::this_thread::sleep_until(lastStart + MIN_INTERVAL);
+        }
+        std::optional<Reading> reading = decode(exchange());
+        if (reading) {
+            return reading;
+        }
+    }
+    return std::nullopt;
+}
+
+DhtSensor::Stats DhtSensor::stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return counters;
+}
@@ -0,0 +1,105 @@
+#ifndef DHTSENSOR_H
+#define DHTSENSOR_H
+
+#include "EdgeEvent.h"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief DHT11 / DHT22 temperature and humidity sensor driver.
+ *
+ * The data line is requested once through the kernel GPIO character device
+ * (uAPI v2) and only its configuration changes afterwards: the start pulse is
+ * driven as an open-drain output, then a single reconfiguration turns the
+ * line into an input with both-edge detection. Releasing the line and arming
+ * the edge detector are therefore the same ioctl, which completes well before
+ * the sensor's response begins 20-40 us later. The 40-bit response is decoded
+ * purely from the kernel's edge timestamps (the width of each high pulse
+ * encodes one bit), so it does not depend on the reading thread being
+ * scheduled during the transfer.
+ *
+ * libgpiod v1 cannot change an edge-event request in place, hence the direct
+ * use of the character device; Linux 5.10 or later is required.
+ */
+class DhtSensor {
+public:
+    enum class Model { DHT11, DHT22 };
+
+    struct Reading {
+        double temperature;     ///< Degrees Celsius
+        double humidity;        ///< Percent relative humidity
+    };
+
+    struct Stats {
+        unsigned long attempts = 0;
+        unsigned long successes = 0;
+        unsigned long checksumErrors = 0;
+        unsigned long incomplete = 0;   ///< Fewer than 40 bits captured
+    };
+
+    /**
+     * @brief Constructs a driver and requests the data line as an input.
+     * @param pin GPIO line offset of the data line (external pull-up required).
+     * @param model Sensor type; selects start pulse length and data format.
+     * @param chipName GPIO chip holding the line.
+     * @throws std::runtime_error if the chip or line cannot be requested.
+     */
+    DhtSensor(int pin, Model model = Model::DHT22, const std::string& chipName = "gpiochip0");
+
+    /**
+     * @brief Releases the line.
+     */
+    ~DhtSensor();
+
+    DhtSensor(const DhtSensor&) = delete;
+    DhtSensor& operator=(const DhtSensor&) = delete;
+
+    /**
+     * @brief Performs a full measurement with retries.
+     * @param retries Additional attempts after a failed one.
+     * @return The reading, or nothing if every attempt failed.
+     * @throws std::runtime_error if the line cannot be reconfigured or read.
+     */
+    std::optional<Reading> read(int retries = 2);
+
+    /**
+     * @brief Decodes a response from its edges and updates the statistics.
+     */
+    std::optional<Reading> decode(const std::vector<EdgeEvent>& edges);
+
+    Stats stats() const;
+
+    /**
+     * @brief Extracts the 5 data bytes from response edges.
+     * @return false if fewer than 40 bits were found.
+     */
+    static bool decodeBytes(const std::vector<EdgeEvent>& edges, uint8_t bytes[5]);
+
+    /**
+     * @brief Converts the 5 data bytes to a reading.
+     * @return Nothing if the checksum does not match.
+     */
+    static std::optional<Reading> convert(const uint8_t bytes[5], Model model);
+
+private:
+    /**
+     * @brief Drives the start pulse, then captures the response edges.
+     */
+    std::vector<EdgeEvent> exchange();
+    void configure(uint64_t flags, bool low);
+
+    int chipFd;
+    int lineFd;
+    Model model;
+    mutable std::mutex mtx;
+    Stats counters;
+    std::chrono::steady_clock::time_point lastStart;
+    bool started;
+};
+
+#endif // DHTSENSOR_H
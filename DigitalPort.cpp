@@ -0,0 +1,119 @@
+#include "DigitalPort.h"
+
+#include <stdexcept>
+
+DigitalPort::DigitalPort(const std::vector<unsigned int>& pins, DigitalPin::Direction direction,
+                         const std::string& consumer, const std::string& chipName, uint64_t initialValue)
+    : chip(nullptr),
+      lines(),
+      pins(pins),
+      consumer(consumer),
+      direction(direction),
+      values(pins.size(), 0),
+      shadow(0) {
+    if (pins.empty() || pins.size() > 64 || pins.size() > GPIOD_LINE_BULK_MAX_LINES) {
+        throw std::invalid_argument("DigitalPort needs between 1 and 64 pins");
+    }
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = (initialValue >> i) & 0x1;
+    }
+    shadow = pins.size() == 64 ? initialValue : initialValue & ((uint64_t(1) << pins.size()) - 1);
+
+    chip = gpiod_chip_open_by_name(chipName.c_str());
+    if (!chip) {
+        throw std::runtime_error("Failed to open GPIO chip " + chipName);
+    }
+
+    if (gpiod_chip_get_lines(chip, this->pins.data(), static_cast<unsigned int>(this->pins.size()), &lines) < 0) {
+        gpiod_chip_close(chip);
+        throw std::runtime_error("Failed to get GPIO lines for DigitalPort");
+    }
+
+    if (requestLines() < 0) {
+        gpiod_chip_close(chip);
+        throw std::runtime_error("Failed to request GPIO lines for DigitalPort");
+    }
+}
+
+DigitalPort::~DigitalPort() {
+    gpiod_line_release_bulk(&lines);
+    gpiod_chip_close(chip);
+}
+
+int DigitalPort::requestLines() {
+    return direction == DigitalPin::Direction::Output
+               ? gpiod_line_request_bulk_output(&lines, consumer.c_str(), values.data())
+               : gpiod_line_request_bulk_input(&lines, consumer.c_str());
+}
+
+void DigitalPort::setDirection(DigitalPin::Direction newDirection) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (newDirection == direction) {
+        return;
+    }
+    // The request stays held; only the line configuration changes.
+    int rc;
+    if (newDirection == DigitalPin::Direction::Output) {
+        rc = gpiod_line_set_direction_output_bulk(&lines, values.data());
+    } else {
+        rc = gpiod_line_set_direction_input_bulk(&lines);
+    }
+    if (rc < 0) {
+        throw std::runtime_error("Failed to change DigitalPort direction");
+    }
+    direction = newDirection;
+}
+
+void DigitalPort::writeUnlocked(uint64_t value) {
+    if (direction != DigitalPin::Direction::Output) {
+        throw std::runtime_error("Cannot write to an input DigitalPort");
+    }
+    // values mirrors shadow, so only the lines that change need touching.
+    const uint64_t lineMask = pins.size() == 64 ? ~uint64_t(0) : (uint64_t(1) << pins.size()) - 1;
+    const uint64_t changed = (value ^ shadow) & lineMask;
+    auto flip = [this, changed]() {
+        for (uint64_t bits = changed; bits != 0; bits &= bits - 1) {
+            values[static_cast<std::size_t>(__builtin_ctzll(bits))] ^= 1;
+        }
+    };
+    flip();
+    if (gpiod_line_set_value_bulk(&lines, values.data()) < 0) {
+        flip();
+        throw std::runtime_error("Failed to write DigitalPort");
+    }
+    shadow = value;
+}
+
+void DigitalPort::write(uint64_t value) {
+    std::lock_guard<std::mutex> lock(mtx);
+    writeUnlocked(value);
+}
+
+void DigitalPort::writeMasked(uint64_t mask, uint64_t value) {
+    std::lock_guard<std::mutex> lock(mtx);
+    writeUnlocked((shadow & ~mask) | (value & mask));
+}
+
+uint64_t DigitalPort::read() {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<int> levels(pins.size(), 0);
+    if (gpiod_line_get_value_bulk(&lines, levels.data()) < 0) {
+        throw std::runtime_error("Failed to read DigitalPort");
+    }
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        if (levels[i]) {
+            value |= uint64_t(1) << i;
+        }
+    }
+    return value;
+}
+
+std::size_t DigitalPort::width() const {
+    return pins.size();
+}
+
+uint64_t DigitalPort::lastWritten() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return shadow;
+}
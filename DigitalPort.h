@@ -0,0 +1,102 @@
+#ifndef DIGITALPORT_H
+#define DIGITALPORT_H
+
+#include "DigitalPin.h"
+
+#include <gpiod.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A group of GPIO lines on one chip read and written as a single word.
+ *
+ * Bit i of every value corresponds to pins[i]. All lines are requested as
+ * one libgpiod bulk request, so a write or read is a single kernel call no
+ * matter how many lines change.
+ */
+class DigitalPort {
+public:
+    /**
+     * @brief Constructs a DigitalPort.
+     * @param pins GPIO line offsets, least significant bit first (at most 64).
+     * @param direction Direction for every line in the port.
+     * @param consumer Consumer name used when requesting the lines.
+     * @param chipName GPIO chip holding all the lines.
+     * @param initialValue Levels an output port is requested with (bit i drives pins[i]),
+     *        so no line passes through a wrong level first.
+     * @throws std::invalid_argument if the pin list is empty or too long.
+     * @throws std::runtime_error if the chip or lines cannot be requested.
+     */
+    DigitalPort(const std::vector<unsigned int>& pins, DigitalPin::Direction direction,
+                const std::string& consumer = "DigitalPort", const std::string& chipName = "gpiochip0",
+                uint64_t initialValue = 0);
+
+    /**
+     * @brief Releases the lines and closes the chip.
+     */
+    ~DigitalPort();
+
+    DigitalPort(const DigitalPort&) = delete;
+    DigitalPort& operator=(const DigitalPort&) = delete;
+
+    /**
+     * @brief Sets every line of an output port in one call.
+     * @param value Bit i drives pins[i].
+     * @throws std::runtime_error if the port is an input or the write fails.
+     */
+    void write(uint64_t value);
+
+    /**
+     * @brief Changes only the lines selected by a mask.
+     * @param mask Bits to update.
+     * @param value New levels for the masked bits.
+     * @throws std::runtime_error if the port is an input or the write fails.
+     */
+    void writeMasked(uint64_t mask, uint64_t value);
+
+    /**
+     * @brief Reads every line in one call.
+     * @return Bit i holds the level of pins[i].
+     * @throws std::runtime_error if the read fails.
+     */
+    uint64_t read();
+
+    /**
+     * @brief Switches every line between input and output in place.
+     *
+     * The lines stay requested throughout, so no other consumer can take
+     * them. Outputs resume at the last written value. Does nothing if the
+     * port already has the requested direction.
+     * @throws std::runtime_error if the direction cannot be changed; the port keeps its old direction.
+     */
+    void setDirection(DigitalPin::Direction newDirection);
+
+    /**
+     * @brief Returns the number of lines in the port.
+     */
+    std::size_t width() const;
+
+    /**
+     * @brief Returns the last value written to an output port.
+     */
+    uint64_t lastWritten() const;
+
+private:
+    void writeUnlocked(uint64_t value);
+    int requestLines();
+
+    mutable std::mutex mtx;
+    gpiod_chip* chip;
+    gpiod_line_bulk lines;
+    std::vector<unsigned int> pins;
+    std::string consumer;
+    DigitalPin::Direction direction;
+    std::vector<int> values;            ///< Bit i of shadow, one int per line as libgpiod takes them
+    uint64_t shadow;
+};
+
+#endif // DIGITALPORT_H
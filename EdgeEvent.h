@@ -0,0 +1,18 @@
+#ifndef EDGEEVENT_H
+#define EDGEEVENT_H
+
+#include <chrono>
+
+/**
+ * @brief A timestamped level change on an input line.
+ *
+ * Timestamps are monotonic nanoseconds, as reported by GPIO edge events, so
+ * recorded or kernel-captured edges can be fed to decoders unchanged.
+ * EdgeSource produces them from live lines.
+ */
+struct EdgeEvent {
+    bool rising;                        ///< true for a low-to-high transition
+    std::chrono::nanoseconds timestamp; ///< Monotonic time of the transition
+};
+
+#endif // EDGEEVENT_H
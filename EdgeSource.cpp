@@ -0,0 +1,122 @@
+#include "EdgeSource.h"
+
+#include <stdexcept>
+
+namespace {
+// Events read per line per system call.
+constexpr unsigned int READ_BATCH = 16;
+} // namespace
+
+EdgeSource::EdgeSource(const std::vector<unsigned int>& pins, const std::string& consumer,
+                       const std::string& chipName)
+    : chip(nullptr), lines(), pins(pins), buffer(READ_BATCH) {
+    if (pins.empty() || pins.size() > 64 || pins.size() > GPIOD_LINE_BULK_MAX_LINES) {
+        throw std::invalid_argument("EdgeSource needs between 1 and 64 pins");
+    }
+
+    chip = gpiod_chip_open_by_name(chipName.c_str());
+    if (!chip) {
+        throw std::runtime_error("Failed to open GPIO chip " + chipName);
+    }
+
+    if (gpiod_chip_get_lines(chip, this->pins.data(), static_cast<unsigned int>(this->pins.size()), &lines) < 0) {
+        gpiod_chip_close(chip);
+        throw std::runtime_error("Failed to get GPIO lines for EdgeSource");
+    }
+
+    if (gpiod_line_request_bulk_both_edges_events(&lines, consumer.c_str()) < 0) {
+        gpiod_chip_close(chip);
+        throw std::runtime_error("Failed to request edge events for EdgeSource");
+    }
+}
+
+EdgeSource::~EdgeSource() {
+    gpiod_line_release_bulk(&lines);
+    gpiod_chip_close(chip);
+}
+
+std::size_t EdgeSource::drain(gpiod_line* line, std::vector<LineEdge>& edges) {
+    std::size_t index = 0;
+    const unsigned int offset = gpiod_line_offset(line);
+    while (index < pins.size() && pins[index] != offset) {
+        ++index;
+    }
+
+    const int count = gpiod_line_event_read_multiple(line, buffer.data(), READ_BATCH);
+    if (count < 0) {
+        throw std::runtime_error("Failed to read GPIO edge events");
+    }
+    for (int i = 0; i < count; ++i) {
+        const gpiod_line_event& raw = buffer[static_cast<std::size_t>(i)];
+        const auto timestamp = std::chrono::seconds(raw.ts.tv_sec) + std::chrono::nanoseconds(raw.ts.tv_nsec);
+        edges.push_back({index, {raw.event_type == GPIOD_LINE_EVENT_RISING_EDGE,
+                                 std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp)}});
+    }
+    return static_cast<std::size_t>(count);
+}
+
+std::size_t EdgeSource::wait(std::chrono::nanoseconds timeout, std::vector<LineEdge>& edges) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (timeout.count() < 0) {
+        timeout = std::chrono::nanoseconds(0);
+    }
+    const timespec limit{static_cast<time_t>(timeout.count() / 1000000000),
+                         static_cast<long>(timeout.count() % 1000000000)};
+
+    const timespec poll{0, 0};
+
+    std::size_t total = 0;
+    gpiod_line_bulk ready;
+    // Keep draining without blocking while a line fills a whole read batch,
+    // so a burst is not split across calls.
+    while (true) {
+        const int rc = gpiod_line_event_wait_bulk(&lines, total == 0 ? &limit : &poll, &ready);
+        if (rc < 0) {
+            throw std::runtime_error("Failed to wait for GPIO edge events");
+        }
+        if (rc == 0) {
+            return total;
+        }
+        bool more = false;
+        for (unsigned int i = 0; i < ready.num_lines; ++i) {
+            const std::size_t read = drain(ready.lines[i], edges);
+            total += read;
+            more = more || read == READ_BATCH;
+        }
+        if (!more) {
+            return total;
+        }
+    }
+}
+
+std::vector<EdgeSource::LineEdge> EdgeSource::capture(std::chrono::nanoseconds window) {
+    std::vector<LineEdge> edges;
+    const auto end = std::chrono::steady_clock::now() + window;
+    while (true) {
+        const auto remaining = end - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::nanoseconds(0)) {
+            wait(std::chrono::nanoseconds(0), edges);
+            return edges;
+        }
+        wait(std::chrono::duration_cast<std::chrono::nanoseconds>(remaining), edges);
+    }
+}
+
+uint64_t EdgeSource::read() {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<int> levels(pins.size(), 0);
+    if (gpiod_line_get_value_bulk(&lines, levels.data()) < 0) {
+        throw std::runtime_error("Failed to read EdgeSource lines");
+    }
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        if (levels[i]) {
+            value |= uint64_t(1) << i;
+        }
+    }
+    return value;
+}
+
+std::size_t EdgeSource::width() const {
+    return pins.size();
+}
@@ -0,0 +1,95 @@
+#ifndef EDGESOURCE_H
+#define EDGESOURCE_H
+
+#include "EdgeEvent.h"
+
+#include <gpiod.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Kernel-timestamped edge events from a group of GPIO lines on one chip.
+ *
+ * All lines are requested for both-edge events in one libgpiod bulk request.
+ * wait() blocks until at least one line has events (or the timeout passes)
+ * and drains every queued event, so one reactor thread can feed any number
+ * of the EdgeEvent decoders from a single source.
+ *
+ * Timestamps come from the kernel's interrupt handler and are CLOCK_MONOTONIC
+ * on Linux 5.7 and later, matching PreciseTimer::Clock and the EdgeEvent
+ * convention.
+ */
+class EdgeSource {
+public:
+    /**
+     * @brief An edge together with the index of the line it occurred on.
+     */
+    struct LineEdge {
+        std::size_t line;               ///< Index into the pin list
+        EdgeEvent event;
+    };
+
+    /**
+     * @brief Constructs an EdgeSource.
+     * @param pins GPIO line offsets (at most 64).
+     * @param consumer Consumer name used when requesting the lines.
+     * @param chipName GPIO chip holding all the lines.
+     * @throws std::invalid_argument if the pin list is empty or too long.
+     * @throws std::runtime_error if the chip or lines cannot be requested.
+     */
+    EdgeSource(const std::vector<unsigned int>& pins, const std::string& consumer = "EdgeSource",
+               const std::string& chipName = "gpiochip0");
+
+    /**
+     * @brief Releases the lines and closes the chip.
+     */
+    ~EdgeSource();
+
+    EdgeSource(const EdgeSource&) = delete;
+    EdgeSource& operator=(const EdgeSource&) = delete;
+
+    /**
+     * @brief Waits for edges and appends every pending one.
+     * @param timeout Longest time to block; zero only drains what is queued.
+     * @param edges Receives the edges, in time order per line.
+     * @return Number of edges appended; 0 if the timeout passed first.
+     * @throws std::runtime_error if waiting or reading fails.
+     */
+    std::size_t wait(std::chrono::nanoseconds timeout, std::vector<LineEdge>& edges);
+
+    /**
+     * @brief Collects every edge that occurs within a time window.
+     * @param window Length of the window, measured from the call.
+     * @return The edges, in time order per line.
+     * @throws std::runtime_error if waiting or reading fails.
+     */
+    std::vector<LineEdge> capture(std::chrono::nanoseconds window);
+
+    /**
+     * @brief Reads the current level of every line.
+     * @return Bit i holds the level of pins[i].
+     * @throws std::runtime_error if the read fails.
+     */
+    uint64_t read();
+
+    /**
+     * @brief Returns the number of lines in the source.
+     */
+    std::size_t width() const;
+
+private:
+    std::size_t drain(gpiod_line* line, std::vector<LineEdge>& edges);
+
+    std::mutex mtx;
+    gpiod_chip* chip;
+    gpiod_line_bulk lines;
+    std::vector<unsigned int> pins;
+    std::vector<gpiod_line_event> buffer;
+};
+
+#endif // EDGESOURCE_H
@@ -0,0 +1,187 @@
+#include "Hd44780.h"
+
+#include <stdexcept>
+#include <thread>
+
+using std::chrono::microseconds;
+
+namespace {
+constexpr uint8_t CMD_CLEAR = 0x01;
+constexpr uint8_t CMD_ENTRY_MODE = 0x06;       // Increment, no shift
+constexpr uint8_t CMD_DISPLAY_ON = 0x0C;       // Display on, cursor off
+constexpr uint8_t CMD_FUNCTION_SET = 0x20;
+constexpr uint8_t FLAG_8BIT = 0x10;
+constexpr uint8_t FLAG_2LINE = 0x08;
+constexpr uint8_t CMD_SET_DDRAM = 0x80;
+
+constexpr microseconds COMMAND_DELAY(40);
+constexpr microseconds CLEAR_DELAY(1600);
+constexpr std::chrono::nanoseconds ENABLE_PULSE(500);
+constexpr std::chrono::milliseconds BUSY_TIMEOUT(10);
+} // namespace
+
+Hd44780::Hd44780(DigitalPort& dataBus, int rsPin, int enablePin, int rwPin, std::size_t columns, std::size_t rows)
+    : bus(dataBus),
+      rs(rsPin, DigitalPin::Direction::Output, "HD44780-RS"),
+      enable(enablePin, DigitalPin::Direction::Output, "HD44780-E"),
+      fourBit(dataBus.width() == 4),
+      columns(columns),
+      rows(rows),
+      framebuffer(columns * rows, ' '),
+      shadow(columns * rows, ' '),
+      shadowValid(columns * rows, false),
+      lastDuration(0) {
+    if (dataBus.width() != 4 && dataBus.width() != 8) {
+        throw std::invalid_argument("HD44780 data bus must be 4 or 8 lines");
+    }
+    if (columns == 0 || columns > 40 || rows == 0 || rows > 4) {
+        throw std::invalid_argument("Unsupported HD44780 geometry");
+    }
+    if (rwPin >= 0) {
+        rw = std::make_unique<DigitalPin>(rwPin, DigitalPin::Direction::Output, "HD44780-RW");
+        rw->write(false);
+    }
+    rs.write(false);
+    enable.write(false);
+
+    // Initialisation by instruction (datasheet figures 23/24); the busy flag
+    // cannot be checked until the interface width is set.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const uint8_t wake = fourBit ? 0x03 : 0x30;
+    writeBus(wake);
+    pulseEnable();
+    timer.sleepFor(microseconds(4100));
+    pulseEnable();
+    timer.sleepFor(microseconds(100));
+    pulseEnable();
+    timer.sleepFor(COMMAND_DELAY);
+    if (fourBit) {
+        writeBus(0x02);
+        pulseEnable();
+        timer.sleepFor(COMMAND_DELAY);
+    }
+
+    uint8_t function = CMD_FUNCTION_SET | (fourBit ? 0 : FLAG_8BIT) | (rows > 1 ? FLAG_2LINE : 0);
+    send(function, false);
+    send(CMD_DISPLAY_ON, false);
+    send(CMD_CLEAR, false);
+    waitReady(CLEAR_DELAY);
+    send(CMD_ENTRY_MODE, false);
+    shadowValid.assign(shadowValid.size(), true);
+}
+
+void Hd44780::pulseEnable() {
+    enable.write(true);
+    timer.sleepFor(ENABLE_PULSE);
+    enable.write(false);
+}
+
+void Hd44780::writeBus(uint8_t value) {
+    bus.write(value);
+}
+
+void Hd44780::writeNibble(uint8_t nibble) {
+    writeBus(nibble & 0x0F);
+    pulseEnable();
+}
+
+void Hd44780::waitReady(microseconds fallback) {
+    if (!rw) {
+        timer.sleepFor(fallback);
+        return;
+    }
+
+    // Poll the busy flag (D7) with the bus turned around to input.
+    rs.write(false);
+    rw->write(true);
+    bus.setDirection(DigitalPin::Direction::Input);
+    const uint64_t busyBit = fourBit ? 0x08 : 0x80;
+    const auto deadline = PreciseTimer::Clock::now() + BUSY_TIMEOUT;
+    bool busy = true;
+    while (busy && PreciseTimer::Clock::now() < deadline) {
+        enable.write(true);
+        timer.sleepFor(ENABLE_PULSE);
+        busy = (bus.read() & busyBit) != 0;
+        enable.write(false);
+        if (fourBit) {
+            // Clock out the address-counter nibble to complete the read.
+            pulseEnable();
+        }
+    }
+    bus.setDirection(DigitalPin::Direction::Output);
+    rw->write(false);
+    if (busy) {
+        throw std::runtime_error("HD44780 busy flag timeout");
+    }
+}
+
+void Hd44780::send(uint8_t value, bool data) {
+    rs.write(data);
+    if (fourBit) {
+        writeNibble(value >> 4);
+        writeNibble(value);
+    } else {
+        writeBus(value);
+        pulseEnable();
+    }
+    waitReady(COMMAND_DELAY);
+}
+
+uint8_t Hd44780::rowOffset(std::size_t row) const {
+    static const uint8_t base[4] = {0x00, 0x40, 0x00, 0x40};
+    return static_cast<uint8_t>(base[row] + (row >= 2 ? columns : 0));
+}
+
+void Hd44780::print(std::size_t row, std::size_t column, const std::string& text) {
+    if (row >= rows) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    for (std::size_t i = 0; i < text.size() && column + i < columns; ++i) {
+        framebuffer[row * columns + column + i] = text[i];
+    }
+}
+
+void Hd44780::clear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    framebuffer.assign(framebuffer.size(), ' ');
+}
+
+void Hd44780::invalidate() {
+    std::lock_guard<std::mutex> lock(mtx);
+    shadowValid.assign(shadowValid.size(), false);
+}
+
+std::size_t Hd44780::update() {
+    std::lock_guard<std::mutex> lock(mtx);
+    const auto start = PreciseTimer::Clock::now();
+    std::size_t written = 0;
+
+    for (std::size_t row = 0; row < rows; ++row) {
+        bool cursorValid = false;
+        for (std::size_t column = 0; column < columns; ++column) {
+            const std::size_t i = row * columns + column;
+            if (shadowValid[i] && shadow[i] == framebuffer[i]) {
+                // The display's cursor moves past unchanged cells only if we write them.
+                cursorValid = false;
+                continue;
+            }
+            if (!cursorValid) {
+                send(static_cast<uint8_t>(CMD_SET_DDRAM | (rowOffset(row) + column)), false);
+                cursorValid = true;
+            }
+            send(static_cast<uint8_t>(framebuffer[i]), true);
+            shadow[i] = framebuffer[i];
+            shadowValid[i] = true;
+            ++written;
+        }
+    }
+
+    lastDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(PreciseTimer::Clock::now() - start);
+    return written;
+}
+
+std::chrono::nanoseconds Hd44780::lastUpdateDuration() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return lastDuration;
+}
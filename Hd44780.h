@@ -0,0 +1,91 @@
+#ifndef HD44780_H
+#define HD44780_H
+
+#include "DigitalPin.h"
+#include "DigitalPort.h"
+#include "PreciseTimer.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief HD44780 character LCD driver with shadow-framebuffer diffing.
+ *
+ * The data bus is a DigitalPort of 4 (D4-D7) or 8 (D0-D7) lines, so each
+ * nibble or byte is one bulk write. When an RW pin is given, the driver polls
+ * the busy flag instead of waiting worst-case delays. Text is drawn into a
+ * framebuffer; update() compares it with a shadow of what the display holds
+ * and only rewrites changed characters, setting the cursor once per run of
+ * consecutive changes and relying on auto-increment within a run.
+ */
+class Hd44780 {
+public:
+    /**
+     * @brief Constructs and initialises the display.
+     * @param dataBus Output port for D4-D7 (4 lines) or D0-D7 (8 lines).
+     * @param rsPin GPIO pin for RS.
+     * @param enablePin GPIO pin for E.
+     * @param rwPin GPIO pin for RW, or -1 if RW is tied low (fixed delays are used).
+     * @param columns Characters per row.
+     * @param rows Number of rows (1-4).
+     * @throws std::invalid_argument if the bus width or geometry is unsupported.
+     */
+    Hd44780(DigitalPort& dataBus, int rsPin, int enablePin, int rwPin = -1, std::size_t columns = 16,
+            std::size_t rows = 2);
+
+    /**
+     * @brief Writes text into the framebuffer at a position (clipped to the row).
+     */
+    void print(std::size_t row, std::size_t column, const std::string& text);
+
+    /**
+     * @brief Fills the framebuffer with spaces.
+     */
+    void clear();
+
+    /**
+     * @brief Sends every framebuffer character that differs from the display.
+     * @return Number of characters written.
+     */
+    std::size_t update();
+
+    /**
+     * @brief Marks the whole display stale so the next update() rewrites everything.
+     */
+    void invalidate();
+
+    /**
+     * @brief Returns how long the last update() took.
+     */
+    std::chrono::nanoseconds lastUpdateDuration() const;
+
+private:
+    void pulseEnable();
+    void writeBus(uint8_t value);
+    void send(uint8_t value, bool data);
+    void writeNibble(uint8_t nibble);
+    void waitReady(std::chrono::microseconds fallback);
+    uint8_t rowOffset(std::size_t row) const;
+
+    DigitalPort& bus;
+    DigitalPin rs;
+    DigitalPin enable;
+    std::unique_ptr<DigitalPin> rw;
+    bool fourBit;
+    std::size_t columns;
+    std::size_t rows;
+    PreciseTimer timer;
+
+    mutable std::mutex mtx;
+    std::vector<char> framebuffer;
+    std::vector<char> shadow;
+    std::vector<bool> shadowValid;
+    std::chrono::nanoseconds lastDuration;
+};
+
+#endif // HD44780_H
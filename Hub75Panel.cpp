@@ -0,0 +1,206 @@
+#include "Hub75Panel.h"
+
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+inline uint8_t packPixel(const uint8_t* r, const uint8_t* g, const uint8_t* b, std::size_t top, std::size_t bottom,
+                         unsigned int bit) {
+    return static_cast<uint8_t>(((r[top] >> bit) & 1) | (((g[top] >> bit) & 1) << 1) |
+                                (((b[top] >> bit) & 1) << 2) | (((r[bottom] >> bit) & 1) << 3) |
+                                (((g[bottom] >> bit) & 1) << 4) | (((b[bottom] >> bit) & 1) << 5));
+}
+} // namespace
+
+Hub75Panel::Hub75Panel(DigitalPort& port, const Hub75Config& config)
+    : port(port),
+      config(config),
+      rowPairs(config.height / 2),
+      mask(0),
+      red(config.width * config.height, 0),
+      green(config.width * config.height, 0),
+      blue(config.width * config.height, 0),
+      front(0),
+      pending(false),
+      running(true),
+      frameCount(0) {
+    if (config.width == 0 || config.height < 2 || config.height % 2 != 0 || config.planes < 1 ||
+        config.planes > 8) {
+        throw std::invalid_argument("Unsupported HUB75 panel geometry");
+    }
+    unsigned int addressLines = 0;
+    while ((std::size_t(1) << addressLines) < rowPairs) {
+        ++addressLines;
+    }
+    if (port.width() < BIT_ADDR + addressLines) {
+        throw std::invalid_argument("DigitalPort too narrow for HUB75 panel");
+    }
+    mask = (uint64_t(1) << (BIT_ADDR + addressLines)) - 1;
+
+    const std::size_t planeBytes = config.planes * rowPairs * config.width;
+    planesBuffer[0].assign(planeBytes, 0);
+    planesBuffer[1].assign(planeBytes, 0);
+    port.writeMasked(mask, uint64_t(1) << BIT_OE);
+
+    worker = PreciseTimer::startThread(config.rtPriority, [this]() { run(); },
+                                       [this](std::exception_ptr error) { workerFailed(error); });
+}
+
+Hub75Panel::~Hub75Panel() {
+    {
+        std::lock_guard<std::mutex> lock(flipMtx);
+        running = false;
+    }
+    flipped.notify_all();
+    worker.join();
+    try {
+        port.writeMasked(mask, uint64_t(1) << BIT_OE);
+    } catch (...) {
+        // Destructors must not throw.
+    }
+}
+
+void Hub75Panel::setPixel(std::size_t x, std::size_t y, uint8_t r, uint8_t g, uint8_t b) {
+    if (x >= config.width || y >= config.height) {
+        throw std::out_of_range("HUB75 pixel out of range");
+    }
+    std::lock_guard<std::mutex> lock(backMtx);
+    const std::size_t i = y * config.width + x;
+    red[i] = r;
+    green[i] = g;
+    blue[i] = b;
+}
+
+void Hub75Panel::loadFrame(const uint8_t* rgb) {
+    std::lock_guard<std::mutex> lock(backMtx);
+    for (std::size_t i = 0; i < red.size(); ++i) {
+        red[i] = rgb[3 * i];
+        green[i] = rgb[3 * i + 1];
+        blue[i] = rgb[3 * i + 2];
+    }
+}
+
+void Hub75Panel::convertBitplanes(const uint8_t* r, const uint8_t* g, const uint8_t* b, std::size_t width,
+                                  std::size_t height, unsigned int planes, uint8_t* out) {
+    const std::size_t pairs = height / 2;
+    for (unsigned int plane = 0; plane < planes; ++plane) {
+        const unsigned int bit = 8 - planes + plane;
+        for (std::size_t row = 0; row < pairs; ++row) {
+            const std::size_t top = row * width;
+            const std::size_t bottom = (row + pairs) * width;
+            uint8_t* dst = out + (plane * pairs + row) * width;
+            std::size_t x = 0;
+#if defined(__SSE2__)
+            // 16 pixels per iteration: a 16-bit shift moves bit n of every
+            // byte to bit 0 of that byte once the result is masked with 1.
+            const __m128i one = _mm_set1_epi8(1);
+            const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(bit));
+            auto extract = [&](const uint8_t* src) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                return _mm_and_si128(_mm_srl_epi16(v, shift), one);
+            };
+            for (; x + 16 <= width; x += 16) {
+                __m128i v = extract(r + top + x);
+                v = _mm_or_si128(v, _mm_slli_epi16(extract(g + top + x), 1));
+                v = _mm_or_si128(v, _mm_slli_epi16(extract(b + top + x), 2));
+                v = _mm_or_si128(v, _mm_slli_epi16(extract(r + bottom + x), 3));
+                v = _mm_or_si128(v, _mm_slli_epi16(extract(g + bottom + x), 4));
+                v = _mm_or_si128(v, _mm_slli_epi16(extract(b + bottom + x), 5));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), v);
+            }
+#endif
+            for (; x < width; ++x) {
+                dst[x] = packPixel(r, g, b, top + x, bottom + x, bit);
+            }
+        }
+    }
+}
+
+void Hub75Panel::swapBuffers() {
+    // One swap at a time: each waits for its flip, so the next cannot
+    // convert into a buffer that is about to become visible.
+    std::lock_guard<std::mutex> swapLock(swapMtx);
+    // The refresh thread only reads the front buffer, so the back buffer can
+    // be converted without stalling it.
+    const int back = 1 - front.load();
+    {
+        std::lock_guard<std::mutex> lock(backMtx);
+        convertBitplanes(red.data(), green.data(), blue.data(), config.width, config.height, config.planes,
+                         planesBuffer[back].data());
+    }
+    // Wait for the refresh thread to flip at its frame boundary; the pixels
+    // are in the bitplanes now, so drawing may go on meanwhile.
+    std::unique_lock<std::mutex> flipLock(flipMtx);
+    pending = true;
+    flipped.wait(flipLock, [this]() { return !pending || !running; });
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+void Hub75Panel::workerFailed(std::exception_ptr error) {
+    {
+        std::lock_guard<std::mutex> lock(flipMtx);
+        failure = error;
+        running = false;
+    }
+    flipped.notify_all();
+}
+
+uint64_t Hub75Panel::addressBits(std::size_t row) const {
+    return static_cast<uint64_t>(row) << BIT_ADDR;
+}
+
+void Hub75Panel::run() {
+    const uint64_t clk = uint64_t(1) << BIT_CLK;
+    const uint64_t lat = uint64_t(1) << BIT_LAT;
+    const uint64_t oe = uint64_t(1) << BIT_OE;
+
+    auto displayEnd = PreciseTimer::Clock::now();
+    uint64_t shownAddress = 0;
+    while (running) {
+        if (pending) {
+            {
+                std::lock_guard<std::mutex> lock(flipMtx);
+                front = 1 - front.load();
+                pending = false;
+            }
+            flipped.notify_all();
+        }
+        const uint8_t* planes = planesBuffer[front.load()].data();
+
+        for (std::size_t row = 0; row < rowPairs; ++row) {
+            for (unsigned int plane = 0; plane < config.planes; ++plane) {
+                // Shift the next plane in while the previous one is still lit,
+                // but blank it at its deadline if the shift runs longer, so
+                // short planes are not stretched to the shift time.
+                const uint8_t* data = planes + (plane * rowPairs + row) * config.width;
+                uint64_t blank = 0;
+                for (std::size_t x = 0; x < config.width; ++x) {
+                    if (!blank && PreciseTimer::Clock::now() >= displayEnd) {
+                        blank = oe;
+                    }
+                    port.writeMasked(mask, shownAddress | blank | data[x]);
+                    port.writeMasked(mask, shownAddress | blank | data[x] | clk);
+                }
+
+                timer.sleepUntil(displayEnd);
+                const uint64_t address = addressBits(row);
+                port.writeMasked(mask, shownAddress | oe);
+                port.writeMasked(mask, address | oe | lat);
+                port.writeMasked(mask, address | oe);
+                port.writeMasked(mask, address);
+                shownAddress = address;
+                displayEnd = PreciseTimer::Clock::now() + config.lsbTime * (1u << plane);
+            }
+        }
+        ++frameCount;
+    }
+}
+
+unsigned long Hub75Panel::frames() const {
+    return frameCount.load();
+}
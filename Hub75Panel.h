@@ -0,0 +1,126 @@
+#ifndef HUB75PANEL_H
+#define HUB75PANEL_H
+
+#include "DigitalPort.h"
+#include "PreciseTimer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Panel geometry and timing for Hub75Panel.
+ */
+struct Hub75Config {
+    std::size_t width = 64;
+    std::size_t height = 32;                        ///< Rows; scanned as height/2 row pairs
+    unsigned int planes = 8;                        ///< Colour depth per channel (1-8)
+    std::chrono::nanoseconds lsbTime{1000};         ///< Display time of the least significant plane
+    int rtPriority = 0;                             ///< SCHED_FIFO priority for the refresh thread
+};
+
+/**
+ * @brief HUB75 RGB LED panel driver with binary-coded modulation.
+ *
+ * The DigitalPort must hold the HUB75 lines in this bit order:
+ * R1 G1 B1 R2 G2 B2 CLK LAT OE A B C D E (as many address lines as the
+ * panel needs). Frames are drawn into a planar back buffer and converted to
+ * bitplanes (SSE2 on x86, scalar elsewhere); swapBuffers() hands the result
+ * to the refresh thread at the next frame boundary, so a frame is never shown
+ * half-updated. Plane n of each row is lit for lsbTime * 2^n while the next
+ * plane is shifted in; when the shift takes longer than that, the panel is
+ * blanked at the deadline for the rest of the shift, so the on-time of each
+ * plane stays binary-weighted.
+ */
+class Hub75Panel {
+public:
+    static constexpr unsigned int BIT_CLK = 6;
+    static constexpr unsigned int BIT_LAT = 7;
+    static constexpr unsigned int BIT_OE = 8;
+    static constexpr unsigned int BIT_ADDR = 9;
+
+    /**
+     * @brief Constructs the driver and starts refreshing a black frame.
+     * @throws std::invalid_argument if the geometry or port width is unsupported.
+     */
+    Hub75Panel(DigitalPort& port, const Hub75Config& config = Hub75Config());
+
+    /**
+     * @brief Stops refreshing and blanks the panel.
+     */
+    ~Hub75Panel();
+
+    Hub75Panel(const Hub75Panel&) = delete;
+    Hub75Panel& operator=(const Hub75Panel&) = delete;
+
+    /**
+     * @brief Sets one pixel in the back buffer.
+     * @throws std::out_of_range if the pixel is outside the panel.
+     */
+    void setPixel(std::size_t x, std::size_t y, uint8_t r, uint8_t g, uint8_t b);
+
+    /**
+     * @brief Copies a row-major RGB888 frame into the back buffer.
+     */
+    void loadFrame(const uint8_t* rgb);
+
+    /**
+     * @brief Converts the back buffer to bitplanes and presents it at the next frame.
+     *
+     * Blocks until the refresh thread has flipped to the new buffer; other
+     * threads can keep drawing the next frame meanwhile.
+     * @throws The exception that stopped the refresh thread, if a port write failed.
+     */
+    void swapBuffers();
+
+    /**
+     * @brief Returns the number of complete frames refreshed.
+     */
+    unsigned long frames() const;
+
+    /**
+     * @brief Converts planar channels to HUB75 bitplanes.
+     *
+     * Output byte [(plane * height / 2 + row) * width + x] holds R1 G1 B1 R2 G2 B2
+     * in bits 0-5 for row and row + height / 2, taken from bit (8 - planes + plane)
+     * of each channel.
+     */
+    static void convertBitplanes(const uint8_t* r, const uint8_t* g, const uint8_t* b, std::size_t width,
+                                 std::size_t height, unsigned int planes, uint8_t* out);
+
+private:
+    void run();
+    void workerFailed(std::exception_ptr error);
+    uint64_t addressBits(std::size_t row) const;
+
+    DigitalPort& port;
+    Hub75Config config;
+    std::size_t rowPairs;
+    uint64_t mask;
+    PreciseTimer timer;
+
+    std::mutex swapMtx;                 ///< Serialises swapBuffers(); held across the flip wait
+    std::mutex backMtx;                 ///< Guards the planar back buffer; released before the flip wait
+    std::vector<uint8_t> red;
+    std::vector<uint8_t> green;
+    std::vector<uint8_t> blue;
+
+    std::vector<uint8_t> planesBuffer[2];
+    std::mutex flipMtx;
+    std::condition_variable flipped;
+    std::atomic<int> front;
+    std::atomic<bool> pending;
+    std::atomic<bool> running;
+    std::atomic<unsigned long> frameCount;
+    std::exception_ptr failure;
+
+    std::thread worker;
+};
+
+#endif // HUB75PANEL_H
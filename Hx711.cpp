@@ -0,0 +1,130 @@
+#include "Hx711.h"
+
+namespace {
+constexpr std::chrono::nanoseconds PULSE_HIGH(1000);
+constexpr std::chrono::nanoseconds PULSE_LOW(1000);
+constexpr std::chrono::microseconds MAX_HIGH(50);
+// The edge wait returns this often only so the destructor is noticed.
+constexpr std::chrono::milliseconds IDLE_WAKE(100);
+} // namespace
+
+Hx711::Hx711(int doutPin, int sckPin, Gain gain, unsigned int sampleRate, std::size_t averageWindow, std::size_t ringCapacity,
+             int rtPriority)
+    : dout({static_cast<unsigned int>(doutPin)}, "HX711-DOUT"),
+      sck(sckPin, DigitalPin::Direction::Output, "HX711-SCK"),
+      gain(gain),
+      conversionPeriod(1000000000LL / (sampleRate ? sampleRate : 80)),
+      averageWindow(averageWindow ? averageWindow : 1),
+      ring(ringCapacity),
+      running(true),
+      failed(false),
+      lastSample(0),
+      windowSum(0),
+      sampleCount(0),
+      droppedCount(0),
+      missedCount(0),
+      longPulseCount(0) {
+    // SCK low keeps the chip powered up.
+    sck.write(false);
+
+    worker = PreciseTimer::startThread(rtPriority, [this]() { run(); },
+                                       [this](std::exception_ptr error) { workerFailed(error); });
+}
+
+Hx711::~Hx711() {
+    running = false;
+    worker.join();
+}
+
+int32_t Hx711::readConversion() {
+    const int pulses = static_cast<int>(gain);
+    uint32_t raw = 0;
+    for (int i = 0; i < pulses; ++i) {
+        const auto rise = PreciseTimer::Clock::now();
+        sck.write(true);
+        timer.sleepFor(PULSE_HIGH);
+        // Data is shifted out on the rising edge; the extra pulses only select the gain.
+        const bool bit = i < 24 ? (dout.read() & 0x1) != 0 : false;
+        sck.write(false);
+        if (PreciseTimer::Clock::now() - rise > MAX_HIGH) {
+            ++longPulseCount;
+        }
+        if (i < 24) {
+            raw = (raw << 1) | (bit ? 1u : 0u);
+        }
+        timer.sleepFor(PULSE_LOW);
+    }
+    // Sign-extend the 24-bit two's complement result.
+    if (raw & 0x800000) {
+        raw |= 0xFF000000;
+    }
+    return static_cast<int32_t>(raw);
+}
+
+void Hx711::run() {
+    while (running) {
+        // DOUT low means a conversion is waiting; a falling edge queued
+        // after this check ends the wait at once.
+        if (dout.read() & 0x1) {
+            edges.clear();
+            dout.wait(IDLE_WAKE, edges);
+            continue;
+        }
+
+        const int32_t value = readConversion();
+        // The data bits toggle DOUT; those edges are not data-ready, and a
+        // conversion finished since is caught by the level check above.
+        edges.clear();
+        dout.wait(std::chrono::nanoseconds(0), edges);
+        const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            PreciseTimer::Clock::now().time_since_epoch());
+
+        // A gap of more than one and a half periods means conversions were
+        // overwritten before they could be read.
+        if (lastSample.count() > 0 && now - lastSample > conversionPeriod * 3 / 2) {
+            missedCount += static_cast<unsigned long>((now - lastSample + conversionPeriod / 2) / conversionPeriod) - 1;
+        }
+        lastSample = now;
+
+        window.push_back(value);
+        windowSum += value;
+        if (window.size() > averageWindow) {
+            windowSum -= window.front();
+            window.pop_front();
+        }
+        const int32_t filtered = static_cast<int32_t>(windowSum / static_cast<int64_t>(window.size()));
+
+        if (ring.push({filtered, now})) {
+            ++sampleCount;
+        } else {
+            ++droppedCount;
+        }
+    }
+}
+
+bool Hx711::pop(Sample& sample) {
+    if (ring.pop(sample)) {
+        return true;
+    }
+    if (failed) {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::rethrow_exception(failure);
+    }
+    return false;
+}
+
+void Hx711::workerFailed(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mtx);
+    failure = error;
+    failed = true;
+    running = false;
+}
+
+Hx711::Stats Hx711::stats() const {
+    Stats stats;
+    stats.samples = sampleCount.load();
+    stats.dropped = droppedCount.load();
+    stats.missed = missedCount.load();
+    stats.longPulses = longPulseCount.load();
+    return stats;
+}
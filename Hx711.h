@@ -0,0 +1,108 @@
+#ifndef HX711_H
+#define HX711_H
+
+#include "DigitalPin.h"
+#include "EdgeSource.h"
+#include "PreciseTimer.h"
+#include "SpscRing.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief HX711 load-cell ADC reader with continuous sampling.
+ *
+ * DOUT is requested once for edge events, and a dedicated thread blocks on
+ * them until DOUT falls (data ready). It then clocks the 24 data bits plus
+ * gain-select pulses with PreciseTimer-controlled pulse widths well under
+ * the 60 us that would put the chip into power-down. The data bits toggle
+ * DOUT as well; those edges are drained after each read, so only the next
+ * data-ready edge wakes the thread. Conversions are pushed into a lock-free
+ * ring, optionally through a moving average.
+ */
+class Hx711 {
+public:
+    enum class Gain { A128 = 25, B32 = 26, A64 = 27 };   ///< Value = pulses per conversion
+
+    struct Sample {
+        int32_t value;
+        std::chrono::nanoseconds timestamp;     ///< Monotonic time the conversion was read
+    };
+
+    struct Stats {
+        unsigned long samples = 0;
+        unsigned long dropped = 0;              ///< Ring full, sample discarded
+        unsigned long missed = 0;               ///< Conversions skipped between reads
+        unsigned long longPulses = 0;           ///< SCK high time exceeded 50 us
+    };
+
+    /**
+     * @brief Constructs the reader and starts sampling.
+     * @param doutPin GPIO pin for DOUT.
+     * @param sckPin GPIO pin for PD_SCK.
+     * @param gain Channel and gain for the following conversions.
+     * @param sampleRate Chip output rate set by its RATE pin (10 or 80 SPS).
+     * @param averageWindow Moving-average length (1 = raw samples).
+     * @param ringCapacity Samples buffered for the consumer.
+     * @param rtPriority SCHED_FIFO priority for the sampling thread, or 0 to leave it unchanged.
+     * @throws std::runtime_error if the lines cannot be requested.
+     */
+    Hx711(int doutPin, int sckPin, Gain gain = Gain::A128, unsigned int sampleRate = 80, std::size_t averageWindow = 1,
+          std::size_t ringCapacity = 256, int rtPriority = 0);
+
+    /**
+     * @brief Stops sampling.
+     */
+    ~Hx711();
+
+    Hx711(const Hx711&) = delete;
+    Hx711& operator=(const Hx711&) = delete;
+
+    /**
+     * @brief Pops the oldest buffered sample (single consumer thread).
+     * @return false if no sample is available.
+     * @throws The exception that stopped the sampling thread, once the buffered samples are drained.
+     */
+    bool pop(Sample& sample);
+
+    Stats stats() const;
+
+private:
+    void run();
+    void workerFailed(std::exception_ptr error);
+    int32_t readConversion();
+
+    EdgeSource dout;
+    DigitalPin sck;
+    Gain gain;
+    std::chrono::nanoseconds conversionPeriod;
+    std::size_t averageWindow;
+    PreciseTimer timer;
+    SpscRing<Sample> ring;
+    std::vector<EdgeSource::LineEdge> edges;
+
+    std::mutex mtx;
+    std::atomic<bool> running;
+    std::atomic<bool> failed;
+    std::exception_ptr failure;
+
+    std::chrono::nanoseconds lastSample;
+    std::deque<int32_t> window;
+    int64_t windowSum;
+
+    std::atomic<unsigned long> sampleCount;
+    std::atomic<unsigned long> droppedCount;
+    std::atomic<unsigned long> missedCount;
+    std::atomic<unsigned long> longPulseCount;
+
+    std::thread worker;
+};
+
+#endif // HX711_H
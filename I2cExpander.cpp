@@ -0,0 +1,265 @@
+#include "I2cExpander.h"
+
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+// MCP23017 registers with IOCON.BANK = 0 (A/B pairs are adjacent).
+constexpr uint8_t MCP_IODIRA = 0x00;
+constexpr uint8_t MCP_GPINTENA = 0x04;
+constexpr uint8_t MCP_INTCONA = 0x08;
+constexpr uint8_t MCP_IOCON = 0x0A;
+constexpr uint8_t MCP_GPPUA = 0x0C;
+constexpr uint8_t MCP_GPIOA = 0x12;
+constexpr uint8_t MCP_OLATA = 0x14;
+
+constexpr uint8_t IOCON_MIRROR = 0x40;
+
+std::string errnoMessage(const std::string& what) {
+    return what + ": " + std::strerror(errno);
+}
+
+int openBus(int bus, uint8_t address) {
+    std::string path = "/dev/i2c-" + std::to_string(bus);
+    int fd = ::open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+        throw std::runtime_error(errnoMessage("Failed to open " + path));
+    }
+    if (::ioctl(fd, I2C_SLAVE, address) < 0) {
+        ::close(fd);
+        throw std::runtime_error(errnoMessage("Failed to select I2C address"));
+    }
+    return fd;
+}
+} // namespace
+
+I2cExpanderPin::I2cExpanderPin(I2cExpander& expander, std::size_t bit) : expander(expander), bit(bit) {}
+
+void I2cExpanderPin::write(bool value) {
+    expander.write(bit, value);
+}
+
+bool I2cExpanderPin::read() {
+    return expander.read(bit);
+}
+
+I2cExpander::I2cExpander(int bus, uint8_t address, Chip chip, bool interruptDriven)
+    : I2cExpander(openBus(bus, address), chip, interruptDriven) {}
+
+I2cExpander::I2cExpander(int fd, Chip chip, bool interruptDriven)
+    : fd(fd),
+      chip(chip),
+      interruptDriven(interruptDriven),
+      output(0),
+      outputWritten(0),
+      direction(0xFFFF),
+      pullUp(0),
+      inputCache(0),
+      cacheValid(false),
+      cacheGeneration(0),
+      interruptGeneration(0),
+      transactionCount(0) {
+    try {
+        if (chip == Chip::MCP23017) {
+            // Mirror INTA/INTB so a single INT line covers all 16 inputs.
+            uint8_t iocon = IOCON_MIRROR;
+            writeRegisters(MCP_IOCON, &iocon, 1);
+            writeWord(MCP_OLATA, output);
+            writeWord(MCP_IODIRA, direction);
+            writeWord(MCP_GPPUA, pullUp);
+            if (interruptDriven) {
+                writeWord(MCP_INTCONA, 0x0000);
+                writeWord(MCP_GPINTENA, 0xFFFF);
+            }
+        } else {
+            // PCF8574 lines read as inputs only while written high.
+            output = 0x00FF;
+            uint8_t value = static_cast<uint8_t>(output);
+            writeRaw(&value, 1);
+        }
+        outputWritten = output;
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+}
+
+I2cExpander::~I2cExpander() {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+std::size_t I2cExpander::width() const {
+    return chip == Chip::MCP23017 ? 16 : 8;
+}
+
+void I2cExpander::checkBit(std::size_t bit) const {
+    if (bit >= width()) {
+        throw std::out_of_range("I2C expander line out of range");
+    }
+}
+
+void I2cExpander::writeRaw(const uint8_t* data, std::size_t length) {
+    ++transactionCount;
+    if (::write(fd, data, length) != static_cast<ssize_t>(length)) {
+        throw std::runtime_error(errnoMessage("I2C expander write failed"));
+    }
+}
+
+void I2cExpander::readRaw(uint8_t* data, std::size_t length) {
+    ++transactionCount;
+    if (::read(fd, data, length) != static_cast<ssize_t>(length)) {
+        throw std::runtime_error(errnoMessage("I2C expander read failed"));
+    }
+}
+
+void I2cExpander::writeRegisters(uint8_t reg, const uint8_t* data, std::size_t length) {
+    uint8_t buffer[3];
+    buffer[0] = reg;
+    std::memcpy(buffer + 1, data, length);
+    writeRaw(buffer, length + 1);
+}
+
+void I2cExpander::readRegisters(uint8_t reg, uint8_t* data, std::size_t length) {
+    writeRaw(&reg, 1);
+    readRaw(data, length);
+}
+
+void I2cExpander::writeWord(uint8_t regA, uint16_t value) {
+    uint8_t bytes[2] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)};
+    writeRegisters(regA, bytes, 2);
+}
+
+void I2cExpander::setDirection(std::size_t bit, DigitalPin::Direction dir) {
+    checkBit(bit);
+    std::lock_guard<std::mutex> lock(mtx);
+    const uint16_t mask = static_cast<uint16_t>(1u << bit);
+    if (chip == Chip::PCF8574) {
+        // Quasi-bidirectional: a line becomes an input by writing it high.
+        if (dir == DigitalPin::Direction::Input && !(output & mask)) {
+            output |= mask;
+            uint8_t value = static_cast<uint8_t>(output);
+            writeRaw(&value, 1);
+            outputWritten = output;
+            cacheValid = false;
+        }
+        return;
+    }
+    uint16_t updated = dir == DigitalPin::Direction::Input ? (direction | mask) : (direction & ~mask);
+    if (updated != direction) {
+        direction = updated;
+        writeWord(MCP_IODIRA, direction);
+        cacheValid = false;
+    }
+}
+
+void I2cExpander::setPullUp(std::size_t bit, bool enabled) {
+    checkBit(bit);
+    if (chip != Chip::MCP23017) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    const uint16_t mask = static_cast<uint16_t>(1u << bit);
+    uint16_t updated = enabled ? (pullUp | mask) : (pullUp & ~mask);
+    if (updated != pullUp) {
+        pullUp = updated;
+        writeWord(MCP_GPPUA, pullUp);
+        cacheValid = false;
+    }
+}
+
+void I2cExpander::set(std::size_t bit, bool level) {
+    checkBit(bit);
+    std::lock_guard<std::mutex> lock(mtx);
+    const uint16_t mask = static_cast<uint16_t>(1u << bit);
+    output = level ? (output | mask) : (output & ~mask);
+}
+
+void I2cExpander::setMasked(uint16_t mask, uint16_t value) {
+    if ((mask >> width()) != 0) {
+        throw std::out_of_range("I2C expander line out of range");
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    output = static_cast<uint16_t>((output & ~mask) | (value & mask));
+}
+
+void I2cExpander::flush() {
+    std::lock_guard<std::mutex> lock(mtx);
+    const uint16_t changed = output ^ outputWritten;
+    if (!changed) {
+        return;
+    }
+    if (chip == Chip::PCF8574) {
+        uint8_t value = static_cast<uint8_t>(output);
+        writeRaw(&value, 1);
+    } else if ((changed & 0x00FF) && (changed & 0xFF00)) {
+        // Sequential addressing writes OLATA and OLATB in one transaction.
+        writeWord(MCP_OLATA, output);
+    } else {
+        const bool portB = (changed & 0xFF00) != 0;
+        uint8_t value = static_cast<uint8_t>(portB ? output >> 8 : output);
+        writeRegisters(static_cast<uint8_t>(MCP_OLATA + (portB ? 1 : 0)), &value, 1);
+    }
+    outputWritten = output;
+    // A written line reads back its new level, and on a PCF8574 a line written
+    // high becomes an input again, so the cached inputs are stale.
+    cacheValid = false;
+}
+
+void I2cExpander::write(std::size_t bit, bool level) {
+    set(bit, level);
+    flush();
+}
+
+uint16_t I2cExpander::readInputs() {
+    if (interruptDriven && cacheValid && cacheGeneration == interruptGeneration.load()) {
+        return inputCache;
+    }
+    // Sample the generation before reading so an INT edge arriving mid-read
+    // still invalidates, and mark the cache valid only once the read succeeded.
+    const unsigned long generation = interruptGeneration.load();
+    uint8_t bytes[2] = {0, 0};
+    if (chip == Chip::MCP23017) {
+        // Reading GPIO also clears a pending MCP23017 interrupt.
+        readRegisters(MCP_GPIOA, bytes, 2);
+    } else {
+        readRaw(bytes, 1);
+    }
+    inputCache = static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+    cacheGeneration = generation;
+    cacheValid = interruptDriven;
+    return inputCache;
+}
+
+bool I2cExpander::read(std::size_t bit) {
+    checkBit(bit);
+    std::lock_guard<std::mutex> lock(mtx);
+    return (readInputs() >> bit) & 0x1;
+}
+
+uint16_t I2cExpander::readAll() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return readInputs();
+}
+
+void I2cExpander::onInterrupt() {
+    // Lock-free so it can be called from an edge callback; readInputs()
+    // compares generations instead of sharing a flag with it.
+    interruptGeneration.fetch_add(1);
+}
+
+I2cExpanderPin I2cExpander::pin(std::size_t bit) {
+    checkBit(bit);
+    return I2cExpanderPin(*this, bit);
+}
+
+unsigned long I2cExpander::transactions() const {
+    return transactionCount.load();
+}
@@ -0,0 +1,166 @@
+#ifndef I2CEXPANDER_H
+#define I2CEXPANDER_H
+
+#include "DigitalPin.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+class I2cExpander;
+
+/**
+ * @brief One line of an I2C expander, used like a DigitalPin.
+ */
+class I2cExpanderPin {
+public:
+    I2cExpanderPin(I2cExpander& expander, std::size_t bit);
+
+    /**
+     * @brief Writes the line immediately.
+     */
+    void write(bool value);
+
+    /**
+     * @brief Reads the line, from the input cache when it is valid.
+     */
+    bool read();
+
+private:
+    I2cExpander& expander;
+    std::size_t bit;
+};
+
+/**
+ * @brief MCP23017 / PCF8574 GPIO expander accessed through /dev/i2c-N.
+ *
+ * Output registers are shadowed: set() only changes the shadow and flush()
+ * writes each changed register once, so a batch of line changes costs at most
+ * one bus write per register. Input reads are served from a cache that is
+ * invalidated when the expander's INT line fires; feed those edges to
+ * onInterrupt(). Without an INT line every read goes to the bus.
+ */
+class I2cExpander {
+public:
+    enum class Chip { MCP23017, PCF8574 };
+
+    /**
+     * @brief Opens the expander.
+     * @param bus I2C bus number (N in /dev/i2c-N).
+     * @param address 7-bit slave address.
+     * @param chip Expander type.
+     * @param interruptDriven true if onInterrupt() will be fed from the INT line.
+     * @throws std::runtime_error if the bus cannot be opened or the device does not respond.
+     */
+    I2cExpander(int bus, uint8_t address, Chip chip, bool interruptDriven = false);
+
+    /**
+     * @brief Takes over an open I2C device descriptor with the slave already selected.
+     *
+     * Every transaction is one read() or write() on fd, so any descriptor that
+     * keeps message boundaries (such as a SOCK_SEQPACKET socket) can stand in
+     * for the bus. The expander closes fd on destruction, or if this throws.
+     * @param fd Open descriptor.
+     * @param chip Expander type.
+     * @param interruptDriven true if onInterrupt() will be fed from the INT line.
+     * @throws std::runtime_error if the device does not respond.
+     */
+    I2cExpander(int fd, Chip chip, bool interruptDriven = false);
+
+    ~I2cExpander();
+
+    I2cExpander(const I2cExpander&) = delete;
+    I2cExpander& operator=(const I2cExpander&) = delete;
+
+    /**
+     * @brief Sets a line's direction (MCP23017 only; PCF8574 lines are quasi-bidirectional).
+     * @throws std::out_of_range if bit is outside the expander.
+     */
+    void setDirection(std::size_t bit, DigitalPin::Direction direction);
+
+    /**
+     * @brief Enables or disables the internal pull-up of a line (MCP23017 only).
+     */
+    void setPullUp(std::size_t bit, bool enabled);
+
+    /**
+     * @brief Changes a line in the output shadow without touching the bus.
+     */
+    void set(std::size_t bit, bool level);
+
+    /**
+     * @brief Changes several lines in the output shadow under one lock.
+     * @param mask Lines to change (bit 0 = GPA0 / P0).
+     * @param value New levels of the masked lines.
+     * @throws std::out_of_range if mask selects a line outside the expander.
+     */
+    void setMasked(uint16_t mask, uint16_t value);
+
+    /**
+     * @brief Writes every output register changed since the last flush.
+     *
+     * Drops the input cache, since an output change can move input levels
+     * without the expander raising INT.
+     */
+    void flush();
+
+    /**
+     * @brief Sets a line and flushes.
+     */
+    void write(std::size_t bit, bool level);
+
+    /**
+     * @brief Reads a line.
+     */
+    bool read(std::size_t bit);
+
+    /**
+     * @brief Reads all lines as one word (bit 0 = GPA0 / P0).
+     */
+    uint16_t readAll();
+
+    /**
+     * @brief Marks the input cache stale; call on every INT edge.
+     */
+    void onInterrupt();
+
+    /**
+     * @brief Returns a virtual pin for one line.
+     */
+    I2cExpanderPin pin(std::size_t bit);
+
+    std::size_t width() const;
+
+    /**
+     * @brief Returns the number of I2C transactions issued.
+     */
+    unsigned long transactions() const;
+
+private:
+    void checkBit(std::size_t bit) const;
+    void writeRegisters(uint8_t reg, const uint8_t* data, std::size_t length);
+    void readRegisters(uint8_t reg, uint8_t* data, std::size_t length);
+    void writeRaw(const uint8_t* data, std::size_t length);
+    void readRaw(uint8_t* data, std::size_t length);
+    uint16_t readInputs();
+    void writeWord(uint8_t regA, uint16_t value);
+
+    mutable std::mutex mtx;
+    int fd;
+    Chip chip;
+    bool interruptDriven;
+
+    uint16_t output;
+    uint16_t outputWritten;
+    uint16_t direction;            ///< 1 = input (MCP23017 IODIR convention)
+    uint16_t pullUp;
+    uint16_t inputCache;
+    bool cacheValid;
+    unsigned long cacheGeneration;          ///< interruptGeneration when inputCache was read
+    std::atomic<unsigned long> interruptGeneration;
+    std::atomic<unsigned long> transactionCount;
+};
+
+#endif // I2CEXPANDER_H
@@ -0,0 +1,146 @@
+#include "Ili9341.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+constexpr uint8_t CMD_SWRESET = 0x01;
+constexpr uint8_t CMD_SLPOUT = 0x11;
+constexpr uint8_t CMD_DISPON = 0x29;
+constexpr uint8_t CMD_CASET = 0x2A;
+constexpr uint8_t CMD_PASET = 0x2B;
+constexpr uint8_t CMD_RAMWR = 0x2C;
+constexpr uint8_t CMD_MADCTL = 0x36;
+constexpr uint8_t CMD_PIXFMT = 0x3A;
+constexpr uint8_t PIXFMT_RGB565 = 0x55;
+
+// True if the rectangles overlap or share an edge.
+bool touches(const Ili9341::Rect& a, const Ili9341::Rect& b) {
+    return a.x <= b.x + b.width && b.x <= a.x + a.width && a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+Ili9341::Rect unite(const Ili9341::Rect& a, const Ili9341::Rect& b) {
+    std::size_t x0 = std::min(a.x, b.x);
+    std::size_t y0 = std::min(a.y, b.y);
+    std::size_t x1 = std::max(a.x + a.width, b.x + b.width);
+    std::size_t y1 = std::max(a.y + a.height, b.y + b.height);
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+} // namespace
+
+Ili9341::Ili9341(Parallel8080Bus& bus, std::size_t width, std::size_t height, uint8_t madctl)
+    : bus(bus), width(width), height(height), framebuffer(width * height, 0) {
+    bus.writeCommand(CMD_SWRESET);
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    bus.writeCommand(CMD_SLPOUT);
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    bus.writeCommand(CMD_PIXFMT);
+    bus.writeData(&PIXFMT_RGB565, 1);
+    bus.writeCommand(CMD_MADCTL);
+    bus.writeData(&madctl, 1);
+    bus.writeCommand(CMD_DISPON);
+    invalidate();
+}
+
+uint16_t Ili9341::rgb565(uint8_t r, uint8_t g, uint8_t b) {
+    return static_cast<uint16_t>(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+bool Ili9341::clip(Rect& rect) const {
+    if (rect.x >= width || rect.y >= height || rect.width == 0 || rect.height == 0) {
+        return false;
+    }
+    rect.width = std::min(rect.width, width - rect.x);
+    rect.height = std::min(rect.height, height - rect.y);
+    return true;
+}
+
+void Ili9341::markDirty(Rect rect) {
+    // Absorb every rectangle the new one touches, repeating as it grows.
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (auto it = dirty.begin(); it != dirty.end(); ++it) {
+            if (touches(*it, rect)) {
+                rect = unite(*it, rect);
+                dirty.erase(it);
+                merged = true;
+                break;
+            }
+        }
+    }
+    dirty.push_back(rect);
+    if (dirty.size() > MAX_DIRTY_RECTS) {
+        Rect bounds = dirty.front();
+        for (const Rect& r : dirty) {
+            bounds = unite(bounds, r);
+        }
+        dirty.assign(1, bounds);
+    }
+}
+
+void Ili9341::setPixel(std::size_t x, std::size_t y, uint16_t color) {
+    fillRect({x, y, 1, 1}, color);
+}
+
+void Ili9341::fillRect(const Rect& area, uint16_t color) {
+    Rect rect = area;
+    if (!clip(rect)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    for (std::size_t y = rect.y; y < rect.y + rect.height; ++y) {
+        std::fill_n(framebuffer.begin() + y * width + rect.x, rect.width, color);
+    }
+    markDirty(rect);
+}
+
+void Ili9341::blit(const Rect& area, const uint16_t* pixels) {
+    Rect rect = area;
+    if (!clip(rect)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    for (std::size_t row = 0; row < rect.height; ++row) {
+        std::copy_n(pixels + row * area.width, rect.width, framebuffer.begin() + (rect.y + row) * width + rect.x);
+    }
+    markDirty(rect);
+}
+
+void Ili9341::invalidate() {
+    std::lock_guard<std::mutex> lock(mtx);
+    dirty.assign(1, Rect{0, 0, width, height});
+}
+
+std::vector<Ili9341::Rect> Ili9341::dirtyRects() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return dirty;
+}
+
+void Ili9341::setWindow(const Rect& rect) {
+    const std::size_t x1 = rect.x + rect.width - 1;
+    const std::size_t y1 = rect.y + rect.height - 1;
+    const uint8_t columns[4] = {static_cast<uint8_t>(rect.x >> 8), static_cast<uint8_t>(rect.x),
+                                static_cast<uint8_t>(x1 >> 8), static_cast<uint8_t>(x1)};
+    const uint8_t pages[4] = {static_cast<uint8_t>(rect.y >> 8), static_cast<uint8_t>(rect.y),
+                              static_cast<uint8_t>(y1 >> 8), static_cast<uint8_t>(y1)};
+    bus.writeCommand(CMD_CASET);
+    bus.writeData(columns, 4);
+    bus.writeCommand(CMD_PASET);
+    bus.writeData(pages, 4);
+    bus.writeCommand(CMD_RAMWR);
+}
+
+std::size_t Ili9341::flush() {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::size_t sent = 0;
+    for (const Rect& rect : dirty) {
+        setWindow(rect);
+        for (std::size_t y = rect.y; y < rect.y + rect.height; ++y) {
+            bus.writePixels(framebuffer.data() + y * width + rect.x, rect.width);
+        }
+        sent += rect.width * rect.height;
+    }
+    dirty.clear();
+    return sent;
+}
@@ -0,0 +1,81 @@
+#ifndef ILI9341_H
+#define ILI9341_H
+
+#include "Parallel8080Bus.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief ILI9341 TFT driver with a local framebuffer and dirty-rectangle updates.
+ *
+ * Drawing only touches the RGB565 framebuffer and records the affected
+ * rectangle. flush() merges overlapping or touching rectangles and streams
+ * each remaining one through a partial window (CASET/PASET/RAMWR), so small
+ * changes cost a small number of bus cycles.
+ */
+class Ili9341 {
+public:
+    struct Rect {
+        std::size_t x;
+        std::size_t y;
+        std::size_t width;
+        std::size_t height;
+    };
+
+    /**
+     * @brief Initialises the controller for RGB565 in the given orientation.
+     * @param bus 8080 bus wired to the panel.
+     * @param width Panel width in pixels for the chosen orientation.
+     * @param height Panel height in pixels for the chosen orientation.
+     * @param madctl Memory access control value (rotation / BGR order).
+     */
+    Ili9341(Parallel8080Bus& bus, std::size_t width = 240, std::size_t height = 320, uint8_t madctl = 0x48);
+
+    void setPixel(std::size_t x, std::size_t y, uint16_t color);
+    void fillRect(const Rect& rect, uint16_t color);
+
+    /**
+     * @brief Copies a block of RGB565 pixels into the framebuffer.
+     * @param rect Destination; pixels holds rect.width * rect.height values.
+     */
+    void blit(const Rect& rect, const uint16_t* pixels);
+
+    /**
+     * @brief Streams every dirty region to the panel.
+     * @return Number of pixels sent.
+     */
+    std::size_t flush();
+
+    /**
+     * @brief Marks the whole screen dirty.
+     */
+    void invalidate();
+
+    /**
+     * @brief Returns the pending dirty rectangles (after merging).
+     */
+    std::vector<Rect> dirtyRects() const;
+
+    static uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b);
+
+    /// Beyond this many rectangles they are collapsed into their bounding box.
+    static constexpr std::size_t MAX_DIRTY_RECTS = 8;
+
+private:
+    bool clip(Rect& rect) const;
+    void markDirty(Rect rect);
+    void setWindow(const Rect& rect);
+
+    Parallel8080Bus& bus;
+    std::size_t width;
+    std::size_t height;
+
+    mutable std::mutex mtx;
+    std::vector<uint16_t> framebuffer;
+    std::vector<Rect> dirty;
+};
+
+#endif // ILI9341_H
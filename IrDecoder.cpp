@@ -0,0 +1,299 @@
+#include "IrDecoder.h"
+
+#include <array>
+
+namespace {
+
+using std::chrono::nanoseconds;
+using Pulse = IrDecoder::Pulse;
+using Protocol = IrCommand::Protocol;
+
+/**
+ * @brief Timing of one protocol; header widths are in units, zero for none.
+ */
+struct ProtocolTiming {
+    Protocol protocol;
+    nanoseconds unit;
+    int headerMark;
+    int headerSpace;
+    int bits;                           ///< Data bits after the header and any mode/trailer fields
+};
+
+constexpr std::array<ProtocolTiming, 3> PROTOCOLS = {{
+    {Protocol::NEC, nanoseconds(562500), 16, 8, 32},
+    {Protocol::RC5, nanoseconds(889000), 0, 0, 14},
+    {Protocol::RC6, nanoseconds(444000), 6, 2, 16},
+}};
+
+/// NEC repeat code: header mark, then a space of four units.
+constexpr int NEC_REPEAT_SPACE = 4;
+
+bool near(nanoseconds actual, nanoseconds expected) {
+    // Receivers stretch marks and shorten spaces by up to ~100 us; allow 30%.
+    const auto tolerance = expected * 3 / 10;
+    return actual >= expected - tolerance && actual <= expected + tolerance;
+}
+
+bool hasHeader(const std::vector<Pulse>& pulses, const ProtocolTiming& timing, int headerSpace) {
+    return pulses.size() >= 2 && near(pulses[0].duration, timing.unit * timing.headerMark) &&
+           near(pulses[1].duration, timing.unit * headerSpace);
+}
+
+/**
+ * @brief Expands pulses into one level per unit, for bi-phase decoding.
+ * @return false if a pulse is not close to a whole number of units.
+ */
+bool toUnits(const std::vector<Pulse>& pulses, std::size_t from, nanoseconds unit, std::vector<bool>& levels) {
+    for (std::size_t i = from; i < pulses.size(); ++i) {
+        const auto count = (pulses[i].duration + unit / 2) / unit;
+        if (count < 1 || count > 3 || !near(pulses[i].duration, unit * count)) {
+            return false;
+        }
+        levels.insert(levels.end(), static_cast<std::size_t>(count), pulses[i].mark);
+    }
+    return true;
+}
+
+bool decodeNec(const std::vector<Pulse>& pulses, const ProtocolTiming& timing, IrCommand& command) {
+    if (pulses.size() == 3 && hasHeader(pulses, timing, NEC_REPEAT_SPACE)) {
+        command.repeat = true;
+        return true;
+    }
+    if (pulses.size() != static_cast<std::size_t>(2 + 2 * timing.bits + 1) ||
+        !hasHeader(pulses, timing, timing.headerSpace)) {
+        return false;
+    }
+    uint32_t value = 0;
+    for (int bit = 0; bit < timing.bits; ++bit) {
+        const auto mark = pulses[2 + 2 * bit].duration;
+        const auto space = pulses[3 + 2 * bit].duration;
+        if (!near(mark, timing.unit)) {
+            return false;
+        }
+        if (near(space, timing.unit * 3)) {
+            value |= uint32_t(1) << bit;  // LSB first
+        } else if (!near(space, timing.unit)) {
+            return false;
+        }
+    }
+    const uint8_t address = value & 0xFF;
+    const uint8_t addressInv = (value >> 8) & 0xFF;
+    const uint8_t cmd = (value >> 16) & 0xFF;
+    if (uint8_t(~cmd) != ((value >> 24) & 0xFF)) {
+        return false;
+    }
+    // Extended NEC uses the inverted address byte as the high address byte.
+    command.address = uint8_t(~address) == addressInv ? address : uint16_t(value & 0xFFFF);
+    command.command = cmd;
+    return true;
+}
+
+bool decodeRc5(const std::vector<Pulse>& pulses, const ProtocolTiming& timing, IrCommand& command) {
+    // The first half of the leading start bit is a space and cannot be seen.
+    std::vector<bool> levels{false};
+    if (!toUnits(pulses, 0, timing.unit, levels)) {
+        return false;
+    }
+    const std::size_t units = 2 * timing.bits;
+    if (levels.size() > units || levels.size() + 1 < units) {
+        return false;
+    }
+    levels.resize(units, false);
+
+    uint32_t value = 0;
+    for (int bit = 0; bit < timing.bits; ++bit) {
+        const bool first = levels[2 * bit];
+        const bool second = levels[2 * bit + 1];
+        if (first == second) {
+            return false;
+        }
+        value = (value << 1) | (second ? 1 : 0);  // mark in the second half is a 1
+    }
+    // S1 S2 T A4..A0 C5..C0; an inverted S2 is command bit 6.
+    if (!(value & (1u << 13))) {
+        return false;
+    }
+    command.toggle = (value >> 11) & 1;
+    command.address = (value >> 6) & 0x1F;
+    command.command = static_cast<uint8_t>((value & 0x3F) | (((value >> 12) & 1) ? 0 : 0x40));
+    return true;
+}
+
+bool decodeRc6(const std::vector<Pulse>& pulses, const ProtocolTiming& timing, IrCommand& command) {
+    if (!hasHeader(pulses, timing, timing.headerSpace)) {
+        return false;
+    }
+    std::vector<bool> levels;
+    if (!toUnits(pulses, 2, timing.unit, levels)) {
+        return false;
+    }
+    // Start bit, three mode bits, a double-width trailer bit and 16 data bits.
+    const std::size_t units = 2 + 3 * 2 + 4 + 2 * timing.bits;
+    if (levels.size() > units || levels.size() + 1 < units) {
+        return false;
+    }
+    levels.resize(units, false);
+
+    // RC6 bits are a mark then a space for 1, the reverse for 0.
+    auto bitAt = [&levels](std::size_t unit, std::size_t width, bool& bit) {
+        for (std::size_t i = 1; i < width; ++i) {
+            if (levels[unit + i] != levels[unit]) {
+                return false;
+            }
+        }
+        for (std::size_t i = 0; i < width; ++i) {
+            if (levels[unit + width + i] == levels[unit]) {
+                return false;
+            }
+        }
+        bit = levels[unit];
+        return true;
+    };
+
+    bool bit = false;
+    if (!bitAt(0, 1, bit) || !bit) {
+        return false;
+    }
+    unsigned mode = 0;
+    for (std::size_t i = 0; i < 3; ++i) {
+        if (!bitAt(2 + 2 * i, 1, bit)) {
+            return false;
+        }
+        mode = (mode << 1) | (bit ? 1 : 0);
+    }
+    if (mode != 0 || !bitAt(8, 2, bit)) {
+        return false;
+    }
+    command.toggle = bit;
+    uint32_t value = 0;
+    for (int i = 0; i < timing.bits; ++i) {
+        if (!bitAt(12 + 2 * i, 1, bit)) {
+            return false;
+        }
+        value = (value << 1) | (bit ? 1 : 0);
+    }
+    command.address = (value >> 8) & 0xFF;
+    command.command = value & 0xFF;
+    return true;
+}
+
+} // namespace
+
+constexpr std::chrono::microseconds IrDecoder::FRAME_GAP;
+
+IrDecoder::IrDecoder(bool activeLow, std::chrono::nanoseconds repeatWindow)
+    : activeLow(activeLow),
+      repeatWindow(repeatWindow),
+      inFrame(false),
+      lastEdge(0),
+      haveLast(false) {}
+
+void IrDecoder::onEdge(const EdgeEvent& event) {
+    std::lock_guard<std::mutex> lock(mtx);
+    // The level before this edge is the opposite of the new one.
+    const bool wasMark = event.rising == activeLow;
+    const auto duration = event.timestamp - lastEdge;
+    lastEdge = event.timestamp;
+
+    if (!inFrame) {
+        // Only the start of a mark can open a frame.
+        inFrame = !wasMark;
+        return;
+    }
+    if (!wasMark && duration >= FRAME_GAP) {
+        finishFrame();
+        inFrame = true;
+        return;
+    }
+    pulses.push_back({wasMark, duration});
+}
+
+void IrDecoder::poll(std::chrono::nanoseconds now) {
+    std::lock_guard<std::mutex> lock(mtx);
+    // A frame always ends on a mark, so the line has been in a space since its last edge.
+    if (inFrame && !pulses.empty() && pulses.back().mark && now - lastEdge >= FRAME_GAP) {
+        finishFrame();
+        inFrame = false;
+    }
+}
+
+std::chrono::nanoseconds IrDecoder::nextDeadline() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return inFrame && !pulses.empty() ? lastEdge + FRAME_GAP : std::chrono::nanoseconds(0);
+}
+
+void IrDecoder::finishFrame() {
+    if (pulses.empty()) {
+        return;
+    }
+    IrCommand command;
+    command.timestamp = lastEdge;
+    if (!decode(pulses, command)) {
+        ++counters.unknown;
+        pulses.clear();
+        return;
+    }
+    pulses.clear();
+
+    const bool recent = haveLast && command.timestamp - last.timestamp <= repeatWindow;
+    if (command.repeat) {
+        // A NEC repeat code carries no data; it repeats the last NEC command.
+        if (!recent || last.protocol != IrCommand::Protocol::NEC) {
+            ++counters.unknown;
+            return;
+        }
+        const auto timestamp = command.timestamp;
+        command = last;
+        command.repeat = true;
+        command.timestamp = timestamp;
+        ++counters.repeats;
+    } else {
+        command.repeat = recent && command.protocol != IrCommand::Protocol::NEC &&
+                         command.protocol == last.protocol && command.toggle == last.toggle &&
+                         command.address == last.address && command.command == last.command;
+        if (command.repeat) {
+            ++counters.repeats;
+        } else {
+            ++counters.frames;
+        }
+    }
+    last = command;
+    haveLast = true;
+    commands.push_back(command);
+}
+
+std::vector<IrCommand> IrDecoder::readAvailable() {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<IrCommand> result(commands.begin(), commands.end());
+    commands.clear();
+    return result;
+}
+
+IrDecoder::Stats IrDecoder::stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return counters;
+}
+
+bool IrDecoder::decode(const std::vector<Pulse>& pulses, IrCommand& command) {
+    for (const ProtocolTiming& timing : PROTOCOLS) {
+        IrCommand candidate = command;
+        candidate.protocol = timing.protocol;
+        bool matched = false;
+        switch (timing.protocol) {
+        case Protocol::NEC:
+            matched = decodeNec(pulses, timing, candidate);
+            break;
+        case Protocol::RC5:
+            matched = decodeRc5(pulses, timing, candidate);
+            break;
+        case Protocol::RC6:
+            matched = decodeRc6(pulses, timing, candidate);
+            break;
+        }
+        if (matched) {
+            command = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,114 @@
+#ifndef IRDECODER_H
+#define IRDECODER_H
+
+#include "EdgeEvent.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief A command decoded by IrDecoder.
+ */
+struct IrCommand {
+    enum class Protocol { NEC, RC5, RC6 };
+
+    Protocol protocol = Protocol::NEC;
+    uint16_t address = 0;               ///< 8 bits, or 16 for extended NEC
+    uint8_t command = 0;
+    bool toggle = false;                ///< RC5/RC6 toggle bit
+    bool repeat = false;                ///< NEC repeat code, or RC5/RC6 frame with an unchanged toggle
+    std::chrono::nanoseconds timestamp{0}; ///< Time of the last edge of the frame
+};
+
+/**
+ * @brief Table-driven consumer-IR decoder for NEC, RC5 and RC6 (mode 0).
+ *
+ * The caller feeds edge events from a demodulated IR receiver; mark and space
+ * widths are taken from their timestamps, so the line is never sampled. A
+ * frame is closed by a space longer than any that occurs inside one and is
+ * then matched against each protocol in the timing table. poll() closes a
+ * frame whose last edge has already arrived, and nextDeadline() says when to
+ * call it.
+ *
+ * The decoder holds no thread, so one reactor thread can serve several
+ * receivers by dispatching each line's edges to its decoder.
+ */
+class IrDecoder {
+public:
+    struct Stats {
+        unsigned long frames = 0;
+        unsigned long repeats = 0;
+        unsigned long unknown = 0;      ///< Frames that matched no protocol
+    };
+
+    /**
+     * @brief Constructs a decoder.
+     * @param activeLow true for receivers whose output is low while carrier is present.
+     * @param repeatWindow Longest gap after which a NEC repeat or unchanged toggle still counts as a repeat.
+     */
+    explicit IrDecoder(bool activeLow = true,
+                       std::chrono::nanoseconds repeatWindow = std::chrono::milliseconds(200));
+
+    /**
+     * @brief Feeds an edge from the receiver output.
+     * @param event Edge event; events must arrive in time order.
+     */
+    void onEdge(const EdgeEvent& event);
+
+    /**
+     * @brief Closes the current frame if the line has been idle long enough.
+     * @param now Current monotonic time in nanoseconds.
+     */
+    void poll(std::chrono::nanoseconds now);
+
+    /**
+     * @brief Returns the time at which poll() would close the current frame.
+     * @return Deadline, or zero when no frame is in progress.
+     */
+    std::chrono::nanoseconds nextDeadline() const;
+
+    /**
+     * @brief Removes and returns all commands decoded so far.
+     */
+    std::vector<IrCommand> readAvailable();
+
+    Stats stats() const;
+
+    /// A mark (carrier on) or space, as received.
+    struct Pulse {
+        bool mark;
+        std::chrono::nanoseconds duration;
+    };
+
+    /**
+     * @brief Decodes one frame of pulses, starting with its first mark.
+     * @param pulses Frame pulses; the trailing idle space is not included.
+     * @param command Receives the decoded command; repeat reflects only the NEC repeat code.
+     * @return true if a protocol in the table matched.
+     */
+    static bool decode(const std::vector<Pulse>& pulses, IrCommand& command);
+
+    /// Space that ends a frame; longer than any space inside NEC, RC5 or RC6 frames.
+    static constexpr std::chrono::microseconds FRAME_GAP{8000};
+
+private:
+    void finishFrame();
+
+    mutable std::mutex mtx;
+    bool activeLow;
+    std::chrono::nanoseconds repeatWindow;
+
+    bool inFrame;
+    std::chrono::nanoseconds lastEdge;
+    std::vector<Pulse> pulses;
+    bool haveLast;
+    IrCommand last;
+    std::deque<IrCommand> commands;
+    Stats counters;
+};
+
+#endif // IRDECODER_H
@@ -0,0 +1,202 @@
+#include "LogicalPort.h"
+
+#include <stdexcept>
+
+DigitalPortBackend::DigitalPortBackend(DigitalPort& port) : port(port) {}
+
+std::size_t DigitalPortBackend::width() const {
+    return port.width();
+}
+
+void DigitalPortBackend::writeMasked(uint64_t mask, uint64_t value) {
+    port.writeMasked(mask, value);
+}
+
+uint64_t DigitalPortBackend::read() {
+    return port.read();
+}
+
+ShiftRegisterBackend::ShiftRegisterBackend(ShiftRegisterOutput& chain) : chain(chain) {}
+
+std::size_t ShiftRegisterBackend::width() const {
+    return chain.size();
+}
+
+void ShiftRegisterBackend::writeMasked(uint64_t mask, uint64_t value) {
+    chain.setMasked(mask, value);
+    chain.flush();
+}
+
+uint64_t ShiftRegisterBackend::read() {
+    uint64_t value = 0;
+    for (std::size_t bit = 0; bit < chain.size() && bit < 64; ++bit) {
+        if (chain.get(bit)) {
+            value |= uint64_t(1) << bit;
+        }
+    }
+    return value;
+}
+
+I2cExpanderBackend::I2cExpanderBackend(I2cExpander& expander) : expander(expander) {}
+
+std::size_t I2cExpanderBackend::width() const {
+    return expander.width();
+}
+
+void I2cExpanderBackend::writeMasked(uint64_t mask, uint64_t value) {
+    expander.setMasked(static_cast<uint16_t>(mask), static_cast<uint16_t>(value));
+    expander.flush();
+}
+
+uint64_t I2cExpanderBackend::read() {
+    return expander.readAll();
+}
+
+LogicalPort::LogicalPort(const std::vector<PortBackend*>& backends, const std::vector<Mapping>& mapping)
+    : bits(mapping.size()) {
+    if (mapping.empty() || mapping.size() > 64) {
+        throw std::invalid_argument("LogicalPort needs between 1 and 64 bits");
+    }
+
+    std::vector<std::vector<std::pair<unsigned int, unsigned int>>> pairs(backends.size());
+    for (std::size_t logical = 0; logical < mapping.size(); ++logical) {
+        const Mapping& m = mapping[logical];
+        if (m.backend >= backends.size() || !backends[m.backend] || m.bit >= backends[m.backend]->width()) {
+            throw std::invalid_argument("LogicalPort mapping out of range");
+        }
+        pairs[m.backend].emplace_back(static_cast<unsigned int>(logical), m.bit);
+    }
+    for (std::size_t b = 0; b < backends.size(); ++b) {
+        if (!pairs[b].empty()) {
+            groups.push_back({backends[b], BitPermutation(pairs[b])});
+        }
+    }
+
+    physMask.assign(groups.size(), 0);
+    physValue.assign(groups.size(), 0);
+
+    // The calling thread serves the first group; the others get a worker each.
+    for (std::size_t i = 1; i < groups.size(); ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    try {
+        for (std::size_t i = 0; i < workers.size(); ++i) {
+            workers[i]->thread = std::thread(&LogicalPort::runWorker, this, i);
+        }
+    } catch (...) {
+        // Joinable threads would call std::terminate when destroyed.
+        stopWorkers();
+        throw;
+    }
+}
+
+LogicalPort::~LogicalPort() {
+    stopWorkers();
+}
+
+void LogicalPort::stopWorkers() {
+    for (auto& worker : workers) {
+        if (!worker->thread.joinable()) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(worker->mtx);
+            worker->stop = true;
+        }
+        worker->cv.notify_all();
+        worker->thread.join();
+    }
+}
+
+void LogicalPort::runWorker(std::size_t index) {
+    Worker& worker = *workers[index];
+    PortBackend* backend = groups[index + 1].backend;
+    std::unique_lock<std::mutex> lock(worker.mtx);
+    while (true) {
+        worker.cv.wait(lock, [&worker]() { return worker.stop || worker.pending; });
+        if (worker.stop) {
+            return;
+        }
+        worker.pending = false;
+        uint64_t mask = worker.mask;
+        uint64_t value = worker.value;
+        lock.unlock();
+
+        std::exception_ptr error;
+        try {
+            backend->writeMasked(mask, value);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        worker.error = error;
+        worker.done = true;
+        worker.cv.notify_all();
+    }
+}
+
+void LogicalPort::write(uint64_t value) {
+    writeMasked(bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1, value);
+}
+
+void LogicalPort::writeMasked(uint64_t mask, uint64_t value) {
+    std::lock_guard<std::mutex> writeLock(writeMtx);
+
+    // Split into one physical (mask, value) pair per backend.
+    for (std::size_t g = 0; g < groups.size(); ++g) {
+        physMask[g] = groups[g].permutation.toPhysical(mask);
+        physValue[g] = groups[g].permutation.toPhysical(value & mask);
+    }
+
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        if (!physMask[i + 1]) {
+            continue;
+        }
+        Worker& worker = *workers[i];
+        {
+            std::lock_guard<std::mutex> lock(worker.mtx);
+            worker.mask = physMask[i + 1];
+            worker.value = physValue[i + 1];
+            worker.done = false;
+            worker.pending = true;
+        }
+        worker.cv.notify_all();
+    }
+
+    std::exception_ptr error;
+    if (physMask[0]) {
+        try {
+            groups[0].backend->writeMasked(physMask[0], physValue[0]);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        if (!physMask[i + 1]) {
+            continue;
+        }
+        Worker& worker = *workers[i];
+        std::unique_lock<std::mutex> lock(worker.mtx);
+        worker.cv.wait(lock, [&worker]() { return worker.done; });
+        if (!error && worker.error) {
+            error = worker.error;
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+uint64_t LogicalPort::read() {
+    uint64_t value = 0;
+    for (const Group& group : groups) {
+        value |= group.permutation.toLogical(group.backend->read());
+    }
+    return value;
+}
+
+std::size_t LogicalPort::width() const {
+    return bits;
+}
@@ -0,0 +1,214 @@
+#ifndef LOGICALPORT_H
+#define LOGICALPORT_H
+
+#include "BitPermutation.h"
+#include "DigitalPort.h"
+#include "I2cExpander.h"
+#include "ShiftRegister.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Word-wide access to one physical I/O backend.
+ */
+class PortBackend {
+public:
+    virtual ~PortBackend() = default;
+
+    /**
+     * @brief Returns the number of lines in the backend.
+     */
+    virtual std::size_t width() const = 0;
+
+    /**
+     * @brief Updates the masked lines in as few operations as the backend allows.
+     */
+    virtual void writeMasked(uint64_t mask, uint64_t value) = 0;
+
+    /**
+     * @brief Reads every line.
+     */
+    virtual uint64_t read() = 0;
+};
+
+/**
+ * @brief PortBackend over a DigitalPort (one bulk kernel call per write).
+ */
+class DigitalPortBackend : public PortBackend {
+public:
+    explicit DigitalPortBackend(DigitalPort& port);
+    std::size_t width() const override;
+    void writeMasked(uint64_t mask, uint64_t value) override;
+    uint64_t read() override;
+
+private:
+    DigitalPort& port;
+};
+
+/**
+ * @brief PortBackend over a 74HC595 chain (one shift per write).
+ */
+class ShiftRegisterBackend : public PortBackend {
+public:
+    explicit ShiftRegisterBackend(ShiftRegisterOutput& chain);
+    std::size_t width() const override;
+    void writeMasked(uint64_t mask, uint64_t value) override;
+    uint64_t read() override;
+
+private:
+    ShiftRegisterOutput& chain;
+};
+
+/**
+ * @brief PortBackend over an I2C expander (at most one write per register).
+ */
+class I2cExpanderBackend : public PortBackend {
+public:
+    explicit I2cExpanderBackend(I2cExpander& expander);
+    std::size_t width() const override;
+    void writeMasked(uint64_t mask, uint64_t value) override;
+    uint64_t read() override;
+
+private:
+    I2cExpander& expander;
+};
+
+/**
+ * @brief Logical port whose bits are spread over several backends.
+ *
+ * The bit mapping is grouped per backend and compiled into a BitPermutation
+ * at construction. A write is split into exactly one writeMasked() per
+ * backend that owns a changed bit, and the per-backend operations run
+ * concurrently on one worker thread per backend, so a write costs the
+ * slowest backend rather than the sum of all of them.
+ */
+class LogicalPort {
+public:
+    /**
+     * @brief Physical location of one logical bit.
+     */
+    struct Mapping {
+        std::size_t backend;    ///< Index into the backend list
+        unsigned int bit;       ///< Line within that backend
+    };
+
+    /**
+     * @brief Constructs a logical port.
+     * @param backends Backends referenced by the mapping; must outlive the port.
+     * @param mapping Location of logical bit i at mapping[i] (at most 64).
+     * @throws std::invalid_argument if the mapping is empty, too wide or out of range.
+     */
+    LogicalPort(const std::vector<PortBackend*>& backends, const std::vector<Mapping>& mapping);
+
+    ~LogicalPort();
+
+    LogicalPort(const LogicalPort&) = delete;
+    LogicalPort& operator=(const LogicalPort&) = delete;
+
+    /**
+     * @brief Writes every logical bit.
+     * @throws The first exception raised by any backend.
+     */
+    void write(uint64_t value);
+
+    /**
+     * @brief Writes the masked logical bits, touching only backends that own them.
+     * @throws The first exception raised by any backend.
+     */
+    void writeMasked(uint64_t mask, uint64_t value);
+
+    /**
+     * @brief Reads every logical bit.
+     */
+    uint64_t read();
+
+    std::size_t width() const;
+
+private:
+    struct Group {
+        PortBackend* backend;
+        BitPermutation permutation;
+    };
+
+    struct Worker {
+        std::mutex mtx;
+        std::condition_variable cv;
+        bool pending = false;
+        bool done = false;
+        bool stop = false;
+        uint64_t mask = 0;
+        uint64_t value = 0;
+        std::exception_ptr error;
+        std::thread thread;
+    };
+
+    void runWorker(std::size_t index);
+    void stopWorkers();
+
+    std::mutex writeMtx;
+    std::size_t bits;
+    std::vector<Group> groups;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<uint64_t> physMask;     ///< Per-group scratch for writeMasked(), guarded by writeMtx
+    std::vector<uint64_t> physValue;
+};
+
+/**
+ * @brief Logical port over one DigitalPort whose wiring is fixed at compile time.
+ *
+ * Permutation is a StaticBitPermutation, so the mapping folds into the
+ * caller's code and each access is one DigitalPort call with no table or
+ * worker thread, for example
+ * StaticLogicalPort<StaticBitPermutation<3, 2, 1, 0, 7, 6, 5, 4>> data(port).
+ */
+template <typename Permutation>
+class StaticLogicalPort {
+public:
+    /**
+     * @brief Wraps a port; it must outlive this object.
+     * @throws std::invalid_argument if the mapping uses a bit beyond the port's width.
+     */
+    explicit StaticLogicalPort(DigitalPort& port) : port(port) {
+        if (port.width() < 64 && (Permutation::physicalMask() >> port.width()) != 0) {
+            throw std::invalid_argument("StaticLogicalPort mapping out of range");
+        }
+    }
+
+    /**
+     * @brief Writes every logical bit.
+     */
+    void write(uint64_t value) {
+        port.writeMasked(Permutation::physicalMask(), Permutation::toPhysical(value));
+    }
+
+    /**
+     * @brief Writes the masked logical bits.
+     */
+    void writeMasked(uint64_t mask, uint64_t value) {
+        port.writeMasked(Permutation::toPhysical(mask), Permutation::toPhysical(value));
+    }
+
+    /**
+     * @brief Reads every logical bit.
+     */
+    uint64_t read() {
+        return Permutation::toLogical(port.read());
+    }
+
+    static constexpr std::size_t width() {
+        return Permutation::width();
+    }
+
+private:
+    DigitalPort& port;
+};
+
+#endif // LOGICALPORT_H
@@ -0,0 +1,143 @@
+#include "MatrixScanner.h"
+#include "PreciseTimer.h"
+
+#include <limits>
+#include <stdexcept>
+
+namespace {
+// The idle wait returns this often only so the destructor is noticed.
+constexpr std::chrono::milliseconds IDLE_WAKE(100);
+
+uint64_t lowBits(std::size_t count) {
+    return count >= 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+}
+} // namespace
+
+MatrixScanner::MatrixScanner(DigitalPort& rows, const std::vector<unsigned int>& columnPins, KeyCallback callback,
+                             std::chrono::microseconds scanPeriod, unsigned int debounceScans,
+                             const std::string& chipName)
+    : rows(rows),
+      columns(columnPins, "MatrixScanner-COL", chipName),
+      callback(std::move(callback)),
+      scanPeriod(scanPeriod),
+      debounceScans(debounceScans),
+      rowMask(lowBits(rows.width())),
+      columnMask(lowBits(columns.width())),
+      running(true),
+      integrators(rows.width() * columns.width(), 0),
+      debounced(rows.width(), 0),
+      scanCount(0) {
+    // The per-key integrators are uint8_t, so they cannot count further.
+    if (debounceScans == 0 || debounceScans > std::numeric_limits<uint8_t>::max()) {
+        throw std::invalid_argument("MatrixScanner debounceScans must be 1-255");
+    }
+    worker = PreciseTimer::startThread(0, [this]() { run(); },
+                                       [this](std::exception_ptr error) { workerFailed(error); });
+}
+
+MatrixScanner::~MatrixScanner() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+    }
+    cv.notify_all();
+    worker.join();
+}
+
+bool MatrixScanner::isRunning() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return running;
+}
+
+bool MatrixScanner::idleActivity() {
+    // Drive every row so that any press pulls its column low.
+    rows.write(0);
+    return (~columns.read() & columnMask) != 0;
+}
+
+bool MatrixScanner::scan() {
+    const std::size_t columnCount = columns.width();
+    bool busy = false;
+
+    for (std::size_t r = 0; r < rows.width(); ++r) {
+        rows.write(rowMask & ~(uint64_t(1) << r));
+        const uint64_t raw = ~columns.read() & columnMask;
+
+        for (std::size_t c = 0; c < columnCount; ++c) {
+            uint8_t& counter = integrators[r * columnCount + c];
+            const bool down = (raw >> c) & 0x1;
+            if (down && counter < debounceScans) {
+                ++counter;
+            } else if (!down && counter > 0) {
+                --counter;
+            }
+
+            const uint64_t bit = uint64_t(1) << c;
+            const bool wasPressed = (debounced[r] & bit) != 0;
+            if (!wasPressed && counter == debounceScans) {
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    debounced[r] |= bit;
+                }
+                callback(r, c, true);
+            } else if (wasPressed && counter == 0) {
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    debounced[r] &= ~bit;
+                }
+                callback(r, c, false);
+            }
+            busy = busy || counter != 0;
+        }
+    }
+    ++scanCount;
+    return busy;
+}
+
+void MatrixScanner::run() {
+    // Start with a scan in case a key is already down.
+    bool woken = true;
+    while (isRunning()) {
+        if (!woken) {
+            edges.clear();
+            woken = columns.wait(IDLE_WAKE, edges) > 0;
+            continue;
+        }
+
+        // Scan until every key is released and settled, then check once more
+        // with all rows driven so a press that raced the last scan is not lost.
+        auto next = std::chrono::steady_clock::now();
+        do {
+            while (scan()) {
+                next += scanPeriod;
+                std::unique_lock<std::mutex> lock(mtx);
+                if (cv.wait_until(lock, next, [this]() { return !running; })) {
+                    return;
+                }
+            }
+            // The row writes toggle the columns of held keys; those edges
+            // are not presses. Anything after this drain is a new edge.
+            edges.clear();
+            columns.wait(std::chrono::nanoseconds(0), edges);
+        } while (idleActivity());
+        woken = false;
+    }
+}
+
+void MatrixScanner::workerFailed(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mtx);
+    failure = error;
+    running = false;
+}
+
+std::vector<uint64_t> MatrixScanner::state() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    return debounced;
+}
+
+unsigned long MatrixScanner::scans() const {
+    return scanCount.load();
+}
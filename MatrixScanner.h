@@ -0,0 +1,94 @@
+#ifndef MATRIXSCANNER_H
+#define MATRIXSCANNER_H
+
+#include "DigitalPort.h"
+#include "EdgeSource.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Event-driven key matrix scanner with debounce and n-key rollover.
+ *
+ * Rows are active-low outputs and columns are inputs with pull-ups. The
+ * scanner requests the columns itself with both-edge detection. While no key
+ * is down, every row is driven low and the thread blocks on the column
+ * events; a press pulls a column low and its edge wakes the scanner. It then
+ * scans at the configured rate, one bulk row write and one bulk column read
+ * per row, until every key has been released and debounced, discards the
+ * edges its own row writes caused, and goes back to waiting. Every key has
+ * its own debounce integrator, so any number of simultaneous keys is
+ * reported (diodes are needed to avoid ghosting).
+ */
+class MatrixScanner {
+public:
+    using KeyCallback = std::function<void(std::size_t row, std::size_t column, bool pressed)>;
+
+    /**
+     * @brief Constructs a scanner and starts its thread.
+     * @param rows Output port, bit i driving row i.
+     * @param columnPins Column line offsets, column j first at index j (at most 64).
+     * @param callback Called from the scanner thread on every debounced change.
+     * @param scanPeriod Interval between full scans while keys are active.
+     * @param debounceScans Consecutive scans needed to accept a change (1-255).
+     * @param chipName GPIO chip holding the column lines.
+     * @throws std::invalid_argument if debounceScans is outside 1-255 or the column list is empty or too long.
+     * @throws std::runtime_error if the column lines cannot be requested.
+     */
+    MatrixScanner(DigitalPort& rows, const std::vector<unsigned int>& columnPins, KeyCallback callback,
+                  std::chrono::microseconds scanPeriod = std::chrono::milliseconds(1),
+                  unsigned int debounceScans = 5, const std::string& chipName = "gpiochip0");
+
+    ~MatrixScanner();
+
+    MatrixScanner(const MatrixScanner&) = delete;
+    MatrixScanner& operator=(const MatrixScanner&) = delete;
+
+    /**
+     * @brief Returns the debounced pressed-key bitmap of each row.
+     * @throws The exception that stopped the scanner thread, if a line operation failed.
+     */
+    std::vector<uint64_t> state() const;
+
+    /**
+     * @brief Returns the number of full matrix scans performed.
+     */
+    unsigned long scans() const;
+
+private:
+    void run();
+    bool scan();
+    bool idleActivity();
+    bool isRunning();
+    void workerFailed(std::exception_ptr error);
+
+    DigitalPort& rows;
+    EdgeSource columns;
+    KeyCallback callback;
+    std::chrono::microseconds scanPeriod;
+    unsigned int debounceScans;
+    uint64_t rowMask;
+    uint64_t columnMask;
+
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    bool running;
+    std::exception_ptr failure;
+
+    std::vector<uint8_t> integrators;   ///< rows x columns debounce counters
+    std::vector<uint64_t> debounced;
+    std::atomic<unsigned long> scanCount;
+    std::vector<EdgeSource::LineEdge> edges;
+    std::thread worker;
+};
+
+#endif // MATRIXSCANNER_H
@@ -0,0 +1,305 @@
+#include "MotionPlanner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+constexpr std::chrono::microseconds DIR_SETUP(5);
+} // namespace
+
+MotionPlanner::MotionPlanner(DigitalPort& port, const std::vector<MotionAxis>& axes, const MotionLimits& limits,
+                             std::size_t queueDepth, std::chrono::nanoseconds pulseWidth, int rtPriority)
+    : port(port),
+      axes(axes),
+      limits(limits),
+      queueDepth(std::max<std::size_t>(queueDepth, 1)),
+      pulseWidth(pulseWidth),
+      plannedPosition(axes.size(), 0),
+      lastCruiseSpeed(0.0),
+      lockedEntrySpeed(0.0),
+      busy(false),
+      running(true),
+      emitted(new std::atomic<int64_t>[axes.size()]),
+      dirMask(0),
+      stepMask(0) {
+    if (axes.size() > 64) {
+        throw std::invalid_argument("MotionPlanner supports at most 64 axes");
+    }
+    if (!std::isfinite(limits.maxSpeed) || limits.maxSpeed <= 0 || !std::isfinite(limits.acceleration) ||
+        limits.acceleration <= 0 || !std::isfinite(limits.cornerSpeed) || limits.cornerSpeed < 0) {
+        throw std::invalid_argument("Motion speed and acceleration must be positive, corner speed non-negative");
+    }
+    for (const MotionAxis& axis : axes) {
+        if (axis.stepBit >= port.width() || axis.dirBit >= port.width()) {
+            throw std::invalid_argument("Motion axis bit outside DigitalPort");
+        }
+        stepMask |= uint64_t(1) << axis.stepBit;
+        dirMask |= uint64_t(1) << axis.dirBit;
+    }
+    for (std::size_t i = 0; i < axes.size(); ++i) {
+        emitted[i] = 0;
+    }
+
+    worker = PreciseTimer::startThread(rtPriority, [this]() { run(); },
+                                       [this](std::exception_ptr error) { workerFailed(error); });
+}
+
+MotionPlanner::~MotionPlanner() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+        queue.clear();
+    }
+    cv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void MotionPlanner::lineTo(const std::vector<int64_t>& target, double speed) {
+    if (target.size() != axes.size()) {
+        throw std::invalid_argument("lineTo target must give a position for every axis");
+    }
+    if (!std::isfinite(speed) || speed <= 0) {
+        throw std::invalid_argument("lineTo speed must be positive and finite");
+    }
+
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [this]() { return !running || queue.size() < queueDepth; });
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    if (!running) {
+        return;
+    }
+
+    Block block;
+    block.delta.resize(axes.size());
+    double sumSquares = 0.0;
+    for (std::size_t i = 0; i < axes.size(); ++i) {
+        block.delta[i] = target[i] - plannedPosition[i];
+        sumSquares += static_cast<double>(block.delta[i]) * block.delta[i];
+    }
+    if (sumSquares == 0.0) {
+        return;
+    }
+    block.length = std::sqrt(sumSquares);
+    block.unit.resize(axes.size());
+    for (std::size_t i = 0; i < axes.size(); ++i) {
+        block.unit[i] = block.delta[i] / block.length;
+    }
+    block.cruiseSpeed = std::min(speed, limits.maxSpeed);
+
+    // Junction limit: full speed when collinear, cornerSpeed at 90 degrees,
+    // falling to zero for a reversal (cotangent of the half angle).
+    block.maxEntrySpeed = 0.0;
+    if (!lastUnit.empty()) {
+        double cosine = 0.0;
+        for (std::size_t i = 0; i < axes.size(); ++i) {
+            cosine += lastUnit[i] * block.unit[i];
+        }
+        cosine = std::max(-1.0, std::min(1.0, cosine));
+        double junction = cosine >= 1.0 ? block.cruiseSpeed
+                                        : limits.cornerSpeed * std::sqrt((1 + cosine) / (1 - cosine));
+        block.maxEntrySpeed = std::min({junction, block.cruiseSpeed, lastCruiseSpeed});
+    }
+    block.entrySpeed = 0.0;
+    block.exitSpeed = 0.0;
+
+    queue.push_back(block);
+    plannedPosition = target;
+    lastUnit = block.unit;
+    lastCruiseSpeed = block.cruiseSpeed;
+    replan();
+    lock.unlock();
+    cv.notify_all();
+}
+
+void MotionPlanner::replan() {
+    if (queue.empty()) {
+        return;
+    }
+    const double a = limits.acceleration;
+
+    // Backward pass: the queue must always be able to stop at its end.
+    double next = 0.0;
+    for (auto it = queue.rbegin(); it != queue.rend(); ++it) {
+        it->exitSpeed = next;
+        it->entrySpeed = std::min(it->maxEntrySpeed, std::sqrt(next * next + 2 * a * it->length));
+        next = it->entrySpeed;
+    }
+
+    // Forward pass from the speed the emitter has committed to.
+    queue.front().entrySpeed = lockedEntrySpeed;
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+        Block& block = queue[i];
+        double reachable = std::sqrt(block.entrySpeed * block.entrySpeed + 2 * a * block.length);
+        block.exitSpeed = std::min(block.exitSpeed, reachable);
+        if (i + 1 < queue.size()) {
+            queue[i + 1].entrySpeed = block.exitSpeed;
+        }
+    }
+}
+
+MotionPlanner::Interpolator::Interpolator(const std::vector<int64_t>& delta, double entrySpeed,
+                                          double cruiseSpeed, double exitSpeed, double acceleration)
+    : delta(delta),
+      major(0),
+      k(0),
+      length(0.0),
+      stepLength(0.0),
+      entrySpeed(entrySpeed),
+      cruiseSpeed(cruiseSpeed),
+      exitSpeed(exitSpeed),
+      acceleration(acceleration) {
+    double sumSquares = 0.0;
+    for (int64_t d : delta) {
+        major = std::max<int64_t>(major, std::llabs(d));
+        sumSquares += static_cast<double>(d) * d;
+    }
+    length = std::sqrt(sumSquares);
+    stepLength = major > 0 ? length / major : 0.0;
+    error.assign(delta.size(), major / 2);
+}
+
+bool MotionPlanner::Interpolator::next(Tick& tick) {
+    if (k >= major) {
+        return false;
+    }
+    uint64_t bits = 0;
+    for (std::size_t i = 0; i < delta.size(); ++i) {
+        error[i] -= std::llabs(delta[i]);
+        if (error[i] < 0) {
+            error[i] += major;
+            bits |= uint64_t(1) << i;
+        }
+    }
+
+    const double s = (k + 0.5) * stepLength;
+    const double v = std::min({cruiseSpeed,
+                               std::sqrt(entrySpeed * entrySpeed + 2 * acceleration * s),
+                               std::sqrt(exitSpeed * exitSpeed + 2 * acceleration * (length - s))});
+    tick = {bits, std::chrono::nanoseconds(static_cast<int64_t>(1e9 * stepLength / v))};
+    ++k;
+    return true;
+}
+
+std::vector<MotionPlanner::Tick> MotionPlanner::interpolate(const std::vector<int64_t>& delta, double entrySpeed,
+                                                            double cruiseSpeed, double exitSpeed,
+                                                            double acceleration) {
+    std::vector<Tick> ticks;
+    Interpolator interpolator(delta, entrySpeed, cruiseSpeed, exitSpeed, acceleration);
+    Tick tick;
+    while (interpolator.next(tick)) {
+        ticks.push_back(tick);
+    }
+    return ticks;
+}
+
+void MotionPlanner::execute(const Block& block, PreciseTimer::Clock::time_point& deadline) {
+    const uint64_t current = port.lastWritten();
+    uint64_t dirValue = 0;
+    for (std::size_t i = 0; i < axes.size(); ++i) {
+        const uint64_t bit = uint64_t(1) << axes[i].dirBit;
+        if (block.delta[i] == 0) {
+            // Leave idle axes' direction lines where they are.
+            dirValue |= current & bit;
+        } else if ((block.delta[i] > 0) != axes[i].invertDir) {
+            dirValue |= bit;
+        }
+    }
+    // A move from rest starts now; otherwise it continues the previous move's
+    // timeline, so the first tick is one interval after the last one.
+    if (block.entrySpeed <= 0) {
+        deadline = std::max(deadline, PreciseTimer::Clock::now());
+    }
+    auto dirReady = deadline;
+    if ((current & dirMask) != dirValue) {
+        port.writeMasked(dirMask | stepMask, dirValue);
+        dirReady = PreciseTimer::Clock::now() + DIR_SETUP;
+    }
+
+    Interpolator interpolator(block.delta, block.entrySpeed, block.cruiseSpeed, block.exitSpeed,
+                              limits.acceleration);
+    Tick tick;
+    while (interpolator.next(tick)) {
+        uint64_t stepValue = 0;
+        for (std::size_t i = 0; i < axes.size(); ++i) {
+            if (tick.stepBits & (uint64_t(1) << i)) {
+                stepValue |= uint64_t(1) << axes[i].stepBit;
+            }
+        }
+
+        deadline = std::max(deadline + tick.interval, dirReady);
+        timer.sleepUntil(deadline);
+        port.writeMasked(dirMask | stepMask, dirValue | stepValue);
+        timer.sleepFor(pulseWidth);
+        port.writeMasked(dirMask | stepMask, dirValue);
+
+        for (std::size_t i = 0; i < axes.size(); ++i) {
+            if (tick.stepBits & (uint64_t(1) << i)) {
+                emitted[i].fetch_add(block.delta[i] > 0 ? 1 : -1, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+void MotionPlanner::run() {
+    auto deadline = PreciseTimer::Clock::now();
+    while (true) {
+        Block block;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this]() { return !running || !queue.empty(); });
+            if (!running) {
+                return;
+            }
+            block = queue.front();
+            queue.pop_front();
+            // The next block must start at exactly the speed this one ends at.
+            lockedEntrySpeed = block.exitSpeed;
+            busy = true;
+        }
+        cv.notify_all();
+
+        execute(block, deadline);
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            busy = false;
+            if (queue.empty()) {
+                lockedEntrySpeed = 0.0;
+            }
+        }
+        cv.notify_all();
+    }
+}
+
+void MotionPlanner::waitUntilIdle() {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [this]() { return !running || (queue.empty() && !busy); });
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+void MotionPlanner::workerFailed(std::exception_ptr error) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        failure = error;
+        running = false;
+        busy = false;
+        queue.clear();
+    }
+    cv.notify_all();
+}
+
+std::vector<int64_t> MotionPlanner::position() const {
+    std::vector<int64_t> result(axes.size());
+    for (std::size_t i = 0; i < axes.size(); ++i) {
+        result[i] = emitted[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
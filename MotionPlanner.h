@@ -0,0 +1,190 @@
+#ifndef MOTIONPLANNER_H
+#define MOTIONPLANNER_H
+
+#include "DigitalPort.h"
+#include "PreciseTimer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Bit assignment of one axis within the motion DigitalPort.
+ */
+struct MotionAxis {
+    unsigned int stepBit;
+    unsigned int dirBit;
+    bool invertDir = false;
+};
+
+/**
+ * @brief Path limits for MotionPlanner, in steps along the path.
+ */
+struct MotionLimits {
+    double maxSpeed = 10000.0;          ///< steps/s
+    double acceleration = 50000.0;      ///< steps/s^2
+    double cornerSpeed = 500.0;         ///< Speed allowed through a 90 degree corner
+};
+
+/**
+ * @brief Coordinated multi-axis line planner driving step/dir outputs.
+ *
+ * Linear moves are queued and re-planned with look-ahead so that speed is
+ * carried through gentle corners and the queue always ends at rest. An
+ * emitter thread interpolates each move with Bresenham/DDA on the longest
+ * axis and writes the step bits of all axes in a single DigitalPort write per
+ * tick, so axes never drift relative to each other. Each tick is computed
+ * before sleeping to the previous tick's deadline, and the deadline carries
+ * over from one move to the next, so a junction taken at speed has no gap.
+ */
+class MotionPlanner {
+public:
+    /**
+     * @brief One emitted tick, reported by interpolate().
+     */
+    struct Tick {
+        uint64_t stepBits;                  ///< Bit i set if axis i steps
+        std::chrono::nanoseconds interval;  ///< Time since the previous tick
+    };
+
+    /**
+     * @brief Generates the ticks of one move one at a time.
+     */
+    class Interpolator {
+    public:
+        /**
+         * @param delta Signed steps per axis.
+         * @param entrySpeed Path speed at the start of the move.
+         * @param cruiseSpeed Maximum path speed within the move.
+         * @param exitSpeed Path speed at the end of the move.
+         * @param acceleration Path acceleration.
+         */
+        Interpolator(const std::vector<int64_t>& delta, double entrySpeed, double cruiseSpeed, double exitSpeed,
+                     double acceleration);
+
+        /**
+         * @brief Computes the next tick.
+         * @return false once every step of the longest axis has been produced.
+         */
+        bool next(Tick& tick);
+
+    private:
+        std::vector<int64_t> delta;
+        std::vector<int64_t> error;
+        int64_t major;
+        int64_t k;
+        double length;
+        double stepLength;
+        double entrySpeed;
+        double cruiseSpeed;
+        double exitSpeed;
+        double acceleration;
+    };
+
+    /**
+     * @brief Constructs a planner and starts its emitter thread.
+     * @param port Output port holding every axis' STEP and DIR lines.
+     * @param axes Bit assignment per axis.
+     * @param limits Path speed and acceleration limits.
+     * @param queueDepth Maximum number of planned moves; lineTo() blocks when full.
+     * @param pulseWidth STEP high time.
+     * @param rtPriority SCHED_FIFO priority for the emitter, or 0 to leave it unchanged.
+     * @throws std::invalid_argument if there are more than 64 axes, an axis bit is outside
+     *         the port, or a limit is not finite, maxSpeed and acceleration positive
+     *         and cornerSpeed non-negative.
+     */
+    MotionPlanner(DigitalPort& port, const std::vector<MotionAxis>& axes, const MotionLimits& limits = MotionLimits(),
+                  std::size_t queueDepth = 16, std::chrono::nanoseconds pulseWidth = std::chrono::microseconds(2),
+                  int rtPriority = 0);
+
+    /**
+     * @brief Stops the emitter after the current move; queued moves are discarded.
+     */
+    ~MotionPlanner();
+
+    MotionPlanner(const MotionPlanner&) = delete;
+    MotionPlanner& operator=(const MotionPlanner&) = delete;
+
+    /**
+     * @brief Queues a straight line to an absolute position.
+     * @param target Target step position per axis.
+     * @param speed Requested path speed in steps/s (capped by the limits).
+     * @throws std::invalid_argument if target has the wrong number of axes or
+     *         speed is not positive and finite.
+     * @throws The exception that stopped the emitter thread, if a port write failed.
+     */
+    void lineTo(const std::vector<int64_t>& target, double speed);
+
+    /**
+     * @brief Blocks until every queued move has been emitted.
+     * @throws The exception that stopped the emitter thread, if a port write failed.
+     */
+    void waitUntilIdle();
+
+    /**
+     * @brief Returns the emitted position of every axis.
+     */
+    std::vector<int64_t> position() const;
+
+    /**
+     * @brief Expands one move into ticks without touching hardware.
+     * @param delta Signed steps per axis.
+     * @param entrySpeed Path speed at the start of the move.
+     * @param cruiseSpeed Maximum path speed within the move.
+     * @param exitSpeed Path speed at the end of the move.
+     * @param acceleration Path acceleration.
+     * @return One tick per step of the longest axis.
+     */
+    static std::vector<Tick> interpolate(const std::vector<int64_t>& delta, double entrySpeed,
+                                         double cruiseSpeed, double exitSpeed, double acceleration);
+
+private:
+    struct Block {
+        std::vector<int64_t> delta;
+        std::vector<double> unit;       ///< Direction unit vector
+        double length;                  ///< Euclidean length in steps
+        double cruiseSpeed;
+        double maxEntrySpeed;           ///< Junction limit with the previous block
+        double entrySpeed;
+        double exitSpeed;
+    };
+
+    void replan();
+    void run();
+    void workerFailed(std::exception_ptr error);
+    void execute(const Block& block, PreciseTimer::Clock::time_point& deadline);
+
+    DigitalPort& port;
+    std::vector<MotionAxis> axes;
+    MotionLimits limits;
+    std::size_t queueDepth;
+    std::chrono::nanoseconds pulseWidth;
+    PreciseTimer timer;
+
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<Block> queue;
+    std::vector<int64_t> plannedPosition;
+    std::vector<double> lastUnit;
+    double lastCruiseSpeed;
+    double lockedEntrySpeed;
+    bool busy;
+    bool running;
+    std::exception_ptr failure;
+
+    std::unique_ptr<std::atomic<int64_t>[]> emitted;
+    uint64_t dirMask;
+    uint64_t stepMask;
+
+    std::thread worker;
+};
+
+#endif // MOTIONPLANNER_H
@@ -0,0 +1,196 @@
+#include "MultiplexDisplay.h"
+
+#include <stdexcept>
+
+MultiplexDisplay::MultiplexDisplay(DigitalPort& port, const DisplayWiring& wiring, unsigned int frameRate,
+                                   int rtPriority)
+    : port(port),
+      wiring(wiring),
+      slot(0),
+      blank(0),
+      mask(0),
+      framebuffer(wiring.digitBits.size(), 0),
+      patterns(wiring.digitBits.size(), 0),
+      brightness(wiring.digitBits.size(), 255),
+      generation(0),
+      running(true) {
+    if (wiring.segmentBits.empty() || wiring.digitBits.empty() || frameRate == 0) {
+        throw std::invalid_argument("Display needs segments, digits and a non-zero frame rate");
+    }
+    for (unsigned int bit : wiring.segmentBits) {
+        if (bit >= port.width()) {
+            throw std::invalid_argument("Display segment bit outside DigitalPort");
+        }
+        mask |= uint64_t(1) << bit;
+        if (wiring.segmentActiveLow) {
+            blank |= uint64_t(1) << bit;
+        }
+    }
+    for (unsigned int bit : wiring.digitBits) {
+        if (bit >= port.width()) {
+            throw std::invalid_argument("Display digit bit outside DigitalPort");
+        }
+        mask |= uint64_t(1) << bit;
+        if (wiring.digitActiveLow) {
+            blank |= uint64_t(1) << bit;
+        }
+    }
+    slot = std::chrono::nanoseconds(1000000000ULL / (uint64_t(frameRate) * wiring.digitBits.size()));
+    for (std::size_t digit = 0; digit < patterns.size(); ++digit) {
+        patterns[digit] = computePattern(digit, 0);
+    }
+    port.writeMasked(mask, blank);
+
+    worker = PreciseTimer::startThread(rtPriority, [this]() { run(); },
+                                       [this](std::exception_ptr error) { workerFailed(error); });
+}
+
+MultiplexDisplay::~MultiplexDisplay() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+    }
+    worker.join();
+    try {
+        port.writeMasked(mask, blank);
+    } catch (...) {
+        // Destructors must not throw.
+    }
+}
+
+uint64_t MultiplexDisplay::computePattern(std::size_t digit, uint64_t segments) const {
+    uint64_t value = blank;
+    for (std::size_t i = 0; i < wiring.segmentBits.size(); ++i) {
+        if (segments & (uint64_t(1) << i)) {
+            value ^= uint64_t(1) << wiring.segmentBits[i];
+        }
+    }
+    value ^= uint64_t(1) << wiring.digitBits[digit];
+    return value;
+}
+
+void MultiplexDisplay::setDigit(std::size_t digit, uint64_t segments) {
+    if (digit >= framebuffer.size()) {
+        throw std::out_of_range("Display digit out of range");
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    if (framebuffer[digit] != segments) {
+        framebuffer[digit] = segments;
+        patterns[digit] = computePattern(digit, segments);
+        ++generation;
+    }
+}
+
+void MultiplexDisplay::setBrightness(std::size_t digit, uint8_t level) {
+    if (digit >= brightness.size()) {
+        throw std::out_of_range("Display digit out of range");
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    brightness[digit] = level;
+    ++generation;
+}
+
+void MultiplexDisplay::setBrightness(uint8_t level) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    brightness.assign(brightness.size(), level);
+    ++generation;
+}
+
+void MultiplexDisplay::print(const char* text) {
+    for (std::size_t digit = 0; digit < framebuffer.size(); ++digit) {
+        char c = (text && *text) ? *text++ : ' ';
+        setDigit(digit, sevenSegment(c));
+    }
+}
+
+MultiplexDisplay::RefreshStats MultiplexDisplay::stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return refreshStats;
+}
+
+void MultiplexDisplay::workerFailed(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mtx);
+    failure = error;
+    running = false;
+}
+
+uint64_t MultiplexDisplay::sevenSegment(char c) {
+    // Bits 0-6 are segments a-g.
+    static const uint8_t digits[16] = {
+        0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07,
+        0x7F, 0x6F, 0x77, 0x7C, 0x39, 0x5E, 0x79, 0x71,
+    };
+    if (c >= '0' && c <= '9') {
+        return digits[c - '0'];
+    }
+    if (c >= 'A' && c <= 'F') {
+        return digits[10 + c - 'A'];
+    }
+    if (c >= 'a' && c <= 'f') {
+        return digits[10 + c - 'a'];
+    }
+    if (c == '-') {
+        return 0x40;
+    }
+    return 0x00;
+}
+
+void MultiplexDisplay::run() {
+    std::vector<uint64_t> active;
+    std::vector<std::chrono::nanoseconds> onTime;
+    unsigned long seen = ~0UL;
+    auto deadline = PreciseTimer::Clock::now();
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!running) {
+                return;
+            }
+            // Copy patterns only when the framebuffer or brightness changed.
+            if (generation != seen) {
+                active = patterns;
+                onTime.resize(brightness.size());
+                for (std::size_t digit = 0; digit < brightness.size(); ++digit) {
+                    onTime[digit] = slot * brightness[digit] / 255;
+                }
+                seen = generation;
+            }
+        }
+
+        std::chrono::nanoseconds worst(0);
+        std::chrono::nanoseconds total(0);
+        for (std::size_t digit = 0; digit < active.size(); ++digit) {
+            timer.sleepUntil(deadline);
+            auto late = std::chrono::duration_cast<std::chrono::nanoseconds>(PreciseTimer::Clock::now() - deadline);
+            worst = std::max(worst, late);
+            total += late;
+
+            if (onTime[digit].count() > 0) {
+                port.writeMasked(mask, active[digit]);
+                if (onTime[digit] < slot) {
+                    timer.sleepUntil(deadline + onTime[digit]);
+                    port.writeMasked(mask, blank);
+                }
+            } else {
+                port.writeMasked(mask, blank);
+            }
+            deadline += slot;
+        }
+
+        std::lock_guard<std::mutex> lock(mtx);
+        ++refreshStats.frames;
+        refreshStats.slots += active.size();
+        refreshStats.maxLateness = std::max(refreshStats.maxLateness, worst);
+        refreshStats.totalLateness += total;
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef MULTIPLEXDISPLAY_H
+#define MULTIPLEXDISPLAY_H
+
+#include "DigitalPort.h"
+#include "PreciseTimer.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Port bit assignment for a multiplexed display.
+ *
+ * For a 7-segment display, segments are a-g (and dp) and digits are the
+ * common lines; for an LED matrix, segments are columns and digits are rows.
+ */
+struct DisplayWiring {
+    std::vector<unsigned int> segmentBits;  ///< Port bit of each segment / column
+    std::vector<unsigned int> digitBits;    ///< Port bit of each digit / row select
+    bool segmentActiveLow = false;
+    bool digitActiveLow = false;
+};
+
+/**
+ * @brief Refresh engine for multiplexed 7-segment displays and LED matrices.
+ *
+ * Keeps a framebuffer of segment bits per digit and a precomputed port value
+ * per digit, so each digit slot is a single bulk DigitalPort write. Only
+ * digits whose framebuffer entry changes are recomputed. A dedicated thread
+ * cycles the digits at absolute PreciseTimer deadlines; brightness is set per
+ * digit by the fraction of the slot the digit stays lit. If a port write fails,
+ * the thread stops and the setters rethrow its exception.
+ */
+class MultiplexDisplay {
+public:
+    /**
+     * @brief Slot timing lateness collected by the refresh thread.
+     */
+    struct RefreshStats {
+        unsigned long frames = 0;
+        unsigned long slots = 0;
+        std::chrono::nanoseconds maxLateness{0};
+        std::chrono::nanoseconds totalLateness{0};
+    };
+
+    /**
+     * @brief Constructs the engine and starts refreshing a blank display.
+     * @param port Output port holding every segment and digit line.
+     * @param wiring Bit assignment within the port.
+     * @param frameRate Full-display refreshes per second.
+     * @param rtPriority SCHED_FIFO priority for the refresh thread, or 0 to leave it unchanged.
+     * @throws std::invalid_argument if the wiring is empty or outside the port.
+     */
+    MultiplexDisplay(DigitalPort& port, const DisplayWiring& wiring, unsigned int frameRate = 200,
+                     int rtPriority = 0);
+
+    /**
+     * @brief Stops refreshing and blanks the display.
+     */
+    ~MultiplexDisplay();
+
+    MultiplexDisplay(const MultiplexDisplay&) = delete;
+    MultiplexDisplay& operator=(const MultiplexDisplay&) = delete;
+
+    /**
+     * @brief Sets the lit segments of one digit (bit i = segmentBits[i]).
+     * @throws std::out_of_range if digit is outside the display.
+     */
+    void setDigit(std::size_t digit, uint64_t segments);
+
+    /**
+     * @brief Sets the brightness of one digit (0 = off, 255 = full slot).
+     * @throws std::out_of_range if digit is outside the display.
+     */
+    void setBrightness(std::size_t digit, uint8_t level);
+
+    /**
+     * @brief Sets the brightness of every digit.
+     */
+    void setBrightness(uint8_t level);
+
+    /**
+     * @brief Displays a string on a 7-segment display, one character per digit.
+     */
+    void print(const char* text);
+
+    RefreshStats stats() const;
+
+    /**
+     * @brief Returns a-g/dp segment bits for a character (0-9, A-F, '-', ' ').
+     */
+    static uint64_t sevenSegment(char c);
+
+private:
+    uint64_t computePattern(std::size_t digit, uint64_t segments) const;
+    void run();
+    void workerFailed(std::exception_ptr error);
+
+    DigitalPort& port;
+    DisplayWiring wiring;
+    std::chrono::nanoseconds slot;
+    uint64_t blank;
+    uint64_t mask;
+    PreciseTimer timer;
+
+    mutable std::mutex mtx;
+    std::vector<uint64_t> framebuffer;
+    std::vector<uint64_t> patterns;
+    std::vector<uint8_t> brightness;
+    unsigned long generation;
+    bool running;
+    std::exception_ptr failure;
+    RefreshStats refreshStats;
+
+    std::thread worker;
+};
+
+#endif // MULTIPLEXDISPLAY_H
@@ -0,0 +1,279 @@
+#include "OneWire.h"
+
+#include <stdexcept>
+#include <string>
+
+using std::chrono::microseconds;
+
+namespace {
+// Standard-speed timings (Maxim AN126). Slot times are offsets from the
+// falling edge that opens the slot, so the cost of each line write is not
+// added on top of the next delay.
+constexpr microseconds RESET_LOW(480);
+constexpr microseconds PRESENCE_SAMPLE(70);
+constexpr microseconds RESET_RECOVERY(410);
+constexpr microseconds WRITE1_RELEASE(6);
+constexpr microseconds WRITE0_RELEASE(60);
+constexpr microseconds READ_RELEASE(3);
+constexpr microseconds READ_SAMPLE(10);
+constexpr microseconds SLOT(70);
+// Slaves sample a written bit, and stop driving a read bit, 15 us into the slot.
+constexpr microseconds SLOT_WINDOW(15);
+constexpr int SEARCH_RETRIES = 3;
+
+constexpr uint8_t CMD_SEARCH_ROM = 0xF0;
+constexpr uint8_t CMD_MATCH_ROM = 0x55;
+constexpr uint8_t CMD_SKIP_ROM = 0xCC;
+constexpr uint8_t CMD_CONVERT_T = 0x44;
+constexpr uint8_t CMD_READ_SCRATCHPAD = 0xBE;
+} // namespace
+
+OneWire::OneWire(int pin) : line(pin, "OneWire"), timer(std::chrono::microseconds(200)), violations(0) {}
+
+bool OneWire::resetUnlocked() {
+    const auto start = PreciseTimer::now();
+    line.pullLow();
+    timer.sleepUntil(start + RESET_LOW);
+    line.release();
+    const auto released = PreciseTimer::now();
+    timer.sleepUntil(released + PRESENCE_SAMPLE);
+    bool present = !line.read();
+    timer.sleepUntil(released + PRESENCE_SAMPLE + RESET_RECOVERY);
+    return present;
+}
+
+void OneWire::checkWindow(PreciseTimer::Clock::time_point slot, const char* what) {
+    if (PreciseTimer::now() - slot > SLOT_WINDOW) {
+        violations.fetch_add(1, std::memory_order_relaxed);
+        throw std::runtime_error(std::string("1-Wire ") + what + " slot missed its 15 us window");
+    }
+}
+
+void OneWire::writeBitUnlocked(bool bit) {
+    const auto slot = PreciseTimer::now();
+    line.pullLow();
+    timer.sleepUntil(slot + (bit ? WRITE1_RELEASE : WRITE0_RELEASE));
+    line.release();
+    if (bit) {
+        // Released after the slave samples, a 1 would be read as 0.
+        checkWindow(slot, "write");
+    }
+    timer.sleepUntil(slot + SLOT);
+}
+
+bool OneWire::readBitUnlocked() {
+    const auto slot = PreciseTimer::now();
+    line.pullLow();
+    timer.sleepUntil(slot + READ_RELEASE);
+    line.release();
+    timer.sleepUntil(slot + READ_SAMPLE);
+    bool bit = line.read();
+    // Measured after the read returns, so this bounds the sample time from above.
+    checkWindow(slot, "read");
+    timer.sleepUntil(slot + SLOT);
+    return bit;
+}
+
+void OneWire::writeByteUnlocked(uint8_t byte) {
+    for (int i = 0; i < 8; ++i) {
+        writeBitUnlocked((byte >> i) & 0x1);
+    }
+}
+
+uint8_t OneWire::readByteUnlocked() {
+    uint8_t byte = 0;
+    for (int i = 0; i < 8; ++i) {
+        if (readBitUnlocked()) {
+            byte |= static_cast<uint8_t>(1u << i);
+        }
+    }
+    return byte;
+}
+
+void OneWire::selectUnlocked(uint64_t rom) {
+    writeByteUnlocked(CMD_MATCH_ROM);
+    for (int i = 0; i < 8; ++i) {
+        writeByteUnlocked(static_cast<uint8_t>(rom >> (8 * i)));
+    }
+}
+
+bool OneWire::reset() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return resetUnlocked();
+}
+
+void OneWire::writeBit(bool bit) {
+    std::lock_guard<std::mutex> lock(mtx);
+    writeBitUnlocked(bit);
+}
+
+bool OneWire::readBit() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return readBitUnlocked();
+}
+
+void OneWire::writeByte(uint8_t byte) {
+    std::lock_guard<std::mutex> lock(mtx);
+    writeByteUnlocked(byte);
+}
+
+uint8_t OneWire::readByte() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return readByteUnlocked();
+}
+
+void OneWire::select(uint64_t rom) {
+    std::lock_guard<std::mutex> lock(mtx);
+    selectUnlocked(rom);
+}
+
+void OneWire::skip() {
+    std::lock_guard<std::mutex> lock(mtx);
+    writeByteUnlocked(CMD_SKIP_ROM);
+}
+
+unsigned long OneWire::timingViolations() const {
+    return violations.load(std::memory_order_relaxed);
+}
+
+uint8_t OneWire::crc8(const uint8_t* data, std::size_t length) {
+    uint8_t crc = 0;
+    for (std::size_t i = 0; i < length; ++i) {
+        uint8_t byte = data[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            bool mix = (crc ^ byte) & 0x1;
+            crc >>= 1;
+            if (mix) {
+                crc ^= 0x8C;
+            }
+            byte >>= 1;
+        }
+    }
+    return crc;
+}
+
+bool OneWire::searchNext(uint64_t& rom, int& lastDiscrepancy, bool& lastDevice) {
+    if (lastDevice || !resetUnlocked()) {
+        return false;
+    }
+    writeByteUnlocked(CMD_SEARCH_ROM);
+
+    int lastZero = 0;
+    for (int bit = 1; bit <= 64; ++bit) {
+        bool idBit = readBitUnlocked();
+        bool complement = readBitUnlocked();
+        if (idBit && complement) {
+            // No device participating.
+            return false;
+        }
+
+        bool direction;
+        if (idBit != complement) {
+            direction = idBit;
+        } else if (bit < lastDiscrepancy) {
+            direction = (rom >> (bit - 1)) & 0x1;
+        } else {
+            direction = (bit == lastDiscrepancy);
+        }
+        if (idBit == complement && !direction) {
+            lastZero = bit;
+        }
+
+        const uint64_t mask = uint64_t(1) << (bit - 1);
+        rom = direction ? (rom | mask) : (rom & ~mask);
+        writeBitUnlocked(direction);
+    }
+
+    lastDiscrepancy = lastZero;
+    lastDevice = (lastDiscrepancy == 0);
+    return true;
+}
+
+std::vector<uint64_t> OneWire::search(uint8_t familyCode) {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<uint64_t> roms;
+
+    // Seeding the family code as the low byte with a discrepancy past it
+    // makes the search start at that family (Maxim AN187 "family skip").
+    uint64_t rom = familyCode;
+    int lastDiscrepancy = familyCode ? 64 : 0;
+    bool lastDevice = false;
+
+    int failures = 0;
+    while (true) {
+        // A pass that misses a slot window is repeated from the same state.
+        const uint64_t savedRom = rom;
+        const int savedDiscrepancy = lastDiscrepancy;
+        bool found;
+        try {
+            found = searchNext(rom, lastDiscrepancy, lastDevice);
+        } catch (const std::runtime_error&) {
+            if (++failures > SEARCH_RETRIES) {
+                throw;
+            }
+            rom = savedRom;
+            lastDiscrepancy = savedDiscrepancy;
+            continue;
+        }
+        if (!found) {
+            break;
+        }
+        uint8_t bytes[8];
+        for (int i = 0; i < 8; ++i) {
+            bytes[i] = static_cast<uint8_t>(rom >> (8 * i));
+        }
+        if (familyCode && bytes[0] != familyCode) {
+            break;
+        }
+        if (crc8(bytes, 7) == bytes[7]) {
+            roms.push_back(rom);
+        }
+        // The retry budget is per ROM, not per search.
+        failures = 0;
+    }
+    return roms;
+}
+
+void OneWire::startConversionAll() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!resetUnlocked()) {
+        throw std::runtime_error("No 1-Wire presence pulse");
+    }
+    writeByteUnlocked(CMD_SKIP_ROM);
+    writeByteUnlocked(CMD_CONVERT_T);
+}
+
+double OneWire::readTemperature(uint64_t rom) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!resetUnlocked()) {
+        throw std::runtime_error("No 1-Wire presence pulse");
+    }
+    selectUnlocked(rom);
+    writeByteUnlocked(CMD_READ_SCRATCHPAD);
+
+    uint8_t scratchpad[9];
+    for (uint8_t& byte : scratchpad) {
+        byte = readByteUnlocked();
+    }
+    if (crc8(scratchpad, 8) != scratchpad[8]) {
+        throw std::runtime_error("DS18B20 scratchpad CRC mismatch");
+    }
+    int16_t raw = static_cast<int16_t>(scratchpad[0] | (scratchpad[1] << 8));
+    return raw / 16.0;
+}
+
+std::map<uint64_t, double> OneWire::sweep(const std::vector<uint64_t>& roms,
+                                          std::chrono::milliseconds conversionTime) {
+    std::map<uint64_t, double> temperatures;
+    startConversionAll();
+    // Sleep without holding the bus lock; the conversion runs on the sensors.
+    timer.sleepFor(conversionTime);
+    for (uint64_t rom : roms) {
+        try {
+            temperatures[rom] = readTemperature(rom);
+        } catch (const std::runtime_error&) {
+            // Leave failed sensors out of this sweep.
+        }
+    }
+    return temperatures;
+}
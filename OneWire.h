@@ -0,0 +1,123 @@
+#ifndef ONEWIRE_H
+#define ONEWIRE_H
+
+#include "OpenDrainPin.h"
+#include "PreciseTimer.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Userspace 1-Wire bus master on an open-drain line.
+ *
+ * Implements reset/presence and read/write slots with the standard-speed
+ * timings, ROM search, and DS18B20 helpers. Temperature sweeps start a
+ * conversion on every sensor at once with SKIP ROM, so a full sweep costs one
+ * conversion time regardless of how many sensors are on the bus.
+ *
+ * Slot timing is only as good as the calling thread's scheduling; run sweeps
+ * from a thread set up with PreciseTimer::setRealtimePriority(). Every slot
+ * is timed from its opening edge and checked against the 15 us window in
+ * which slaves sample; a slot that misses it throws instead of returning a
+ * wrong bit, and a ROM search repeats the affected pass.
+ */
+class OneWire {
+public:
+    /**
+     * @brief Constructs a 1-Wire master.
+     * @param pin GPIO pin for the data line (external pull-up required).
+     */
+    explicit OneWire(int pin);
+
+    /**
+     * @brief Issues a reset pulse.
+     * @return true if at least one device answered with a presence pulse.
+     */
+    bool reset();
+
+    /**
+     * @throws std::runtime_error if a 1 was released outside the slave's sampling window.
+     */
+    void writeBit(bool bit);
+
+    /**
+     * @throws std::runtime_error if the bit was sampled outside the slave's drive window.
+     */
+    bool readBit();
+    void writeByte(uint8_t byte);
+    uint8_t readByte();
+
+    /**
+     * @brief Addresses one device (MATCH ROM). Call after reset().
+     */
+    void select(uint64_t rom);
+
+    /**
+     * @brief Addresses every device at once (SKIP ROM). Call after reset().
+     */
+    void skip();
+
+    /**
+     * @brief Enumerates the ROM codes of all devices on the bus.
+     * @param familyCode Restrict the search to this family, or 0 for all devices.
+     * @return ROM codes with valid CRC, least significant byte first on the wire.
+     * @throws std::runtime_error if a pass keeps missing its slot timing.
+     */
+    std::vector<uint64_t> search(uint8_t familyCode = 0);
+
+    /**
+     * @brief Starts a temperature conversion on every DS18B20 on the bus.
+     * @throws std::runtime_error if no device answers the reset.
+     */
+    void startConversionAll();
+
+    /**
+     * @brief Reads the last converted temperature from one DS18B20.
+     * @param rom Sensor ROM code.
+     * @return Temperature in degrees Celsius.
+     * @throws std::runtime_error on missing presence or scratchpad CRC mismatch.
+     */
+    double readTemperature(uint64_t rom);
+
+    /**
+     * @brief Converts all sensors in parallel, waits once, then reads each one.
+     * @param roms Sensors to read.
+     * @param conversionTime Worst-case conversion time for the configured resolution.
+     * @return Temperatures by ROM code; sensors that fail to read are omitted.
+     */
+    std::map<uint64_t, double> sweep(const std::vector<uint64_t>& roms,
+                                     std::chrono::milliseconds conversionTime = std::chrono::milliseconds(750));
+
+    /**
+     * @brief Returns the number of slots that missed their timing window.
+     */
+    unsigned long timingViolations() const;
+
+    /**
+     * @brief Dallas/Maxim CRC-8 over a byte buffer.
+     */
+    static uint8_t crc8(const uint8_t* data, std::size_t length);
+
+    static constexpr uint8_t DS18B20_FAMILY = 0x28;
+
+private:
+    bool resetUnlocked();
+    void checkWindow(PreciseTimer::Clock::time_point slot, const char* what);
+    void writeBitUnlocked(bool bit);
+    bool readBitUnlocked();
+    void writeByteUnlocked(uint8_t byte);
+    uint8_t readByteUnlocked();
+    void selectUnlocked(uint64_t rom);
+    bool searchNext(uint64_t& rom, int& lastDiscrepancy, bool& lastDevice);
+
+    std::mutex mtx;
+    OpenDrainPin line;
+    PreciseTimer timer;
+    std::atomic<unsigned long> violations;
+};
+
+#endif // ONEWIRE_H
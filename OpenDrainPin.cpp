@@ -0,0 +1,72 @@
+#include "OpenDrainPin.h"
+
+#include <stdexcept>
+
+OpenDrainPin::OpenDrainPin(int pin, const std::string& name, const std::string& chipName)
+    : chip(nullptr), line(nullptr), driving(false) {
+    chip = gpiod_chip_open_by_name(chipName.c_str());
+    if (!chip) {
+        throw std::runtime_error("Failed to open GPIO chip " + chipName);
+    }
+
+    line = gpiod_chip_get_line(chip, static_cast<unsigned int>(pin));
+    if (!line) {
+        gpiod_chip_close(chip);
+        throw std::runtime_error("Failed to get GPIO line " + std::to_string(pin));
+    }
+
+    gpiod_line_request_config config{};
+    config.consumer = name.c_str();
+    config.request_type = GPIOD_LINE_REQUEST_DIRECTION_OUTPUT;
+    config.flags = GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN;
+    // Requested released (1) so the bus is not disturbed.
+    if (gpiod_line_request(line, &config, 1) < 0) {
+        gpiod_chip_close(chip);
+        throw std::runtime_error("Failed to request open-drain GPIO line " + std::to_string(pin));
+    }
+}
+
+OpenDrainPin::~OpenDrainPin() {
+    gpiod_line_release(line);
+    gpiod_chip_close(chip);
+}
+
+void OpenDrainPin::set(bool level) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (driving == !level) {
+        return;
+    }
+    if (gpiod_line_set_value(line, level ? 1 : 0) < 0) {
+        throw std::runtime_error("Failed to write open-drain GPIO line");
+    }
+    driving = !level;
+}
+
+void OpenDrainPin::pullLow() {
+    set(false);
+}
+
+void OpenDrainPin::release() {
+    set(true);
+}
+
+void OpenDrainPin::write(bool level) {
+    set(level);
+}
+
+bool OpenDrainPin::read() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (driving) {
+        return false;
+    }
+    const int value = gpiod_line_get_value(line);
+    if (value < 0) {
+        throw std::runtime_error("Failed to read open-drain GPIO line");
+    }
+    return value != 0;
+}
+
+bool OpenDrainPin::isDriving() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return driving;
+}
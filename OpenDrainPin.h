@@ -0,0 +1,76 @@
+#ifndef OPENDRAINPIN_H
+#define OPENDRAINPIN_H
+
+#include <gpiod.h>
+
+#include <mutex>
+#include <string>
+
+/**
+ * @brief Open-drain line using the GPIO driver's native open-drain mode.
+ *
+ * The line is requested once as an open-drain output: writing 0 pulls it
+ * low, writing 1 turns the driver off so the external pull-up (or another
+ * device) sets the level. A transition is therefore one value write, with
+ * the line owned throughout. Reads return the sensed pad level, which GPIO
+ * drivers report for open-drain outputs.
+ */
+class OpenDrainPin {
+public:
+    /**
+     * @brief Constructs an open-drain line, initially released.
+     * @param pin GPIO line offset.
+     * @param name Consumer name used when requesting the line.
+     * @param chipName GPIO chip holding the line.
+     * @throws std::runtime_error if the chip or line cannot be requested.
+     */
+    OpenDrainPin(int pin, const std::string& name = "OpenDrainPin", const std::string& chipName = "gpiochip0");
+
+    /**
+     * @brief Releases the line and closes the chip.
+     */
+    ~OpenDrainPin();
+
+    OpenDrainPin(const OpenDrainPin&) = delete;
+    OpenDrainPin& operator=(const OpenDrainPin&) = delete;
+
+    /**
+     * @brief Actively drives the line low.
+     * @throws std::runtime_error if the write fails.
+     */
+    void pullLow();
+
+    /**
+     * @brief Releases the line so the pull-up (or another device) sets its level.
+     * @throws std::runtime_error if the write fails.
+     */
+    void release();
+
+    /**
+     * @brief Sets the line: true releases it, false pulls it low.
+     * @param level Desired level.
+     */
+    void write(bool level);
+
+    /**
+     * @brief Reads the line level.
+     * @return false while this side is pulling low, otherwise the sensed level.
+     * @throws std::runtime_error if the read fails.
+     */
+    bool read();
+
+    /**
+     * @brief Returns true while this side is driving the line low.
+     */
+    bool isDriving() const;
+
+private:
+    void set(bool level);
+
+    mutable std::mutex mtx;
+    gpiod_chip* chip;
+    gpiod_line* line;
+    bool driving;
+};
+
+#endif // OPENDRAINPIN_H
@@ -0,0 +1,93 @@
+#include "Parallel8080Bus.h"
+
+#include <stdexcept>
+
+Parallel8080Bus::Parallel8080Bus(DigitalPort& port, unsigned int dataWidth)
+    : port(port),
+      width(dataWidth),
+      wr(uint64_t(1) << dataWidth),
+      dc(uint64_t(1) << (dataWidth + 1)),
+      cs(uint64_t(1) << (dataWidth + 2)),
+      mask((uint64_t(1) << (dataWidth + 3)) - 1),
+      control(0),
+      strobeCount(0) {
+    if (dataWidth != 8 && dataWidth != 16) {
+        throw std::invalid_argument("8080 bus width must be 8 or 16");
+    }
+    if (port.width() < dataWidth + 3) {
+        throw std::invalid_argument("DigitalPort too narrow for 8080 bus");
+    }
+    // Idle: WR high, CS deasserted.
+    port.writeMasked(mask, wr | cs);
+}
+
+void Parallel8080Bus::begin(uint64_t dcLevel) {
+    // Select the chip with D/C already set up before the first WR edge.
+    control = dcLevel;
+    port.writeMasked(mask, control | wr);
+}
+
+void Parallel8080Bus::end() {
+    port.writeMasked(mask, wr | cs);
+}
+
+void Parallel8080Bus::strobe(uint64_t word) {
+    port.writeMasked(mask, control | word);
+    port.writeMasked(mask, control | word | wr);
+    ++strobeCount;
+}
+
+void Parallel8080Bus::writeCommand(uint8_t command) {
+    std::lock_guard<std::mutex> lock(mtx);
+    begin(0);
+    strobe(command);
+    end();
+}
+
+void Parallel8080Bus::writeData(const uint8_t* data, std::size_t length) {
+    std::lock_guard<std::mutex> lock(mtx);
+    begin(dc);
+    for (std::size_t i = 0; i < length; ++i) {
+        strobe(data[i]);
+    }
+    end();
+}
+
+void Parallel8080Bus::writePixels(const uint16_t* pixels, std::size_t count) {
+    std::lock_guard<std::mutex> lock(mtx);
+    begin(dc);
+    if (width == 16) {
+        for (std::size_t i = 0; i < count; ++i) {
+            strobe(pixels[i]);
+        }
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            strobe(pixels[i] >> 8);
+            strobe(pixels[i] & 0xFF);
+        }
+    }
+    end();
+}
+
+void Parallel8080Bus::fillPixels(uint16_t pixel, std::size_t count) {
+    std::lock_guard<std::mutex> lock(mtx);
+    begin(dc);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (width == 16) {
+            strobe(pixel);
+        } else {
+            strobe(pixel >> 8);
+            strobe(pixel & 0xFF);
+        }
+    }
+    end();
+}
+
+unsigned long Parallel8080Bus::strobes() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return strobeCount;
+}
+
+unsigned int Parallel8080Bus::dataWidth() const {
+    return width;
+}
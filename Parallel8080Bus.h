@@ -0,0 +1,75 @@
+#ifndef PARALLEL8080BUS_H
+#define PARALLEL8080BUS_H
+
+#include "DigitalPort.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @brief Intel 8080-style write-only parallel bus on a DigitalPort.
+ *
+ * The port holds D0-D7 (8-bit) or D0-D15 (16-bit) in its low bits followed
+ * by WR, D/C and CS (active low), in that order. Every bus word costs two
+ * bulk port writes: data with WR low, then WR high to latch on the rising edge.
+ * Each call asserts CS together with D/C before its first word and
+ * deasserts it after the last, so the bus is idle (WR and CS high) between
+ * calls and can be shared with other devices.
+ */
+class Parallel8080Bus {
+public:
+    /**
+     * @brief Constructs a bus.
+     * @param port Output port laid out as described above.
+     * @param dataWidth 8 or 16.
+     * @throws std::invalid_argument if the width or port size does not fit.
+     */
+    Parallel8080Bus(DigitalPort& port, unsigned int dataWidth = 8);
+
+    /**
+     * @brief Sends a command byte (D/C low).
+     */
+    void writeCommand(uint8_t command);
+
+    /**
+     * @brief Sends parameter or data bytes (D/C high), one byte per bus word.
+     */
+    void writeData(const uint8_t* data, std::size_t length);
+
+    /**
+     * @brief Streams 16-bit pixels (D/C high), as one word each on a 16-bit bus
+     *        or high byte then low byte on an 8-bit bus.
+     */
+    void writePixels(const uint16_t* pixels, std::size_t count);
+
+    /**
+     * @brief Streams the same pixel repeatedly (fills).
+     */
+    void fillPixels(uint16_t pixel, std::size_t count);
+
+    /**
+     * @brief Returns the number of WR strobes issued.
+     */
+    unsigned long strobes() const;
+
+    unsigned int dataWidth() const;
+
+private:
+    void begin(uint64_t dcLevel);
+    void end();
+    void strobe(uint64_t word);
+
+    DigitalPort& port;
+    unsigned int width;
+    uint64_t wr;
+    uint64_t dc;
+    uint64_t cs;
+    uint64_t mask;
+    uint64_t control;       ///< D/C level for the current transfer; CS is low whenever it is used
+
+    mutable std::mutex mtx;
+    unsigned long strobeCount;
+};
+
+#endif // PARALLEL8080BUS_H
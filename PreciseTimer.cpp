@@ -0,0 +1,72 @@
+#include "PreciseTimer.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+PreciseTimer::PreciseTimer(std::chrono::nanoseconds spinThreshold)
+    : spinThreshold(spinThreshold) {}
+
+PreciseTimer::Clock::time_point PreciseTimer::now() {
+    return Clock::now();
+}
+
+void PreciseTimer::sleepUntil(Clock::time_point deadline) const {
+    auto sleepDeadline = deadline - spinThreshold;
+    if (Clock::now() < sleepDeadline) {
+        std::this_thread::sleep_until(sleepDeadline);
+    }
+    while (Clock::now() < deadline) {
+        // Spin for the final stretch; the scheduler cannot wake us this precisely.
+    }
+}
+
+void PreciseTimer::sleepFor(std::chrono::nanoseconds duration) const {
+    sleepUntil(Clock::now() + duration);
+}
+
+void PreciseTimer::setRealtimePriority(int priority) {
+    sched_param param{};
+    param.sched_priority = priority;
+    int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (rc != 0) {
+        throw std::runtime_error("Failed to set real-time priority: " + std::string(std::strerror(rc)));
+    }
+}
+
+std::thread PreciseTimer::startThread(int rtPriority, std::function<void()> body,
+                                      std::function<void(std::exception_ptr)> onError) {
+    std::promise<void> started;
+    std::future<void> startedFuture = started.get_future();
+    // The promise moves into the thread, so it outlives set_value() however
+    // quickly the caller returns.
+    std::thread thread([rtPriority, started = std::move(started), body = std::move(body),
+                        onError = std::move(onError)]() mutable {
+        try {
+            if (rtPriority > 0) {
+                setRealtimePriority(rtPriority);
+            }
+        } catch (...) {
+            started.set_exception(std::current_exception());
+            return;
+        }
+        started.set_value();
+        try {
+            body();
+        } catch (...) {
+            onError(std::current_exception());
+        }
+    });
+    try {
+        startedFuture.get();
+    } catch (...) {
+        thread.join();
+        throw;
+    }
+    return thread;
+}
@@ -0,0 +1,72 @@
+#ifndef PRECISETIMER_H
+#define PRECISETIMER_H
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <thread>
+
+/**
+ * @brief Hybrid sleep/spin timer for bit-banged protocols.
+ *
+ * Sleeps through the bulk of a wait and busy-spins the final stretch so that
+ * deadlines are met with microsecond accuracy instead of scheduler granularity.
+ * All deadlines are expressed on the monotonic clock.
+ */
+class PreciseTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Constructs a timer.
+     * @param spinThreshold Waits shorter than this are busy-spun entirely.
+     */
+    explicit PreciseTimer(std::chrono::nanoseconds spinThreshold = std::chrono::microseconds(100));
+
+    /**
+     * @brief Returns the current monotonic time that deadlines are measured against.
+     *
+     * Components that derive deadlines from the current time read it here
+     * rather than from Clock, so the tests can run them on a virtual clock.
+     */
+    static Clock::time_point now();
+
+    /**
+     * @brief Blocks until the given monotonic deadline has passed.
+     * @param deadline Absolute deadline; returns immediately if already past.
+     */
+    void sleepUntil(Clock::time_point deadline) const;
+
+    /**
+     * @brief Blocks for the given duration.
+     * @param duration Time to wait.
+     */
+    void sleepFor(std::chrono::nanoseconds duration) const;
+
+    /**
+     * @brief Switches the calling thread to SCHED_FIFO at the given priority.
+     * @param priority Real-time priority (1-99).
+     * @throws std::runtime_error if the scheduler policy cannot be changed.
+     */
+    static void setRealtimePriority(int priority);
+
+    /**
+     * @brief Starts a worker thread, switched to SCHED_FIFO first if rtPriority > 0.
+     *
+     * Returns only once the priority is in place, so a failure surfaces in
+     * the caller rather than on the thread. An exception escaping body is
+     * handed to onError on the worker thread instead of reaching
+     * std::terminate.
+     * @param rtPriority Real-time priority (1-99), or 0 to leave the policy unchanged.
+     * @param body Thread function.
+     * @param onError Called with the exception that ended body.
+     * @throws std::runtime_error if the priority cannot be set; the thread has been joined.
+     */
+    static std::thread startThread(int rtPriority, std::function<void()> body,
+                                   std::function<void(std::exception_ptr)> onError);
+
+private:
+    std::chrono::nanoseconds spinThreshold;
+};
+
+#endif // PRECISETIMER_H
@@ -0,0 +1,196 @@
+#include "PulseTrain.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+PulseTrain::PulseTrain(int pin, const std::string& name, int rtPriority)
+    : pin(pin, DigitalPin::Direction::Output, name),
+      busy(false),
+      running(true),
+      queued(0),
+      cancelBefore(0),
+      pulseCount(0) {
+    this->pin.write(false);
+
+    worker = PreciseTimer::startThread(rtPriority, [this]() { run(); },
+                                       [this](std::exception_ptr error) { workerFailed(error); });
+}
+
+PulseTrain::~PulseTrain() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+        cancelBefore = queued;
+    }
+    cv.notify_all();
+    worker.join();
+    try {
+        pin.write(false);
+    } catch (...) {
+        // Destructors must not throw.
+    }
+}
+
+std::future<PulseTrain::Result> PulseTrain::queue(uint64_t count, std::chrono::nanoseconds high,
+                                                  std::chrono::nanoseconds low, Callback callback) {
+    if (count == 0 || high.count() <= 0 || low.count() <= 0) {
+        throw std::invalid_argument("Pulse burst needs a count and positive high/low times");
+    }
+    Burst burst{0, count, high, low, std::move(callback), std::promise<Result>()};
+    std::future<Result> future = burst.promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        burst.sequence = queued++;
+        bursts.push_back(std::move(burst));
+    }
+    cv.notify_all();
+    return future;
+}
+
+void PulseTrain::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!busy && bursts.empty()) {
+            return;
+        }
+        // A sequence cut-off rather than a flag, so a burst queued right
+        // after this call is not dropped along with the older ones.
+        cancelBefore = queued;
+    }
+    cv.notify_all();
+}
+
+bool PulseTrain::waitUntilIdle(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mtx);
+    auto idle = [this]() { return !busy && bursts.empty(); };
+    bool done = true;
+    if (timeout == std::chrono::milliseconds::max()) {
+        cv.wait(lock, idle);
+    } else {
+        done = cv.wait_for(lock, timeout, idle);
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    return done;
+}
+
+uint64_t PulseTrain::pulses() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return pulseCount;
+}
+
+void PulseTrain::finish(Burst& burst, const Result& result) {
+    if (burst.callback) {
+        burst.callback(result);
+    }
+    burst.promise.set_value(result);
+}
+
+void PulseTrain::workerFailed(std::exception_ptr error) {
+    std::deque<Burst> pending;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        failure = error;
+        running = false;
+        busy = false;
+        pending.swap(bursts);
+    }
+    cv.notify_all();
+    for (Burst& burst : pending) {
+        burst.promise.set_exception(error);
+    }
+}
+
+void PulseTrain::run() {
+    // Earliest start of the next pulse: the end of the last pulse's low time.
+    PreciseTimer::Clock::time_point next = PreciseTimer::Clock::now();
+    bool continuous = false;
+
+    while (true) {
+        Burst burst;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (bursts.empty()) {
+                busy = false;
+                continuous = false;
+                cv.notify_all();
+                cv.wait(lock, [this]() { return !running || !bursts.empty(); });
+            }
+            // Bursts are queued in sequence order, so the cancelled ones are at the front.
+            std::deque<Burst> dropped;
+            while (!bursts.empty() && bursts.front().sequence < cancelBefore) {
+                dropped.push_back(std::move(bursts.front()));
+                bursts.pop_front();
+            }
+            if (!dropped.empty()) {
+                // Complete every dropped burst with nothing emitted.
+                lock.unlock();
+                std::size_t i = 0;
+                try {
+                    for (; i < dropped.size(); ++i) {
+                        finish(dropped[i], Result{dropped[i].count, 0, std::chrono::nanoseconds(0)});
+                    }
+                } catch (...) {
+                    // A throwing callback stops the thread; its burst and the
+                    // rest of the dropped ones still get an outcome.
+                    for (; i < dropped.size(); ++i) {
+                        dropped[i].promise.set_exception(std::current_exception());
+                    }
+                    throw;
+                }
+                continuous = false;
+                continue;
+            }
+            if (!running) {
+                return;
+            }
+            burst = std::move(bursts.front());
+            bursts.pop_front();
+            busy = true;
+        }
+
+        try {
+            if (!continuous) {
+                next = std::max(next, PreciseTimer::Clock::now());
+            }
+            Result result{burst.count, 0, std::chrono::nanoseconds(0)};
+            for (uint64_t i = 0; i < burst.count; ++i) {
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if (burst.sequence < cancelBefore) {
+                        break;
+                    }
+                }
+                timer.sleepUntil(next);
+                pin.write(true);
+                const auto rise = PreciseTimer::Clock::now();
+                result.maxLateness =
+                    std::max(result.maxLateness, std::chrono::duration_cast<std::chrono::nanoseconds>(rise - next));
+                // Time the fall from the actual rise so a late rise does not shorten
+                // the pulse, and the next rise from the actual fall so it does not
+                // shorten the low time either.
+                timer.sleepUntil(std::max(next, rise) + burst.high);
+                pin.write(false);
+                const auto fall = PreciseTimer::Clock::now();
+                ++result.emitted;
+                next = std::max(next + burst.high + burst.low, fall + burst.low);
+            }
+            // A burst already queued starts on this timeline; lateness then shows in its stats.
+            continuous = result.emitted == burst.count;
+
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                pulseCount += result.emitted;
+            }
+            finish(burst, result);
+        } catch (...) {
+            // Callbacks run before the promise is set, so it is still unsatisfied.
+            burst.promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+}
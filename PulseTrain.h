@@ -0,0 +1,124 @@
+#ifndef PULSETRAIN_H
+#define PULSETRAIN_H
+
+#include "DigitalPin.h"
+#include "PreciseTimer.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Exact-count pulse generator on one DigitalPin output.
+ *
+ * Bursts of N pulses with given high and low times are queued and emitted
+ * by a dedicated thread at absolute PreciseTimer deadlines. The pulse count
+ * is exact: a late deadline delays the pulse, it never drops or repeats one,
+ * and the high and low times are measured from the edges actually written,
+ * so a late edge never shortens the pulse or the gap after it.
+ * A burst queued before the previous one finishes starts on the previous
+ * burst's timeline, one low time after its last pulse, so back-to-back
+ * bursts have no gap. Completion is reported through a future and an
+ * optional callback. If a write or a callback throws, the thread stops, the
+ * current and queued bursts' futures get the exception and queue() and
+ * waitUntilIdle() rethrow it.
+ */
+class PulseTrain {
+public:
+    /**
+     * @brief Outcome of one burst.
+     */
+    struct Result {
+        uint64_t requested = 0;
+        uint64_t emitted = 0;           ///< Less than requested only if the burst was cancelled
+        std::chrono::nanoseconds maxLateness{0};
+    };
+
+    using Callback = std::function<void(const Result&)>;
+
+    /**
+     * @brief Constructs the generator with the line low and starts its thread.
+     * @param pin GPIO pin to pulse.
+     * @param name Consumer name for the line.
+     * @param rtPriority SCHED_FIFO priority for the pulse thread, or 0 to leave it unchanged.
+     * @throws std::runtime_error if the real-time priority cannot be set.
+     */
+    PulseTrain(int pin, const std::string& name = "PulseTrain", int rtPriority = 0);
+
+    /**
+     * @brief Cancels any queued bursts and stops the thread with the line low.
+     */
+    ~PulseTrain();
+
+    PulseTrain(const PulseTrain&) = delete;
+    PulseTrain& operator=(const PulseTrain&) = delete;
+
+    /**
+     * @brief Queues a burst.
+     * @param count Number of pulses.
+     * @param high High time of each pulse.
+     * @param low Low time after each pulse.
+     * @param callback Optional; called from the pulse thread when the burst ends.
+     * @return Future that becomes ready when the burst ends.
+     * @throws std::invalid_argument if count is zero or a time is not positive.
+     */
+    std::future<Result> queue(uint64_t count, std::chrono::nanoseconds high, std::chrono::nanoseconds low,
+                              Callback callback = nullptr);
+
+    /**
+     * @brief Ends the current burst after its current pulse and drops queued ones.
+     *
+     * Every pending future is completed with the pulses actually emitted.
+     * Bursts queued after the call are not affected.
+     */
+    void cancel();
+
+    /**
+     * @brief Blocks until the queue is empty and the last burst has finished.
+     * @return false if the timeout elapsed first.
+     */
+    bool waitUntilIdle(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /**
+     * @brief Returns the total number of pulses emitted.
+     */
+    uint64_t pulses() const;
+
+private:
+    struct Burst {
+        uint64_t sequence;
+        uint64_t count;
+        std::chrono::nanoseconds high;
+        std::chrono::nanoseconds low;
+        Callback callback;
+        std::promise<Result> promise;
+    };
+
+    void run();
+    void workerFailed(std::exception_ptr error);
+    static void finish(Burst& burst, const Result& result);
+
+    DigitalPin pin;
+    PreciseTimer timer;
+
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<Burst> bursts;
+    bool busy;
+    bool running;
+    std::exception_ptr failure;
+    uint64_t queued;            ///< Sequence number of the next queued burst
+    uint64_t cancelBefore;      ///< Bursts with a lower sequence number are cancelled
+    uint64_t pulseCount;
+
+    std::thread worker;
+};
+
+#endif // PULSETRAIN_H
@@ -0,0 +1,122 @@
+#include "QuadratureEncoder.h"
+
+#include <limits>
+
+const int8_t QuadratureEncoder::TRANSITIONS[16] = {
+    // new: 00  01       10       11           old
+    ILLEGAL, -1,      +1,      ILLEGAL, // 00
+    +1,      ILLEGAL, ILLEGAL, -1,      // 01
+    -1,      ILLEGAL, ILLEGAL, +1,      // 10
+    ILLEGAL, +1,      -1,      ILLEGAL, // 11
+};
+
+QuadratureEncoder::QuadratureEncoder(bool initialA, bool initialB,
+                                     std::chrono::nanoseconds velocityWindow, bool resetOnIndex,
+                                     std::chrono::nanoseconds stopTimeout)
+    : state(static_cast<uint8_t>((initialA << 1) | initialB)),
+      velocityWindow(velocityWindow),
+      resetOnIndex(resetOnIndex),
+      stopTimeout(stopTimeout),
+      windowStart(0),
+      windowPosition(0),
+      windowStarted(false),
+      published(0),
+      pos(0),
+      vel(0.0),
+      lastEdgeNs(std::numeric_limits<int64_t>::min()),
+      illegal(0),
+      indexPos(0) {}
+
+void QuadratureEncoder::apply(uint8_t newState, std::chrono::nanoseconds timestamp) {
+    int8_t delta = TRANSITIONS[(state << 2) | newState];
+    state = newState;
+    if (delta == ILLEGAL) {
+        illegal.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Only this thread counts, so whatever pos holds beyond what it last
+    // published is a setPosition() jump. Reading it and adding the count in
+    // one CAS ties the jump to exactly this update, wherever setPosition()
+    // lands, and the jump is kept out of the velocity window.
+    int64_t observed = pos.load(std::memory_order_relaxed);
+    while (!pos.compare_exchange_weak(observed, observed + delta, std::memory_order_relaxed)) {
+    }
+    const int64_t current = observed + delta;
+    windowPosition += observed - published;
+    published = current;
+    const int64_t previous = lastEdgeNs.exchange(timestamp.count(), std::memory_order_relaxed);
+
+    // After a stop, start a fresh window rather than averaging over the pause.
+    if (!windowStarted || timestamp.count() - previous > stopTimeout.count()) {
+        windowStart = timestamp;
+        windowPosition = current;
+        windowStarted = true;
+    } else if (timestamp - windowStart >= velocityWindow) {
+        double seconds = std::chrono::duration<double>(timestamp - windowStart).count();
+        vel.store((current - windowPosition) / seconds, std::memory_order_relaxed);
+        windowStart = timestamp;
+        windowPosition = current;
+    }
+}
+
+void QuadratureEncoder::onEdge(Channel channel, const EdgeEvent& event) {
+    switch (channel) {
+    case Channel::A:
+        apply(static_cast<uint8_t>((state & 0x1) | (event.rising << 1)), event.timestamp);
+        break;
+    case Channel::B:
+        apply(static_cast<uint8_t>((state & 0x2) | event.rising), event.timestamp);
+        break;
+    case Channel::Index:
+        if (event.rising) {
+            if (resetOnIndex) {
+                const int64_t old = pos.exchange(0, std::memory_order_relaxed);
+                indexPos.store(old, std::memory_order_relaxed);
+                // Neither the reset nor any setPosition() jump since the last edge is motion.
+                windowPosition -= published;
+                published = 0;
+            } else {
+                indexPos.store(pos.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+        }
+        break;
+    }
+}
+
+void QuadratureEncoder::onEdges(const Channel* channels, const EdgeEvent* events, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        onEdge(channels[i], events[i]);
+    }
+}
+
+int64_t QuadratureEncoder::position() const {
+    return pos.load(std::memory_order_relaxed);
+}
+
+double QuadratureEncoder::velocity() const {
+    // EdgeEvent timestamps are CLOCK_MONOTONIC, which steady_clock reads on Linux.
+    return velocity(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()));
+}
+
+double QuadratureEncoder::velocity(std::chrono::nanoseconds now) const {
+    const int64_t last = lastEdgeNs.load(std::memory_order_relaxed);
+    if (last == std::numeric_limits<int64_t>::min() || now.count() - last > stopTimeout.count()) {
+        return 0.0;
+    }
+    return vel.load(std::memory_order_relaxed);
+}
+
+uint64_t QuadratureEncoder::illegalTransitions() const {
+    return illegal.load(std::memory_order_relaxed);
+}
+
+int64_t QuadratureEncoder::indexPosition() const {
+    return indexPos.load(std::memory_order_relaxed);
+}
+
+void QuadratureEncoder::setPosition(int64_t value) {
+    // The feeder finds the jump by comparing pos with what it last published.
+    pos.store(value, std::memory_order_relaxed);
+}
@@ -0,0 +1,113 @@
+#ifndef QUADRATUREENCODER_H
+#define QUADRATUREENCODER_H
+
+#include "EdgeEvent.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Table-driven A/B quadrature decoder fed by edge events.
+ *
+ * Counts every edge (x4 decoding) from timestamped events, so no transitions
+ * are lost to polling. Position, velocity and the illegal-transition count
+ * are published through lock-free atomics: one thread feeds edges, any number
+ * of threads may read.
+ */
+class QuadratureEncoder {
+public:
+    enum class Channel { A, B, Index };
+
+    /**
+     * @brief Constructs a decoder.
+     * @param initialA Level of channel A when decoding starts.
+     * @param initialB Level of channel B when decoding starts.
+     * @param velocityWindow Interval over which velocity is averaged.
+     * @param resetOnIndex Zero the position on every rising index edge.
+     * @param stopTimeout Time without edges after which the velocity reads as 0.
+     */
+    QuadratureEncoder(bool initialA, bool initialB,
+                      std::chrono::nanoseconds velocityWindow = std::chrono::milliseconds(10),
+                      bool resetOnIndex = false,
+                      std::chrono::nanoseconds stopTimeout = std::chrono::milliseconds(100));
+
+    /**
+     * @brief Feeds one edge. Must be called from a single thread in time order.
+     */
+    void onEdge(Channel channel, const EdgeEvent& event);
+
+    /**
+     * @brief Feeds a batch of edges drained from one event read.
+     * @param channels Channel of each event.
+     * @param events Events in time order.
+     * @param count Number of events.
+     */
+    void onEdges(const Channel* channels, const EdgeEvent* events, std::size_t count);
+
+    /**
+     * @brief Returns the current position in counts.
+     */
+    int64_t position() const;
+
+    /**
+     * @brief Returns the velocity in counts per second over the last window.
+     *
+     * Reads as 0 once no edge has arrived for stopTimeout, since a stopped
+     * shaft produces no edge to update it.
+     */
+    double velocity() const;
+
+    /**
+     * @brief Returns the velocity as seen at a given time.
+     * @param now Monotonic time in the same base as the edge timestamps.
+     */
+    double velocity(std::chrono::nanoseconds now) const;
+
+    /**
+     * @brief Returns the number of missed edges.
+     *
+     * An edge that leaves its channel at the level it already had means the
+     * opposite edge was lost, so the count may be off by up to two.
+     */
+    uint64_t illegalTransitions() const;
+
+    /**
+     * @brief Returns the position latched at the last rising index edge.
+     */
+    int64_t indexPosition() const;
+
+    /**
+     * @brief Sets the position counter. Safe to call while edges are being fed.
+     */
+    void setPosition(int64_t value);
+
+private:
+    void apply(uint8_t newState, std::chrono::nanoseconds timestamp);
+
+    // Indexed by (oldState << 2) | newState with state = (A << 1) | B. A
+    // single edge changes at most one bit, so the illegal entries are the
+    // unchanged states (a repeated level) and, for completeness, double steps.
+    static const int8_t TRANSITIONS[16];
+    static constexpr int8_t ILLEGAL = 2;
+
+    uint8_t state;
+    std::chrono::nanoseconds velocityWindow;
+    bool resetOnIndex;
+    std::chrono::nanoseconds stopTimeout;
+    std::chrono::nanoseconds windowStart;
+    int64_t windowPosition;
+    bool windowStarted;
+
+    /// pos as last written by the feeder; any difference is a setPosition() jump
+    int64_t published;
+
+    std::atomic<int64_t> pos;
+    std::atomic<double> vel;
+    std::atomic<int64_t> lastEdgeNs;
+    std::atomic<uint64_t> illegal;
+    std::atomic<int64_t> indexPos;
+};
+
+#endif // QUADRATUREENCODER_H
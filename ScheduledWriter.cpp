@@ -0,0 +1,183 @@
+#include "ScheduledWriter.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+// Sleep on the condition variable until this long before a deadline, then
+// spin; matches PreciseTimer's default spin threshold.
+constexpr std::chrono::microseconds WAKE_AHEAD(100);
+constexpr int64_t NO_DEADLINE = std::numeric_limits<int64_t>::max();
+} // namespace
+
+constexpr std::size_t ScheduledWriter::ERROR_HISTORY;
+
+ScheduledWriter::ScheduledWriter(const std::vector<DigitalPort*>& ports, int rtPriority)
+    : ports(ports), earliestNs(NO_DEADLINE), nextSequence(0), running(true), errorIndex(0) {
+    if (ports.empty()) {
+        throw std::invalid_argument("ScheduledWriter needs at least one port");
+    }
+    for (DigitalPort* port : ports) {
+        if (port == nullptr) {
+            throw std::invalid_argument("ScheduledWriter port must not be null");
+        }
+    }
+    errors.reserve(ERROR_HISTORY);
+
+    worker = PreciseTimer::startThread(rtPriority, [this]() { run(); },
+                                       [this](std::exception_ptr error) { workerFailed(error); });
+}
+
+ScheduledWriter::~ScheduledWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+    }
+    cv.notify_all();
+    worker.join();
+}
+
+std::chrono::nanoseconds ScheduledWriter::now() {
+    // steady_clock is CLOCK_MONOTONIC on Linux.
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(PreciseTimer::Clock::now().time_since_epoch());
+}
+
+void ScheduledWriter::writeAt(std::chrono::nanoseconds deadline, std::size_t port, uint64_t mask, uint64_t value) {
+    if (port >= ports.size()) {
+        throw std::out_of_range("ScheduledWriter port out of range");
+    }
+    bool earliest;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        earliest = queue.empty() || deadline < queue.top().deadline;
+        queue.push({deadline, nextSequence++, port, mask, value & mask});
+        if (earliest) {
+            earliestNs.store(deadline.count(), std::memory_order_release);
+        }
+    }
+    // Only a new earliest deadline changes when the thread must wake.
+    if (earliest) {
+        cv.notify_all();
+    }
+}
+
+std::size_t ScheduledWriter::pending() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return queue.size();
+}
+
+ScheduledWriter::Stats ScheduledWriter::stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return counters;
+}
+
+std::chrono::nanoseconds ScheduledWriter::errorPercentile(double fraction) const {
+    std::vector<std::chrono::nanoseconds> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        sorted = errors;
+    }
+    if (sorted.empty()) {
+        return std::chrono::nanoseconds(0);
+    }
+    fraction = std::min(std::max(fraction, 0.0), 1.0);
+    const auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(index), sorted.end());
+    return sorted[index];
+}
+
+void ScheduledWriter::recordError(std::chrono::nanoseconds error) {
+    if (errors.size() < ERROR_HISTORY) {
+        errors.push_back(error);
+    } else {
+        errors[errorIndex] = error;
+        errorIndex = (errorIndex + 1) % ERROR_HISTORY;
+    }
+    counters.maxError = std::max(counters.maxError, error);
+}
+
+void ScheduledWriter::workerFailed(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mtx);
+    failure = error;
+    running = false;
+}
+
+void ScheduledWriter::run() {
+    std::vector<uint64_t> mask(ports.size());
+    std::vector<uint64_t> value(ports.size());
+    std::vector<std::chrono::nanoseconds> written(ports.size());
+    std::vector<Entry> batch;
+
+    while (true) {
+        std::chrono::nanoseconds deadline;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            while (true) {
+                if (!running) {
+                    return;
+                }
+                if (queue.empty()) {
+                    cv.wait(lock);
+                    continue;
+                }
+                deadline = queue.top().deadline;
+                const PreciseTimer::Clock::time_point wake(deadline - WAKE_AHEAD);
+                if (PreciseTimer::Clock::now() >= wake) {
+                    break;
+                }
+                // Woken early by a new earliest write, the loop re-reads the top.
+                cv.wait_until(lock, wake);
+            }
+        }
+
+        // Spin the last stretch, following the queue top: a write scheduled
+        // meanwhile with an earlier deadline must fire at its own time rather
+        // than with this batch.
+        std::chrono::nanoseconds current = now();
+        while (true) {
+            deadline = std::min(deadline, std::chrono::nanoseconds(earliestNs.load(std::memory_order_acquire)));
+            if (current >= deadline) {
+                break;
+            }
+            current = now();
+        }
+
+        // Take everything due by now, which includes every write at this instant.
+        batch.clear();
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            while (!queue.empty() && queue.top().deadline <= current) {
+                batch.push_back(queue.top());
+                queue.pop();
+            }
+            earliestNs.store(queue.empty() ? NO_DEADLINE : queue.top().deadline.count(), std::memory_order_release);
+        }
+
+        std::fill(mask.begin(), mask.end(), 0);
+        std::fill(value.begin(), value.end(), 0);
+        for (const Entry& entry : batch) {
+            // Entries come out in deadline then sequence order, so later writes win.
+            mask[entry.port] |= entry.mask;
+            value[entry.port] = (value[entry.port] & ~entry.mask) | entry.value;
+        }
+        unsigned long calls = 0;
+        for (std::size_t port = 0; port < ports.size(); ++port) {
+            if (mask[port] != 0) {
+                ports[port]->writeMasked(mask[port], value[port]);
+                written[port] = now();
+                ++calls;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mtx);
+        counters.writes += batch.size();
+        counters.calls += calls;
+        for (const Entry& entry : batch) {
+            recordError(written[entry.port] - entry.deadline);
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef SCHEDULEDWRITER_H
+#define SCHEDULEDWRITER_H
+
+#include "DigitalPort.h"
+#include "PreciseTimer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fires DigitalPort writes at absolute CLOCK_MONOTONIC deadlines.
+ *
+ * Writes are kept in a priority queue ordered by deadline and fired by a
+ * dedicated thread that sleeps until just before the earliest deadline and
+ * spins the rest of the way, watching for a write scheduled meanwhile with
+ * an earlier deadline. Every write due at the same
+ * instant, plus any already overdue, is merged into one writeMasked() call
+ * per port; when several target the same line, the last scheduled wins.
+ * Deadlines use the same monotonic nanosecond base as EdgeEvent timestamps.
+ */
+class ScheduledWriter {
+public:
+    /**
+     * @brief Time error of fired writes: completion of the port write minus the deadline.
+     */
+    struct Stats {
+        unsigned long writes = 0;       ///< Scheduled writes fired
+        unsigned long calls = 0;        ///< writeMasked() calls made for them
+        std::chrono::nanoseconds maxError{0};
+    };
+
+    /**
+     * @brief Constructs the writer and starts its thread.
+     * @param ports Output ports writes may target; must outlive the writer.
+     * @param rtPriority SCHED_FIFO priority for the writer thread, or 0 to leave it unchanged.
+     * @throws std::invalid_argument if no ports are given.
+     * @throws std::runtime_error if the real-time priority cannot be set.
+     */
+    explicit ScheduledWriter(const std::vector<DigitalPort*>& ports, int rtPriority = 0);
+
+    /**
+     * @brief Stops the thread; writes still pending are dropped.
+     */
+    ~ScheduledWriter();
+
+    ScheduledWriter(const ScheduledWriter&) = delete;
+    ScheduledWriter& operator=(const ScheduledWriter&) = delete;
+
+    /**
+     * @brief Schedules a masked write.
+     * @param deadline Absolute CLOCK_MONOTONIC time; a past deadline fires at once.
+     * @param port Index into the port list.
+     * @param mask Lines to change.
+     * @param value New levels of the masked lines.
+     * @throws std::out_of_range if port is outside the port list.
+     * @throws The exception that stopped the writer thread, if a port write failed.
+     */
+    void writeAt(std::chrono::nanoseconds deadline, std::size_t port, uint64_t mask, uint64_t value);
+
+    /**
+     * @brief Returns the number of writes not yet fired.
+     */
+    std::size_t pending() const;
+
+    Stats stats() const;
+
+    /**
+     * @brief Returns a percentile of the time error over the most recent writes.
+     * @param fraction Percentile as a fraction, e.g. 0.99.
+     * @return Error at that percentile, or zero before any write has fired.
+     */
+    std::chrono::nanoseconds errorPercentile(double fraction) const;
+
+    /**
+     * @brief Returns the current CLOCK_MONOTONIC time in nanoseconds.
+     */
+    static std::chrono::nanoseconds now();
+
+    /// Number of recent errors kept for errorPercentile().
+    static constexpr std::size_t ERROR_HISTORY = 4096;
+
+private:
+    struct Entry {
+        std::chrono::nanoseconds deadline;
+        uint64_t sequence;              ///< Orders writes with equal deadlines
+        std::size_t port;
+        uint64_t mask;
+        uint64_t value;
+    };
+
+    struct Later {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.deadline != b.deadline ? a.deadline > b.deadline : a.sequence > b.sequence;
+        }
+    };
+
+    void run();
+    void workerFailed(std::exception_ptr error);
+    void recordError(std::chrono::nanoseconds error);
+
+    std::vector<DigitalPort*> ports;
+
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::priority_queue<Entry, std::vector<Entry>, Later> queue;
+    /// Deadline at the top of the queue in nanoseconds, read without the lock while spinning
+    std::atomic<int64_t> earliestNs;
+    uint64_t nextSequence;
+    bool running;
+    std::exception_ptr failure;
+    Stats counters;
+    std::vector<std::chrono::nanoseconds> errors;
+    std::size_t errorIndex;
+
+    std::thread worker;
+};
+
+#endif // SCHEDULEDWRITER_H
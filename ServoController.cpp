@@ -0,0 +1,230 @@
+#include "ServoController.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+ServoController::ServoController(DigitalPort& port, const std::vector<unsigned int>& channelBits,
+                                 const Config& config)
+    : port(port),
+      channelBits(channelBits),
+      config(config),
+      mask(0),
+      widths(channelBits.size(), std::chrono::nanoseconds(0)),
+      generation(0),
+      running(true),
+      channelStats(channelBits.size()) {
+    if (channelBits.empty() || config.groups == 0) {
+        throw std::invalid_argument("ServoController needs channels and at least one start slot");
+    }
+    if (config.minPulse.count() <= 0 || config.minPulse > config.maxPulse ||
+        config.maxPulse >= config.frame) {
+        throw std::invalid_argument("Servo pulse range must be positive and shorter than the frame");
+    }
+    // The last start slot's longest pulse must end within the frame, or it
+    // would overlap the next frame's schedule.
+    if (config.frame * (config.groups - 1) / config.groups + config.maxPulse > config.frame) {
+        throw std::invalid_argument("Servo maxPulse does not fit after the last start slot");
+    }
+    for (unsigned int bit : channelBits) {
+        if (bit >= port.width()) {
+            throw std::invalid_argument("Servo channel bit outside DigitalPort");
+        }
+        if (mask & (uint64_t(1) << bit)) {
+            throw std::invalid_argument("Servo channel bits must be distinct");
+        }
+        mask |= uint64_t(1) << bit;
+    }
+    port.writeMasked(mask, 0);
+
+    worker = PreciseTimer::startThread(config.rtPriority, [this]() { run(); },
+                                       [this](std::exception_ptr error) { workerFailed(error); });
+}
+
+ServoController::~ServoController() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+    }
+    worker.join();
+    try {
+        port.writeMasked(mask, 0);
+    } catch (...) {
+        // Destructors must not throw.
+    }
+}
+
+void ServoController::setPulseWidth(std::size_t channel, std::chrono::nanoseconds width) {
+    if (channel >= widths.size()) {
+        throw std::out_of_range("Servo channel out of range");
+    }
+    width = std::min(std::max(width, config.minPulse), config.maxPulse);
+    std::lock_guard<std::mutex> lock(mtx);
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    if (widths[channel] != width) {
+        widths[channel] = width;
+        ++generation;
+    }
+}
+
+void ServoController::setAngle(std::size_t channel, double degrees) {
+    if (std::isnan(degrees)) {
+        throw std::invalid_argument("Servo angle must be a number");
+    }
+    const double fraction = std::min(std::max(degrees / 180.0, 0.0), 1.0);
+    const auto range = config.maxPulse - config.minPulse;
+    setPulseWidth(channel, config.minPulse + std::chrono::nanoseconds(
+                                                 static_cast<int64_t>(fraction * static_cast<double>(range.count()))));
+}
+
+void ServoController::disable(std::size_t channel) {
+    if (channel >= widths.size()) {
+        throw std::out_of_range("Servo channel out of range");
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    if (widths[channel].count() != 0) {
+        widths[channel] = std::chrono::nanoseconds(0);
+        ++generation;
+    }
+}
+
+std::vector<ServoController::ChannelStats> ServoController::stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return channelStats;
+}
+
+void ServoController::resetStats() {
+    std::lock_guard<std::mutex> lock(mtx);
+    channelStats.assign(channelStats.size(), ChannelStats());
+}
+
+std::size_t ServoController::channels() const {
+    return channelBits.size();
+}
+
+void ServoController::workerFailed(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mtx);
+    failure = error;
+    running = false;
+}
+
+void ServoController::buildSchedule(const std::vector<std::chrono::nanoseconds>& widths,
+                                    std::vector<Edge>& schedule) const {
+    struct Transition {
+        std::chrono::nanoseconds offset;
+        std::size_t channel;
+        bool rising;
+    };
+    std::vector<Transition> transitions;
+    for (std::size_t channel = 0; channel < widths.size(); ++channel) {
+        if (widths[channel].count() == 0) {
+            continue;
+        }
+        const auto start = config.frame * (channel % config.groups) / config.groups;
+        transitions.push_back({start, channel, true});
+        transitions.push_back({start + widths[channel], channel, false});
+    }
+    std::stable_sort(transitions.begin(), transitions.end(),
+                     [](const Transition& a, const Transition& b) { return a.offset < b.offset; });
+
+    // The port value after each write is the running state of every channel,
+    // so merged writes stay correct whatever mix of edges they carry.
+    schedule.clear();
+    uint64_t level = 0;
+    for (const Transition& transition : transitions) {
+        if (schedule.empty() || schedule.back().offset != transition.offset) {
+            schedule.push_back({transition.offset, level, -1, {}});
+        }
+        Edge& edge = schedule.back();
+        const uint64_t bit = uint64_t(1) << channelBits[transition.channel];
+        if (transition.rising) {
+            level |= bit;
+            edge.risingGroup = static_cast<int>(transition.channel % config.groups);
+        } else {
+            level &= ~bit;
+            edge.falling.push_back(transition.channel);
+        }
+        edge.value = level;
+    }
+}
+
+void ServoController::run() {
+    std::vector<Edge> schedule;
+    std::vector<PreciseTimer::Clock::time_point> riseTime(config.groups);
+    std::vector<ChannelStats> measured(channelBits.size());
+    std::vector<std::chrono::nanoseconds> current;
+    unsigned long seen = ~0UL;
+    auto frameStart = PreciseTimer::Clock::now();
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!running) {
+                return;
+            }
+            for (std::size_t channel = 0; channel < measured.size(); ++channel) {
+                ChannelStats& shared = channelStats[channel];
+                const ChannelStats& local = measured[channel];
+                if (local.pulses == 0) {
+                    continue;
+                }
+                if (shared.pulses == 0 || shared.target != local.target) {
+                    shared = local;
+                } else {
+                    shared.pulses += local.pulses;
+                    shared.minWidth = std::min(shared.minWidth, local.minWidth);
+                    shared.maxWidth = std::max(shared.maxWidth, local.maxWidth);
+                }
+            }
+            // Rebuild the schedule only when a width changed.
+            if (generation != seen) {
+                current = widths;
+                buildSchedule(current, schedule);
+                seen = generation;
+            }
+        }
+        measured.assign(measured.size(), ChannelStats());
+
+        // After a stall, restart the frame rather than replaying its edges
+        // back to back, which would emit truncated pulses.
+        timer.sleepUntil(frameStart);
+        if (PreciseTimer::Clock::now() - frameStart > config.frame - config.maxPulse) {
+            frameStart = PreciseTimer::Clock::now();
+        }
+
+        for (const Edge& edge : schedule) {
+            // A late rising edge delays its falling edges too, so the width
+            // the servo sees is kept even when the slot start slips.
+            auto deadline = frameStart + edge.offset;
+            for (std::size_t channel : edge.falling) {
+                deadline = std::max(deadline, riseTime[channel % config.groups] + current[channel]);
+            }
+            timer.sleepUntil(deadline);
+            port.writeMasked(mask, edge.value);
+            const auto now = PreciseTimer::Clock::now();
+            if (edge.risingGroup >= 0) {
+                riseTime[static_cast<std::size_t>(edge.risingGroup)] = now;
+            }
+            for (std::size_t channel : edge.falling) {
+                const auto width = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    now - riseTime[channel % config.groups]);
+                ChannelStats& stats = measured[channel];
+                if (stats.pulses == 0) {
+                    stats.target = current[channel];
+                    stats.minWidth = width;
+                    stats.maxWidth = width;
+                } else {
+                    stats.minWidth = std::min(stats.minWidth, width);
+                    stats.maxWidth = std::max(stats.maxWidth, width);
+                }
+                ++stats.pulses;
+            }
+        }
+        frameStart += config.frame;
+    }
+}
@@ -0,0 +1,135 @@
+#ifndef SERVOCONTROLLER_H
+#define SERVOCONTROLLER_H
+
+#include "DigitalPort.h"
+#include "PreciseTimer.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Frame timing for ServoController.
+ */
+struct ServoConfig {
+    std::chrono::nanoseconds frame = std::chrono::milliseconds(20);
+    std::chrono::nanoseconds minPulse = std::chrono::microseconds(1000);    ///< Width at 0 degrees
+    std::chrono::nanoseconds maxPulse = std::chrono::microseconds(2000);    ///< Width at 180 degrees
+    unsigned int groups = 4;            ///< Start slots the channels are spread over within a frame
+    int rtPriority = 0;                 ///< SCHED_FIFO priority for the pulse thread
+};
+
+/**
+ * @brief Multi-channel hobby servo pulse generator on a DigitalPort.
+ *
+ * Channel i starts its pulse in start slot i % groups; the slots are spread
+ * evenly over the frame, so only a fraction of the servos switch at once and
+ * their supply current is staggered. All rising edges of a slot are one bulk
+ * write. Falling edges are sorted into the same per-frame schedule, and edges
+ * due at the same instant are merged into one write. One thread plays the
+ * schedule at absolute PreciseTimer deadlines; width changes are applied at
+ * the next frame boundary, so a pulse is never cut short. If a port write
+ * fails, the thread stops and the setters rethrow its exception.
+ */
+class ServoController {
+public:
+    using Config = ServoConfig;
+
+    /**
+     * @brief Measured pulse widths of one channel.
+     *
+     * Widths are taken between the completion times of the writes that raise
+     * and lower the pulse, so maxWidth - minWidth is the pulse-width jitter.
+     */
+    struct ChannelStats {
+        unsigned long pulses = 0;
+        std::chrono::nanoseconds target{0};
+        std::chrono::nanoseconds minWidth{0};
+        std::chrono::nanoseconds maxWidth{0};
+    };
+
+    /**
+     * @brief Constructs the engine with every channel idle and starts the pulse thread.
+     * @param port Output port holding the servo signal lines.
+     * @param channelBits Port bit of each channel.
+     * @param config Frame timing.
+     * @throws std::invalid_argument if the channels or timing are invalid, including a
+     *         maxPulse that would run past the frame from the last start slot.
+     * @throws std::runtime_error if the real-time priority cannot be set.
+     */
+    ServoController(DigitalPort& port, const std::vector<unsigned int>& channelBits,
+                    const Config& config = Config());
+
+    /**
+     * @brief Stops the pulse thread and drives every channel low.
+     */
+    ~ServoController();
+
+    ServoController(const ServoController&) = delete;
+    ServoController& operator=(const ServoController&) = delete;
+
+    /**
+     * @brief Sets the pulse width of a channel, clamped to [minPulse, maxPulse].
+     * @throws std::out_of_range if channel is outside the controller.
+     */
+    void setPulseWidth(std::size_t channel, std::chrono::nanoseconds width);
+
+    /**
+     * @brief Sets a channel's position, mapping 0-180 degrees onto the pulse range.
+     * @throws std::out_of_range if channel is outside the controller.
+     * @throws std::invalid_argument if degrees is NaN.
+     */
+    void setAngle(std::size_t channel, double degrees);
+
+    /**
+     * @brief Stops pulsing a channel, leaving the servo unpowered in position.
+     * @throws std::out_of_range if channel is outside the controller.
+     */
+    void disable(std::size_t channel);
+
+    /**
+     * @brief Returns the measured widths of every channel.
+     */
+    std::vector<ChannelStats> stats() const;
+
+    /**
+     * @brief Clears the measured widths.
+     */
+    void resetStats();
+
+    std::size_t channels() const;
+
+private:
+    /// One bulk write in the per-frame schedule.
+    struct Edge {
+        std::chrono::nanoseconds offset;
+        uint64_t value;                 ///< Within mask
+        int risingGroup;                ///< Start slot raised by this write, or -1
+        std::vector<std::size_t> falling;
+    };
+
+    void buildSchedule(const std::vector<std::chrono::nanoseconds>& widths, std::vector<Edge>& schedule) const;
+    void run();
+    void workerFailed(std::exception_ptr error);
+
+    DigitalPort& port;
+    std::vector<unsigned int> channelBits;
+    Config config;
+    uint64_t mask;
+    PreciseTimer timer;
+
+    mutable std::mutex mtx;
+    std::vector<std::chrono::nanoseconds> widths;
+    unsigned long generation;
+    bool running;
+    std::exception_ptr failure;
+    std::vector<ChannelStats> channelStats;
+
+    std::thread worker;
+};
+
+#endif // SERVOCONTROLLER_H
@@ -0,0 +1,269 @@
+#include "ShiftRegister.h"
+
+#include "PreciseTimer.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+std::size_t checkedLength(std::size_t bits) {
+    if (bits == 0 || bits % 8 != 0) {
+        throw std::invalid_argument("Shift register chain length must be a non-zero multiple of 8");
+    }
+    return bits;
+}
+
+SoftSpiConfig chainConfig(int mode, uint32_t clockHz) {
+    SoftSpiConfig config;
+    config.mode = mode;
+    config.bitOrder = SoftSpiConfig::BitOrder::MsbFirst;
+    config.clockHz = clockHz;
+    return config;
+}
+} // namespace
+
+ShiftRegisterPin::ShiftRegisterPin(ShiftRegisterOutput& chain, std::size_t bit) : chain(chain), bit(bit) {}
+
+void ShiftRegisterPin::write(bool value) {
+    chain.set(bit, value);
+}
+
+bool ShiftRegisterPin::read() const {
+    return chain.get(bit);
+}
+
+ShiftRegisterInputPin::ShiftRegisterInputPin(ShiftRegisterInput& chain, std::size_t bit) : chain(chain), bit(bit) {}
+
+bool ShiftRegisterInputPin::read() const {
+    return chain.get(bit);
+}
+
+// The 595 shifts on the rising SRCLK edge (mode 0) and latches on the rising
+// RCLK edge, which SoftSpi produces when it deasserts its chip select.
+ShiftRegisterOutput::ShiftRegisterOutput(int dataPin, int clockPin, int latchPin, std::size_t bits,
+                                         std::chrono::microseconds framePeriod, uint32_t clockHz)
+    : bits(checkedLength(bits)),
+      spi(clockPin, dataPin, -1, latchPin, chainConfig(0, clockHz)),
+      framePeriod(framePeriod),
+      shadow(bits / 8, 0),
+      dirty(true),
+      running(true),
+      shifts(0) {
+    flush();
+    if (framePeriod.count() > 0) {
+        worker = PreciseTimer::startThread(0, [this]() { run(); },
+                                           [this](std::exception_ptr error) { workerFailed(error); });
+    }
+}
+
+ShiftRegisterOutput::~ShiftRegisterOutput() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+    }
+    cv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void ShiftRegisterOutput::set(std::size_t bit, bool level) {
+    if (bit >= bits) {
+        throw std::out_of_range("Shift register bit out of range");
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    uint8_t mask = static_cast<uint8_t>(1u << (bit % 8));
+    uint8_t& byte = shadow[bit / 8];
+    uint8_t updated = level ? (byte | mask) : (byte & ~mask);
+    if (updated != byte) {
+        byte = updated;
+        dirty = true;
+    }
+}
+
+void ShiftRegisterOutput::setMasked(uint64_t mask, uint64_t value) {
+    if (bits < 64 && (mask >> bits) != 0) {
+        throw std::out_of_range("Shift register bit out of range");
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    for (std::size_t n = 0; n < 8 && mask >> (8 * n); ++n) {
+        const uint8_t byteMask = static_cast<uint8_t>(mask >> (8 * n));
+        uint8_t& byte = shadow[n];
+        const uint8_t updated = static_cast<uint8_t>((byte & ~byteMask) | ((value >> (8 * n)) & byteMask));
+        if (updated != byte) {
+            byte = updated;
+            dirty = true;
+        }
+    }
+}
+
+bool ShiftRegisterOutput::get(std::size_t bit) const {
+    if (bit >= bits) {
+        throw std::out_of_range("Shift register bit out of range");
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    return (shadow[bit / 8] >> (bit % 8)) & 0x1;
+}
+
+void ShiftRegisterOutput::flush() {
+    std::lock_guard<std::mutex> flushLock(flushMtx);
+    std::vector<uint8_t> frame;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        if (!dirty) {
+            return;
+        }
+        // The first byte shifted ends up in the register farthest from the host.
+        frame.assign(shadow.rbegin(), shadow.rend());
+    }
+    spi.transfer(frame.data(), nullptr, frame.size());
+    ++shifts;
+
+    // Clean only once the frame is latched, and only if no bit changed meanwhile.
+    std::lock_guard<std::mutex> lock(mtx);
+    dirty = !std::equal(shadow.rbegin(), shadow.rend(), frame.begin());
+}
+
+void ShiftRegisterOutput::run() {
+    auto next = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mtx);
+    while (running) {
+        next += framePeriod;
+        if (cv.wait_until(lock, next, [this]() { return !running; })) {
+            break;
+        }
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void ShiftRegisterOutput::workerFailed(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mtx);
+    failure = error;
+    running = false;
+}
+
+ShiftRegisterPin ShiftRegisterOutput::pin(std::size_t bit) {
+    if (bit >= bits) {
+        throw std::out_of_range("Shift register bit out of range");
+    }
+    return ShiftRegisterPin(*this, bit);
+}
+
+unsigned long ShiftRegisterOutput::shiftCount() const {
+    return shifts.load();
+}
+
+std::size_t ShiftRegisterOutput::size() const {
+    return bits;
+}
+
+// The 165 presents QH right after the parallel load and shifts on the rising
+// CLK edge, so it is read in mode 2: sample on the falling edge, shift on the rise.
+ShiftRegisterInput::ShiftRegisterInput(int dataPin, int clockPin, int loadPin, std::size_t bits,
+                                       std::chrono::microseconds samplePeriod, uint32_t clockHz)
+    : bits(checkedLength(bits)),
+      spi(clockPin, -1, dataPin, -1, chainConfig(2, clockHz)),
+      load(loadPin, DigitalPin::Direction::Output, "ShiftRegister-LOAD"),
+      samplePeriod(samplePeriod),
+      latest(bits / 8, 0),
+      running(true) {
+    load.write(true);
+    sample();
+    if (samplePeriod.count() > 0) {
+        worker = PreciseTimer::startThread(0, [this]() { run(); },
+                                           [this](std::exception_ptr error) { workerFailed(error); });
+    }
+}
+
+ShiftRegisterInput::~ShiftRegisterInput() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+    }
+    cv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void ShiftRegisterInput::sample() {
+    std::lock_guard<std::mutex> sampleLock(sampleMtx);
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+    load.write(false);
+    load.write(true);
+    std::vector<uint8_t> frame(bits / 8, 0);
+    spi.transfer(nullptr, frame.data(), frame.size());
+
+    std::lock_guard<std::mutex> lock(mtx);
+    latest.swap(frame);
+}
+
+bool ShiftRegisterInput::get(std::size_t bit) const {
+    if (bit >= bits) {
+        throw std::out_of_range("Shift register bit out of range");
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    // Bits arrive H first into the MSB, so input A of each register is bit 0 of its byte.
+    return (latest[bit / 8] >> (bit % 8)) & 0x1;
+}
+
+std::vector<uint8_t> ShiftRegisterInput::snapshot() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    return latest;
+}
+
+void ShiftRegisterInput::run() {
+    auto next = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mtx);
+    while (running) {
+        next += samplePeriod;
+        if (cv.wait_until(lock, next, [this]() { return !running; })) {
+            break;
+        }
+        lock.unlock();
+        sample();
+        lock.lock();
+    }
+}
+
+void ShiftRegisterInput::workerFailed(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mtx);
+    failure = error;
+    running = false;
+}
+
+ShiftRegisterInputPin ShiftRegisterInput::pin(std::size_t bit) {
+    if (bit >= bits) {
+        throw std::out_of_range("Shift register bit out of range");
+    }
+    return ShiftRegisterInputPin(*this, bit);
+}
+
+std::size_t ShiftRegisterInput::size() const {
+    return bits;
+}
@@ -0,0 +1,226 @@
+#ifndef SHIFTREGISTER_H
+#define SHIFTREGISTER_H
+
+#include "DigitalPin.h"
+#include "SoftSpi.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ShiftRegisterOutput;
+class ShiftRegisterInput;
+
+/**
+ * @brief One output bit of a 74HC595 chain, used like a DigitalPin.
+ */
+class ShiftRegisterPin {
+public:
+    ShiftRegisterPin(ShiftRegisterOutput& chain, std::size_t bit);
+
+    /**
+     * @brief Sets the bit; the change is shifted out with the next frame.
+     */
+    void write(bool value);
+
+    /**
+     * @brief Returns the level most recently written to the bit.
+     */
+    bool read() const;
+
+private:
+    ShiftRegisterOutput& chain;
+    std::size_t bit;
+};
+
+/**
+ * @brief One input bit of a 74HC165 chain, used like an input DigitalPin.
+ */
+class ShiftRegisterInputPin {
+public:
+    ShiftRegisterInputPin(ShiftRegisterInput& chain, std::size_t bit);
+
+    /**
+     * @brief Returns the bit from the latest sampled snapshot.
+     */
+    bool read() const;
+
+private:
+    ShiftRegisterInput& chain;
+    std::size_t bit;
+};
+
+/**
+ * @brief 74HC595 output chain with frame-coalesced updates.
+ *
+ * Bit writes only update a shadow register. Once per frame, if anything
+ * changed, the whole chain is shifted out and latched in one pass, so any
+ * number of changes within a frame cost a single shift. Bit 8 * n + k is
+ * output Qk (QA = 0 ... QH = 7) of the n-th register from the host, the same
+ * numbering ShiftRegisterInput uses.
+ */
+class ShiftRegisterOutput {
+public:
+    /**
+     * @brief Constructs an output chain.
+     * @param dataPin GPIO pin wired to SER.
+     * @param clockPin GPIO pin wired to SRCLK.
+     * @param latchPin GPIO pin wired to RCLK.
+     * @param bits Chain length; must be a multiple of 8.
+     * @param framePeriod Flush interval, or zero to flush only on flush().
+     * @param clockHz Shift clock frequency.
+     * @throws std::invalid_argument if bits is zero or not a multiple of 8.
+     */
+    ShiftRegisterOutput(int dataPin, int clockPin, int latchPin, std::size_t bits,
+                        std::chrono::microseconds framePeriod = std::chrono::milliseconds(1),
+                        uint32_t clockHz = 1000000);
+
+    ~ShiftRegisterOutput();
+
+    ShiftRegisterOutput(const ShiftRegisterOutput&) = delete;
+    ShiftRegisterOutput& operator=(const ShiftRegisterOutput&) = delete;
+
+    /**
+     * @brief Sets one bit in the shadow register.
+     * @throws std::out_of_range if bit is outside the chain.
+     * @throws The exception that stopped the flush thread, if a shift failed.
+     */
+    void set(std::size_t bit, bool level);
+
+    /**
+     * @brief Sets several of the first 64 bits in the shadow register under one lock.
+     * @param mask Bits to change (bit i is chain bit i).
+     * @param value New levels of the masked bits.
+     * @throws std::out_of_range if mask selects a bit outside the chain.
+     * @throws The exception that stopped the flush thread, if a shift failed.
+     */
+    void setMasked(uint64_t mask, uint64_t value);
+
+    /**
+     * @brief Returns one bit of the shadow register.
+     * @throws std::out_of_range if bit is outside the chain.
+     */
+    bool get(std::size_t bit) const;
+
+    /**
+     * @brief Shifts out and latches the shadow register if it changed.
+     *
+     * The register stays dirty until the shift succeeds, so the changes of
+     * a shift that throws are still pending for the next flush.
+     * @throws The exception that stopped the flush thread, if a shift failed.
+     */
+    void flush();
+
+    /**
+     * @brief Returns a virtual pin for one bit of the chain.
+     */
+    ShiftRegisterPin pin(std::size_t bit);
+
+    /**
+     * @brief Returns the number of shifts performed.
+     */
+    unsigned long shiftCount() const;
+
+    std::size_t size() const;
+
+private:
+    void run();
+    void workerFailed(std::exception_ptr error);
+
+    std::size_t bits;           ///< Declared first so the length is checked before the lines are claimed
+    SoftSpi spi;
+    std::chrono::microseconds framePeriod;
+
+    mutable std::mutex mtx;
+    std::mutex flushMtx;
+    std::condition_variable cv;
+    std::vector<uint8_t> shadow;
+    bool dirty;
+    bool running;
+    std::exception_ptr failure;
+    std::atomic<unsigned long> shifts;
+    std::thread worker;
+};
+
+/**
+ * @brief 74HC165 input chain sampled into a shared snapshot.
+ *
+ * A sampler thread loads and shifts in the whole chain at a fixed rate; reads
+ * of individual bits come from the snapshot and never touch the hardware.
+ * Bit 8 * n + k is input k (A = 0 ... H = 7) of the n-th register from the
+ * host, matching ShiftRegisterOutput.
+ */
+class ShiftRegisterInput {
+public:
+    /**
+     * @brief Constructs an input chain.
+     * @param dataPin GPIO pin wired to QH of the register nearest the host.
+     * @param clockPin GPIO pin wired to CLK.
+     * @param loadPin GPIO pin wired to SH/LD (active low).
+     * @param bits Chain length; must be a multiple of 8.
+     * @param samplePeriod Sampling interval, or zero to sample only on sample().
+     * @param clockHz Shift clock frequency.
+     * @throws std::invalid_argument if bits is zero or not a multiple of 8.
+     */
+    ShiftRegisterInput(int dataPin, int clockPin, int loadPin, std::size_t bits,
+                       std::chrono::microseconds samplePeriod = std::chrono::milliseconds(1),
+                       uint32_t clockHz = 1000000);
+
+    ~ShiftRegisterInput();
+
+    ShiftRegisterInput(const ShiftRegisterInput&) = delete;
+    ShiftRegisterInput& operator=(const ShiftRegisterInput&) = delete;
+
+    /**
+     * @brief Loads and shifts in the chain now, updating the snapshot.
+     * @throws The exception that stopped the sampler thread, if a shift failed.
+     */
+    void sample();
+
+    /**
+     * @brief Returns one bit of the latest snapshot.
+     * @throws std::out_of_range if bit is outside the chain.
+     * @throws The exception that stopped the sampler thread, if a shift failed.
+     */
+    bool get(std::size_t bit) const;
+
+    /**
+     * @brief Returns a copy of the latest snapshot, one byte per register.
+     *
+     * Byte n holds the register n-th from the host, input A in bit 0.
+     * @throws The exception that stopped the sampler thread, if a shift failed.
+     */
+    std::vector<uint8_t> snapshot() const;
+
+    /**
+     * @brief Returns a virtual input pin for one bit of the chain.
+     */
+    ShiftRegisterInputPin pin(std::size_t bit);
+
+    std::size_t size() const;
+
+private:
+    void run();
+    void workerFailed(std::exception_ptr error);
+
+    std::size_t bits;           ///< Declared first so the length is checked before the lines are claimed
+    SoftSpi spi;
+    DigitalPin load;
+    std::chrono::microseconds samplePeriod;
+
+    mutable std::mutex mtx;
+    std::mutex sampleMtx;
+    std::condition_variable cv;
+    std::vector<uint8_t> latest;
+    bool running;
+    std::exception_ptr failure;
+    std::thread worker;
+};
+
+#endif // SHIFTREGISTER_H
@@ -0,0 +1,160 @@
+#include "SoftI2c.h"
+
+#include <stdexcept>
+#include <string>
+
+SoftI2c::SoftI2c(int sdaPin, int sclPin, uint32_t clockHz, std::chrono::microseconds stretchTimeout)
+    : sda(sdaPin, "SoftI2c-SDA"),
+      scl(sclPin, "SoftI2c-SCL"),
+      halfPeriod(0),
+      stretchTimeout(stretchTimeout) {
+    if (clockHz == 0) {
+        throw std::invalid_argument("I2C clock must be non-zero");
+    }
+    halfPeriod = std::chrono::nanoseconds(500000000ULL / clockHz);
+}
+
+void SoftI2c::delayHalf() {
+    timer.sleepFor(halfPeriod);
+}
+
+void SoftI2c::sclRelease() {
+    scl.release();
+    // A slave may hold SCL low to stretch the clock.
+    auto deadline = PreciseTimer::Clock::now() + stretchTimeout;
+    while (!scl.read()) {
+        if (PreciseTimer::Clock::now() > deadline) {
+            throw std::runtime_error("I2C clock stretch timeout");
+        }
+    }
+}
+
+void SoftI2c::start() {
+    // Also serves as a repeated start when SCL is low mid-transaction.
+    sda.release();
+    sclRelease();
+    delayHalf();
+    sda.pullLow();
+    delayHalf();
+    scl.pullLow();
+}
+
+void SoftI2c::stop() {
+    sda.pullLow();
+    delayHalf();
+    sclRelease();
+    delayHalf();
+    sda.release();
+    delayHalf();
+}
+
+void SoftI2c::writeBit(bool bit) {
+    sda.write(bit);
+    delayHalf();
+    sclRelease();
+    delayHalf();
+    scl.pullLow();
+}
+
+bool SoftI2c::readBit() {
+    sda.release();
+    delayHalf();
+    sclRelease();
+    bool bit = sda.read();
+    delayHalf();
+    scl.pullLow();
+    return bit;
+}
+
+bool SoftI2c::writeByte(uint8_t byte) {
+    for (int i = 7; i >= 0; --i) {
+        writeBit((byte >> i) & 0x1);
+    }
+    return !readBit();
+}
+
+uint8_t SoftI2c::readByte(bool ack) {
+    uint8_t byte = 0;
+    for (int i = 0; i < 8; ++i) {
+        byte = static_cast<uint8_t>((byte << 1) | (readBit() ? 1 : 0));
+    }
+    writeBit(!ack);
+    return byte;
+}
+
+void SoftI2c::runMessage(const Message& message) {
+    start();
+    uint8_t addressByte = static_cast<uint8_t>((message.address << 1) | (message.read ? 1 : 0));
+    if (!writeByte(addressByte)) {
+        throw std::runtime_error("I2C NACK from address " + std::to_string(message.address));
+    }
+    for (std::size_t i = 0; i < message.length; ++i) {
+        if (message.read) {
+            message.data[i] = readByte(i + 1 < message.length);
+        } else if (!writeByte(message.data[i])) {
+            throw std::runtime_error("I2C NACK on data byte " + std::to_string(i) +
+                                     " to address " + std::to_string(message.address));
+        }
+    }
+}
+
+void SoftI2c::transfer(std::vector<Message>& messages) {
+    std::lock_guard<std::mutex> lock(mtx);
+    try {
+        for (const Message& message : messages) {
+            runMessage(message);
+        }
+    } catch (...) {
+        stop();
+        throw;
+    }
+    stop();
+}
+
+void SoftI2c::write(uint8_t address, const uint8_t* data, std::size_t length) {
+    std::vector<Message> messages{{address, false, const_cast<uint8_t*>(data), length}};
+    transfer(messages);
+}
+
+void SoftI2c::read(uint8_t address, uint8_t* data, std::size_t length) {
+    std::vector<Message> messages{{address, true, data, length}};
+    transfer(messages);
+}
+
+void SoftI2c::writeRead(uint8_t address, const uint8_t* tx, std::size_t txLength,
+                        uint8_t* rx, std::size_t rxLength) {
+    std::vector<Message> messages{
+        {address, false, const_cast<uint8_t*>(tx), txLength},
+        {address, true, rx, rxLength},
+    };
+    transfer(messages);
+}
+
+bool SoftI2c::probe(uint8_t address) {
+    std::lock_guard<std::mutex> lock(mtx);
+    bool ack = false;
+    try {
+        start();
+        ack = writeByte(static_cast<uint8_t>(address << 1));
+    } catch (...) {
+        stop();
+        throw;
+    }
+    stop();
+    return ack;
+}
+
+bool SoftI2c::recoverBus() {
+    std::lock_guard<std::mutex> lock(mtx);
+    sda.release();
+    for (int i = 0; i < 9 && !sda.read(); ++i) {
+        scl.pullLow();
+        delayHalf();
+        sclRelease();
+        delayHalf();
+    }
+    scl.pullLow();
+    delayHalf();
+    stop();
+    return sda.read() && scl.read();
+}
@@ -0,0 +1,102 @@
+#ifndef SOFTI2C_H
+#define SOFTI2C_H
+
+#include "OpenDrainPin.h"
+#include "PreciseTimer.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Bit-banged I2C master on two open-drain lines.
+ *
+ * Supports clock stretching, repeated starts, multi-byte transfers and bus
+ * recovery. A list of messages is executed as one transaction joined by
+ * repeated starts, and SDA is only written when its level changes.
+ */
+class SoftI2c {
+public:
+    /**
+     * @brief One segment of a combined transaction.
+     */
+    struct Message {
+        uint8_t address;        ///< 7-bit slave address
+        bool read;              ///< true to read into data, false to write from it
+        uint8_t* data;
+        std::size_t length;
+    };
+
+    /**
+     * @brief Constructs a SoftI2c master.
+     * @param sdaPin GPIO pin for SDA.
+     * @param sclPin GPIO pin for SCL.
+     * @param clockHz Target SCL frequency.
+     * @param stretchTimeout Maximum time a slave may hold SCL low.
+     * @throws std::invalid_argument if clockHz is zero.
+     */
+    SoftI2c(int sdaPin, int sclPin, uint32_t clockHz = 100000,
+            std::chrono::microseconds stretchTimeout = std::chrono::milliseconds(25));
+
+    /**
+     * @brief Writes bytes to a slave.
+     * @throws std::runtime_error on NACK or clock-stretch timeout.
+     */
+    void write(uint8_t address, const uint8_t* data, std::size_t length);
+
+    /**
+     * @brief Reads bytes from a slave.
+     * @throws std::runtime_error on NACK or clock-stretch timeout.
+     */
+    void read(uint8_t address, uint8_t* data, std::size_t length);
+
+    /**
+     * @brief Writes then reads using a repeated start (typical register read).
+     * @throws std::runtime_error on NACK or clock-stretch timeout.
+     */
+    void writeRead(uint8_t address, const uint8_t* tx, std::size_t txLength,
+                   uint8_t* rx, std::size_t rxLength);
+
+    /**
+     * @brief Executes messages as one transaction with repeated starts between them.
+     * @param messages Segments to execute in order.
+     * @throws std::runtime_error on NACK or clock-stretch timeout; a STOP is still sent.
+     */
+    void transfer(std::vector<Message>& messages);
+
+    /**
+     * @brief Checks whether a slave acknowledges its address.
+     * @return true if the address was ACKed.
+     */
+    bool probe(uint8_t address);
+
+    /**
+     * @brief Frees a bus held by a slave stuck mid-byte.
+     *
+     * Clocks SCL up to nine times until SDA is released, then issues a STOP.
+     * @return true if both lines read high afterwards.
+     */
+    bool recoverBus();
+
+private:
+    void delayHalf();
+    void sclRelease();
+    void start();
+    void stop();
+    void writeBit(bool bit);
+    bool readBit();
+    bool writeByte(uint8_t byte);
+    uint8_t readByte(bool ack);
+    void runMessage(const Message& message);
+
+    std::mutex mtx;
+    OpenDrainPin sda;
+    OpenDrainPin scl;
+    PreciseTimer timer;
+    std::chrono::nanoseconds halfPeriod;
+    std::chrono::microseconds stretchTimeout;
+};
+
+#endif // SOFTI2C_H
@@ -0,0 +1,144 @@
+#include "SoftSpi.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+SoftSpi::SoftSpi(int sckPin, int mosiPin, int misoPin, int csPin, const Config& config,
+                 const std::string& chipName)
+    : config(config),
+      halfPeriod(0),
+      outputs(outputPins(sckPin, mosiPin, csPin), DigitalPin::Direction::Output, "SoftSpi", chipName,
+              idleOutputs(mosiPin, csPin, config)),
+      sckBit(1),
+      mosiBit(mosiPin >= 0 ? 2 : 0),
+      csBit(csPin >= 0 ? (mosiPin >= 0 ? 4 : 2) : 0) {
+    validate(config);
+    if (misoPin >= 0) {
+        miso = std::make_unique<DigitalPort>(std::vector<unsigned int>{static_cast<unsigned int>(misoPin)},
+                                             DigitalPin::Direction::Input, "SoftSpi-MISO", chipName);
+    }
+    halfPeriod = std::chrono::nanoseconds(500000000ULL / config.clockHz);
+}
+
+std::vector<unsigned int> SoftSpi::outputPins(int sckPin, int mosiPin, int csPin) {
+    if (sckPin < 0) {
+        throw std::invalid_argument("SPI needs an SCK pin");
+    }
+    std::vector<unsigned int> pins{static_cast<unsigned int>(sckPin)};
+    if (mosiPin >= 0) {
+        pins.push_back(static_cast<unsigned int>(mosiPin));
+    }
+    if (csPin >= 0) {
+        pins.push_back(static_cast<unsigned int>(csPin));
+    }
+    return pins;
+}
+
+uint64_t SoftSpi::idleOutputs(int mosiPin, int csPin, const Config& config) {
+    // Requested with SCK at its idle level, MOSI low and chip select released,
+    // so an active-low CS is never asserted while the lines come up.
+    uint64_t value = (config.mode & 0x2) ? 1 : 0;
+    if (csPin >= 0) {
+        value |= uint64_t(1) << (mosiPin >= 0 ? 2 : 1);
+    }
+    return value;
+}
+
+void SoftSpi::validate(const Config& config) {
+    if (config.mode < 0 || config.mode > 3) {
+        throw std::invalid_argument("SPI mode must be 0-3");
+    }
+    if (config.clockHz == 0) {
+        throw std::invalid_argument("SPI clock must be non-zero");
+    }
+}
+
+void SoftSpi::setConfig(const Config& newConfig) {
+    validate(newConfig);
+    std::lock_guard<std::mutex> lock(mtx);
+    config = newConfig;
+    halfPeriod = std::chrono::nanoseconds(500000000ULL / config.clockHz);
+    outputs.writeMasked(sckBit, idleSck());
+}
+
+uint64_t SoftSpi::idleSck() const {
+    // Idle clock level follows CPOL.
+    return (config.mode & 0x2) ? sckBit : 0;
+}
+
+SoftSpi::ChipSelect::ChipSelect(SoftSpi& spi) : spi(spi) {
+    if (spi.csBit) {
+        spi.outputs.writeMasked(spi.csBit, 0);
+    }
+}
+
+SoftSpi::ChipSelect::~ChipSelect() {
+    if (!spi.csBit) {
+        return;
+    }
+    try {
+        spi.outputs.writeMasked(spi.csBit | spi.sckBit, spi.csBit | spi.idleSck());
+    } catch (...) {
+        // Nothing more can be done for the line from a destructor.
+    }
+}
+
+void SoftSpi::transfer(const uint8_t* tx, uint8_t* rx, std::size_t length) {
+    std::lock_guard<std::mutex> lock(mtx);
+    const uint64_t idle = idleSck();
+    const uint64_t active = idle ^ sckBit;
+    const uint64_t mask = sckBit | mosiBit;
+    const bool cpha = (config.mode & 0x1) != 0;
+    const bool msbFirst = config.bitOrder == BitOrder::MsbFirst;
+    const std::size_t bits = length * 8;
+
+    auto shiftOf = [msbFirst](std::size_t n) { return msbFirst ? 7 - n % 8 : n % 8; };
+    // MOSI bit of bit n of the transfer, already in port position.
+    auto dataOf = [&](std::size_t n) -> uint64_t {
+        const uint8_t byte = tx ? tx[n / 8] : 0x00;
+        return ((byte >> shiftOf(n)) & 0x1) ? mosiBit : 0;
+    };
+
+    if (rx) {
+        std::fill(rx, rx + length, 0);
+    }
+    ChipSelect select(*this);
+    auto deadline = PreciseTimer::Clock::now();
+    if (!cpha && bits != 0) {
+        // Data valid before the first leading edge.
+        outputs.writeMasked(mask, idle | dataOf(0));
+    }
+    for (std::size_t n = 0; n < bits; ++n) {
+        const uint64_t data = dataOf(n);
+        bool inBit = false;
+        if (!cpha) {
+            // Sampled on the leading edge; the trailing edge also sets up the next bit.
+            deadline += halfPeriod;
+            timer.sleepUntil(deadline);
+            outputs.writeMasked(mask, active | data);
+            inBit = miso && (miso->read() & 0x1);
+            deadline += halfPeriod;
+            timer.sleepUntil(deadline);
+            outputs.writeMasked(mask, idle | (n + 1 < bits ? dataOf(n + 1) : data));
+        } else {
+            // Data shifted on the leading edge, sampled on the trailing edge.
+            outputs.writeMasked(mask, active | data);
+            deadline += halfPeriod;
+            timer.sleepUntil(deadline);
+            outputs.writeMasked(mask, idle | data);
+            inBit = miso && (miso->read() & 0x1);
+            deadline += halfPeriod;
+            timer.sleepUntil(deadline);
+        }
+
+        if (rx && inBit) {
+            rx[n / 8] |= static_cast<uint8_t>(1u << shiftOf(n));
+        }
+    }
+}
+
+std::vector<uint8_t> SoftSpi::transfer(const std::vector<uint8_t>& tx) {
+    std::vector<uint8_t> rx(tx.size());
+    transfer(tx.data(), rx.data(), tx.size());
+    return rx;
+}
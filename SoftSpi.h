@@ -0,0 +1,108 @@
+#ifndef SOFTSPI_H
+#define SOFTSPI_H
+
+#include "DigitalPort.h"
+#include "PreciseTimer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Bus configuration for SoftSpi.
+ */
+struct SoftSpiConfig {
+    enum class BitOrder { MsbFirst, LsbFirst };
+
+    int mode = 0;                       ///< SPI mode 0-3 (CPOL = bit 1, CPHA = bit 0)
+    BitOrder bitOrder = BitOrder::MsbFirst;
+    uint32_t clockHz = 100000;          ///< Target SCK frequency
+};
+
+/**
+ * @brief Bit-banged SPI master built on a DigitalPort.
+ *
+ * Supports SPI modes 0-3, MSB- or LSB-first bit order and a configurable
+ * clock rate. SCK, MOSI and CS share one output DigitalPort, so each half
+ * clock is a single bulk write that moves SCK and MOSI together: two writes
+ * per bit whatever the data. Chip select is released on every exit path,
+ * including a failed write.
+ */
+class SoftSpi {
+public:
+    using Config = SoftSpiConfig;
+    using BitOrder = SoftSpiConfig::BitOrder;
+
+    /**
+     * @brief Constructs a SoftSpi master.
+     * @param sckPin GPIO pin for SCK.
+     * @param mosiPin GPIO pin for MOSI, or -1 for a read-only bus.
+     * @param misoPin GPIO pin for MISO, or -1 for a write-only bus.
+     * @param csPin GPIO pin for an active-low chip select, or -1 if managed externally.
+     * @param config Bus mode, bit order and clock rate.
+     * @param chipName GPIO chip holding all the lines.
+     * @throws std::invalid_argument if the configuration is invalid.
+     * @throws std::runtime_error if the lines cannot be requested.
+     */
+    SoftSpi(int sckPin, int mosiPin, int misoPin, int csPin, const Config& config = Config(),
+            const std::string& chipName = "gpiochip0");
+
+    /**
+     * @brief Performs a full-duplex transfer with chip select asserted throughout.
+     * @param tx Bytes to send, or nullptr to send 0x00.
+     * @param rx Buffer for received bytes, or nullptr to discard them.
+     * @param length Number of bytes to transfer.
+     */
+    void transfer(const uint8_t* tx, uint8_t* rx, std::size_t length);
+
+    /**
+     * @brief Performs a full-duplex transfer and returns the received bytes.
+     * @param tx Bytes to send.
+     * @return Bytes clocked in on MISO (zeros if no MISO pin).
+     */
+    std::vector<uint8_t> transfer(const std::vector<uint8_t>& tx);
+
+    /**
+     * @brief Changes bus mode, bit order or clock rate.
+     * @param config New configuration.
+     * @throws std::invalid_argument if the configuration is invalid.
+     */
+    void setConfig(const Config& config);
+
+private:
+    /**
+     * @brief Asserts chip select for its lifetime and returns SCK to idle when it ends.
+     */
+    class ChipSelect {
+    public:
+        explicit ChipSelect(SoftSpi& spi);
+        ~ChipSelect();
+
+        ChipSelect(const ChipSelect&) = delete;
+        ChipSelect& operator=(const ChipSelect&) = delete;
+
+    private:
+        SoftSpi& spi;
+    };
+
+    uint64_t idleSck() const;
+    static void validate(const Config& config);
+    static std::vector<unsigned int> outputPins(int sckPin, int mosiPin, int csPin);
+    static uint64_t idleOutputs(int mosiPin, int csPin, const Config& config);
+
+    std::mutex mtx;
+    Config config;
+    PreciseTimer timer;
+    std::chrono::nanoseconds halfPeriod;
+
+    DigitalPort outputs;                    ///< SCK at bit 0, then MOSI and CS when present
+    std::unique_ptr<DigitalPort> miso;
+    uint64_t sckBit;
+    uint64_t mosiBit;                       ///< 0 on a read-only bus
+    uint64_t csBit;                         ///< 0 when chip select is managed externally
+};
+
+#endif // SOFTSPI_H
@@ -0,0 +1,72 @@
+#include "SoftUart.h"
+
+#include <stdexcept>
+
+SoftUart::SoftUart(int txPin, const Config& config)
+    : config(config),
+      bitTime(0),
+      txLevel(true),
+      receiver(config) {
+    bitTime = std::chrono::nanoseconds(1000000000ULL / config.baud);
+    if (txPin >= 0) {
+        tx = std::make_unique<DigitalPin>(txPin, DigitalPin::Direction::Output, "SoftUart-TX");
+        tx->write(true);
+    }
+}
+
+int SoftUart::frameBits() const {
+    return SoftUartReceiver::frameBits(config);
+}
+
+void SoftUart::write(const uint8_t* data, std::size_t length) {
+    if (!tx) {
+        throw std::runtime_error("SoftUart has no TX pin");
+    }
+    std::lock_guard<std::mutex> lock(txMtx);
+    std::vector<bool> bits;
+    bits.reserve(frameBits());
+
+    auto deadline = PreciseTimer::now();
+    for (std::size_t n = 0; n < length; ++n) {
+        bits.clear();
+        bits.push_back(false);
+        for (int i = 0; i < config.dataBits; ++i) {
+            bits.push_back((data[n] >> i) & 0x1);
+        }
+        if (config.parity != Parity::None) {
+            bits.push_back(SoftUartReceiver::parityBit(config, data[n]));
+        }
+        for (int i = 0; i < config.stopBits; ++i) {
+            bits.push_back(true);
+        }
+
+        for (bool bit : bits) {
+            if (bit != txLevel) {
+                tx->write(bit);
+                txLevel = bit;
+            }
+            deadline += bitTime;
+            timer.sleepUntil(deadline);
+        }
+    }
+}
+
+void SoftUart::write(const std::vector<uint8_t>& data) {
+    write(data.data(), data.size());
+}
+
+void SoftUart::onEdge(const EdgeEvent& event) {
+    receiver.onEdge(event);
+}
+
+void SoftUart::poll(std::chrono::nanoseconds now) {
+    receiver.poll(now);
+}
+
+std::vector<uint8_t> SoftUart::readAvailable() {
+    return receiver.readAvailable();
+}
+
+SoftUart::Stats SoftUart::stats() const {
+    return receiver.stats();
+}
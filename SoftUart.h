@@ -0,0 +1,91 @@
+#ifndef SOFTUART_H
+#define SOFTUART_H
+
+#include "DigitalPin.h"
+#include "EdgeEvent.h"
+#include "PreciseTimer.h"
+#include "SoftUartReceiver.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Software UART with a timed transmitter and an edge-driven receiver.
+ *
+ * Transmission writes each bit at an absolute deadline with PreciseTimer, so
+ * bit timing does not drift across a frame. Reception never samples the line:
+ * the caller feeds edge events on RX to an embedded SoftUartReceiver, which
+ * reconstructs bits from the time between edges. Call poll() periodically so
+ * a frame that ends in high bits (and thus has no closing edge) is completed.
+ */
+class SoftUart {
+public:
+    using Config = SoftUartConfig;
+    using Parity = SoftUartConfig::Parity;
+    using Stats = SoftUartReceiver::Stats;
+
+    /**
+     * @brief Constructs a SoftUart.
+     * @param txPin GPIO pin for TX, or -1 for a receive-only port.
+     * @param config Line settings.
+     * @throws std::invalid_argument if the settings are invalid.
+     */
+    SoftUart(int txPin, const Config& config = Config());
+
+    /**
+     * @brief Transmits bytes, blocking until the last stop bit has been sent.
+     * @param data Bytes to send.
+     * @param length Number of bytes.
+     * @throws std::runtime_error if the port has no TX pin.
+     */
+    void write(const uint8_t* data, std::size_t length);
+
+    /**
+     * @brief Transmits a byte vector.
+     */
+    void write(const std::vector<uint8_t>& data);
+
+    /**
+     * @brief Feeds an RX edge event to the receiver.
+     * @param event Edge on the RX line; events must arrive in time order.
+     */
+    void onEdge(const EdgeEvent& event);
+
+    /**
+     * @brief Advances the receiver to the given time with no further edges.
+     * @param now Current monotonic time in nanoseconds.
+     */
+    void poll(std::chrono::nanoseconds now);
+
+    /**
+     * @brief Removes and returns all bytes received so far.
+     */
+    std::vector<uint8_t> readAvailable();
+
+    /**
+     * @brief Returns receiver statistics.
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Returns the number of bit times in one frame, start and stop bits included.
+     */
+    int frameBits() const;
+
+private:
+    Config config;
+    std::chrono::nanoseconds bitTime;
+    PreciseTimer timer;
+
+    std::mutex txMtx;
+    std::unique_ptr<DigitalPin> tx;
+    bool txLevel;
+
+    SoftUartReceiver receiver;
+};
+
+#endif // SOFTUART_H
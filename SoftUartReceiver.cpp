@@ -0,0 +1,106 @@
+#include "SoftUartReceiver.h"
+
+#include <stdexcept>
+
+SoftUartReceiver::SoftUartReceiver(const Config& config)
+    : config(config),
+      bitTime(0),
+      rxLevel(true),
+      inFrame(false),
+      frameStart(0),
+      bitIndex(0) {
+    validate(config);
+    bitTime = std::chrono::nanoseconds(1000000000ULL / config.baud);
+    frame.resize(frameBits(config));
+}
+
+void SoftUartReceiver::validate(const Config& config) {
+    if (config.baud == 0) {
+        throw std::invalid_argument("UART baud rate must be non-zero");
+    }
+    if (config.dataBits < 5 || config.dataBits > 8) {
+        throw std::invalid_argument("UART data bits must be 5-8");
+    }
+    if (config.stopBits != 1 && config.stopBits != 2) {
+        throw std::invalid_argument("UART stop bits must be 1 or 2");
+    }
+}
+
+int SoftUartReceiver::frameBits(const Config& config) {
+    return 1 + config.dataBits + (config.parity == Parity::None ? 0 : 1) + config.stopBits;
+}
+
+bool SoftUartReceiver::parityBit(const Config& config, uint8_t data) {
+    bool odd = false;
+    for (int i = 0; i < config.dataBits; ++i) {
+        odd ^= (data >> i) & 0x1;
+    }
+    return config.parity == Parity::Even ? odd : !odd;
+}
+
+void SoftUartReceiver::sampleUntil(std::chrono::nanoseconds time) {
+    // The line held rxLevel since the last edge; assign it to every bit whose
+    // centre lies before the given time.
+    while (inFrame && frameStart + bitTime * bitIndex + bitTime / 2 < time) {
+        frame[bitIndex] = rxLevel;
+        if (bitIndex == 0 && rxLevel) {
+            ++rxStats.falseStarts;
+            inFrame = false;
+            return;
+        }
+        if (++bitIndex == frameBits(config)) {
+            finishFrame();
+        }
+    }
+}
+
+void SoftUartReceiver::finishFrame() {
+    inFrame = false;
+    uint8_t data = 0;
+    for (int i = 0; i < config.dataBits; ++i) {
+        if (frame[1 + i]) {
+            data |= static_cast<uint8_t>(1u << i);
+        }
+    }
+    int index = 1 + config.dataBits;
+    if (config.parity != Parity::None && frame[index++] != parityBit(config, data)) {
+        ++rxStats.parityErrors;
+        return;
+    }
+    for (int i = 0; i < config.stopBits; ++i) {
+        if (!frame[index + i]) {
+            ++rxStats.framingErrors;
+            return;
+        }
+    }
+    received.push_back(data);
+    ++rxStats.bytesReceived;
+}
+
+void SoftUartReceiver::onEdge(const EdgeEvent& event) {
+    std::lock_guard<std::mutex> lock(mtx);
+    sampleUntil(event.timestamp);
+    rxLevel = event.rising;
+    if (!inFrame && !event.rising) {
+        inFrame = true;
+        frameStart = event.timestamp;
+        bitIndex = 0;
+    }
+}
+
+void SoftUartReceiver::poll(std::chrono::nanoseconds now) {
+    std::lock_guard<std::mutex> lock(mtx);
+    sampleUntil(now);
+}
+
+std::vector<uint8_t> SoftUartReceiver::readAvailable() {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<uint8_t> bytes(received.begin(), received.end());
+    received.clear();
+    return bytes;
+}
+
+SoftUartReceiver::Stats SoftUartReceiver::stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return rxStats;
+}
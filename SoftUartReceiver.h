@@ -0,0 +1,105 @@
+#ifndef SOFTUARTRECEIVER_H
+#define SOFTUARTRECEIVER_H
+
+#include "EdgeEvent.h"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Line settings for SoftUart.
+ */
+struct SoftUartConfig {
+    enum class Parity { None, Even, Odd };
+
+    uint32_t baud = 9600;
+    int dataBits = 8;                   ///< 5-8
+    Parity parity = Parity::None;
+    int stopBits = 1;                   ///< 1 or 2
+};
+
+/**
+ * @brief UART receive decoder driven purely by RX edge timestamps.
+ *
+ * The line is never sampled: the level between two edges is assigned to
+ * every bit whose centre falls between them, re-synchronising on each start
+ * bit's falling edge. Call poll() periodically so a frame that ends in high
+ * bits (and thus has no closing edge) is completed. SoftUart embeds one for
+ * its RX side; it needs no GPIO access of its own.
+ */
+class SoftUartReceiver {
+public:
+    using Config = SoftUartConfig;
+    using Parity = SoftUartConfig::Parity;
+
+    struct Stats {
+        unsigned long bytesReceived = 0;
+        unsigned long parityErrors = 0;
+        unsigned long framingErrors = 0;
+        unsigned long falseStarts = 0;  ///< Start bits that were high at mid-bit
+    };
+
+    /**
+     * @brief Constructs a receiver.
+     * @param config Line settings.
+     * @throws std::invalid_argument if the settings are invalid.
+     */
+    explicit SoftUartReceiver(const Config& config = Config());
+
+    /**
+     * @brief Feeds an RX edge event.
+     * @param event Edge on the RX line; events must arrive in time order.
+     */
+    void onEdge(const EdgeEvent& event);
+
+    /**
+     * @brief Advances the decoder to the given time with no further edges.
+     * @param now Current monotonic time in nanoseconds.
+     */
+    void poll(std::chrono::nanoseconds now);
+
+    /**
+     * @brief Removes and returns all bytes received so far.
+     */
+    std::vector<uint8_t> readAvailable();
+
+    /**
+     * @brief Returns receiver statistics.
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Throws std::invalid_argument unless the settings are usable.
+     */
+    static void validate(const Config& config);
+
+    /**
+     * @brief Returns the number of bit times in one frame, start and stop bits included.
+     */
+    static int frameBits(const Config& config);
+
+    /**
+     * @brief Returns the parity bit sent with a data word.
+     */
+    static bool parityBit(const Config& config, uint8_t data);
+
+private:
+    void sampleUntil(std::chrono::nanoseconds time);
+    void finishFrame();
+
+    mutable std::mutex mtx;
+    Config config;
+    std::chrono::nanoseconds bitTime;
+    bool rxLevel;
+    bool inFrame;
+    std::chrono::nanoseconds frameStart;
+    int bitIndex;
+    std::vector<bool> frame;
+    std::deque<uint8_t> received;
+    Stats rxStats;
+};
+
+#endif // SOFTUARTRECEIVER_H
@@ -0,0 +1,69 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer ring buffer.
+ *
+ * One thread may push and one other thread may pop concurrently without
+ * locks. Capacity is rounded up to a power of two.
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity) : head(0), tail(0) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        buffer.resize(size);
+        mask = size - 1;
+    }
+
+    /**
+     * @brief Appends an item (producer thread only).
+     * @return false if the ring is full and the item was dropped.
+     */
+    bool push(const T& item) {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask) {
+            return false;
+        }
+        buffer[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest item (consumer thread only).
+     * @return false if the ring is empty.
+     */
+    bool pop(T& item) {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = buffer[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const {
+        return mask + 1;
+    }
+
+private:
+    std::vector<T> buffer;
+    std::size_t mask;
+    alignas(64) std::atomic<std::size_t> head;
+    alignas(64) std::atomic<std::size_t> tail;
+};
+
+#endif // SPSCRING_H
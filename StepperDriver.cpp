@@ -0,0 +1,303 @@
+#include "StepperDriver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+namespace {
+constexpr double PI = 3.14159265358979323846;
+constexpr std::chrono::microseconds DIR_SETUP(5);
+
+// S-curve ramp from rest to vmax over time T = 2 * vmax / a with sinusoidal
+// acceleration: v(t) = vmax * (t/T - sin(2 pi t/T) / 2 pi).
+double sCurveSpeed(double t, double vmax, double T) {
+    return vmax * (t / T - std::sin(2 * PI * t / T) / (2 * PI));
+}
+
+double sCurveDistance(double t, double vmax, double T) {
+    return vmax * (t * t / (2 * T) + T * (std::cos(2 * PI * t / T) - 1) / (4 * PI * PI));
+}
+
+// Velocity reached after accelerating from rest over the given distance.
+double rampSpeed(double distance, const StepperProfile& profile) {
+    if (distance <= 0) {
+        return 0.0;
+    }
+    if (profile.shape == StepperProfile::Shape::Trapezoidal) {
+        return std::min(profile.maxSpeed, std::sqrt(2 * profile.acceleration * distance));
+    }
+    const double vmax = profile.maxSpeed;
+    const double T = 2 * vmax / profile.acceleration;
+    if (distance >= vmax * T / 2) {
+        return vmax;
+    }
+    double lo = 0.0;
+    double hi = T;
+    for (int i = 0; i < 60; ++i) {
+        double mid = (lo + hi) / 2;
+        (sCurveDistance(mid, vmax, T) < distance ? lo : hi) = mid;
+    }
+    return sCurveSpeed(hi, vmax, T);
+}
+
+// Distance needed to accelerate from rest to the given speed (or stop from it).
+double rampDistance(double speed, const StepperProfile& profile) {
+    speed = std::min(speed, profile.maxSpeed);
+    if (speed <= 0) {
+        return 0.0;
+    }
+    if (profile.shape == StepperProfile::Shape::Trapezoidal) {
+        return speed * speed / (2 * profile.acceleration);
+    }
+    const double vmax = profile.maxSpeed;
+    const double T = 2 * vmax / profile.acceleration;
+    double lo = 0.0;
+    double hi = T;
+    for (int i = 0; i < 60; ++i) {
+        double mid = (lo + hi) / 2;
+        (sCurveSpeed(mid, vmax, T) < speed ? lo : hi) = mid;
+    }
+    return sCurveDistance(hi, vmax, T);
+}
+} // namespace
+
+StepperDriver::StepperDriver(int stepPin, int dirPin, const Profile& profile,
+                             std::chrono::nanoseconds pulseWidth, int rtPriority)
+    : stepPin(stepPin, DigitalPin::Direction::Output, "StepperDriver-STEP"),
+      dirPin(dirPin, DigitalPin::Direction::Output, "StepperDriver-DIR"),
+      profile(profile),
+      pulseWidth(pulseWidth),
+      cruiseInterval(0),
+      lastInterval(0),
+      targetPos(0),
+      retarget(false),
+      running(true),
+      pos(0),
+      moving(false),
+      speed(0.0),
+      direction(true) {
+    if (profile.maxSpeed <= 0 || profile.acceleration <= 0) {
+        throw std::invalid_argument("Stepper speed and acceleration must be positive");
+    }
+    ramp = buildRamp(profile);
+    cruiseInterval = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / profile.maxSpeed));
+    this->stepPin.write(false);
+    this->dirPin.write(direction);
+
+    worker = PreciseTimer::startThread(rtPriority, [this]() { run(); },
+                                       [this](std::exception_ptr error) { workerFailed(error); });
+}
+
+StepperDriver::~StepperDriver() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+        retarget = true;
+    }
+    cv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+std::vector<std::chrono::nanoseconds> StepperDriver::buildRamp(const Profile& profile) {
+    // Speed at the middle of each step, until the ramp reaches maxSpeed.
+    std::vector<std::chrono::nanoseconds> intervals;
+    for (uint64_t i = 0;; ++i) {
+        const double v = rampSpeed(i + 0.5, profile);
+        if (v >= profile.maxSpeed) {
+            break;
+        }
+        intervals.emplace_back(static_cast<int64_t>(1e9 / v));
+    }
+    return intervals;
+}
+
+std::chrono::nanoseconds StepperDriver::stepInterval(uint64_t accelIndex, uint64_t decelIndex) const {
+    // Limited by the acceleration ramp from the start speed and by the
+    // deceleration ramp to rest at the end; past both, the motor cruises.
+    const auto at = [this](uint64_t i) { return i < ramp.size() ? ramp[i] : cruiseInterval; };
+    return std::max(at(accelIndex), at(decelIndex));
+}
+
+uint64_t StepperDriver::stoppingDistance(double speed, const Profile& profile) {
+    return static_cast<uint64_t>(std::ceil(rampDistance(speed, profile)));
+}
+
+void StepperDriver::emitStep(PreciseTimer::Clock::time_point deadline) {
+    timer.sleepUntil(deadline);
+    auto late = PreciseTimer::Clock::now() - deadline;
+    stepPin.write(true);
+    timer.sleepFor(pulseWidth);
+    stepPin.write(false);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    auto lateNs = std::chrono::duration_cast<std::chrono::nanoseconds>(late);
+    ++stats.steps;
+    stats.totalLateness += lateNs;
+    stats.maxLateness = std::max(stats.maxLateness, lateNs);
+    std::size_t bucket = 0;
+    const std::size_t buckets = sizeof(stats.histogram) / sizeof(stats.histogram[0]);
+    while (bucket + 1 < buckets && lateNs >= std::chrono::microseconds(1LL << bucket)) {
+        ++bucket;
+    }
+    ++stats.histogram[bucket];
+}
+
+void StepperDriver::run() {
+    auto deadline = PreciseTimer::Clock::now();
+    while (true) {
+        uint64_t steps = 0;
+        uint64_t accelIndex = 0;
+        bool fromRest = false;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this]() { return !running || targetPos != pos.load() || speed.load() > 0; });
+            if (!running) {
+                return;
+            }
+            retarget = false;
+
+            const int64_t remaining = targetPos - pos.load();
+            const bool wantForward = remaining > 0;
+            const uint64_t distance = static_cast<uint64_t>(std::llabs(remaining));
+            const double startSpeed = speed.load();
+            const uint64_t stopSteps = stoppingDistance(startSpeed, profile);
+            fromRest = startSpeed <= 0;
+
+            if (!fromRest && (wantForward != direction || distance < stopSteps)) {
+                // Cannot reach the target in this direction without overshooting:
+                // decelerate to rest, then re-plan from there.
+                steps = stopSteps;
+            } else {
+                steps = distance;
+                if (wantForward != direction) {
+                    direction = wantForward;
+                    dirPin.write(direction);
+                    timer.sleepFor(DIR_SETUP);
+                }
+            }
+            if (!fromRest) {
+                // Carry on from the ramp step after the last one emitted.
+                accelIndex = static_cast<uint64_t>(
+                    std::upper_bound(ramp.begin(), ramp.end(), lastInterval, std::greater<std::chrono::nanoseconds>()) -
+                    ramp.begin());
+            }
+            moving = true;
+        }
+
+        // A retarget mid-move stays on the running timeline; only a move from
+        // rest starts from the current time.
+        if (fromRest) {
+            deadline = std::max(deadline, PreciseTimer::Clock::now());
+        }
+        bool interrupted = false;
+        for (uint64_t i = 0; i < steps; ++i) {
+            const auto interval = stepInterval(accelIndex + i, steps - i - 1);
+            deadline += interval;
+            emitStep(deadline);
+            pos.fetch_add(direction ? 1 : -1);
+            lastInterval = interval;
+            speed = 1e9 / interval.count();
+
+            std::lock_guard<std::mutex> lock(mtx);
+            if (retarget) {
+                interrupted = true;
+                break;
+            }
+        }
+        if (!interrupted) {
+            speed = 0.0;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!interrupted && targetPos == pos.load()) {
+                moving = false;
+            }
+        }
+        cv.notify_all();
+    }
+}
+
+void StepperDriver::moveTo(int64_t target) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        targetPos = target;
+        retarget = true;
+    }
+    cv.notify_all();
+}
+
+void StepperDriver::move(int64_t delta) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        targetPos += delta;
+        retarget = true;
+    }
+    cv.notify_all();
+}
+
+void StepperDriver::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        const int64_t stopSteps = static_cast<int64_t>(stoppingDistance(speed.load(), profile));
+        targetPos = pos.load() + (direction ? stopSteps : -stopSteps);
+        retarget = true;
+    }
+    cv.notify_all();
+}
+
+bool StepperDriver::waitUntilIdle(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mtx);
+    auto idle = [this]() { return failure || (!moving.load() && targetPos == pos.load()); };
+    bool done = true;
+    if (timeout == std::chrono::milliseconds::max()) {
+        cv.wait(lock, idle);
+    } else {
+        done = cv.wait_for(lock, timeout, idle);
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    return done;
+}
+
+void StepperDriver::workerFailed(std::exception_ptr error) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        failure = error;
+        running = false;
+        moving = false;
+        speed = 0.0;
+    }
+    cv.notify_all();
+}
+
+int64_t StepperDriver::position() const {
+    return pos.load();
+}
+
+int64_t StepperDriver::target() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return targetPos;
+}
+
+bool StepperDriver::isMoving() const {
+    return moving.load();
+}
+
+StepperDriver::TimingStats StepperDriver::timingStats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return stats;
+}
@@ -0,0 +1,147 @@
+#ifndef STEPPERDRIVER_H
+#define STEPPERDRIVER_H
+
+#include "DigitalPin.h"
+#include "PreciseTimer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Motion limits and ramp shape for StepperDriver.
+ */
+struct StepperProfile {
+    enum class Shape { Trapezoidal, SCurve };
+
+    double maxSpeed = 1000.0;           ///< steps/s
+    double acceleration = 4000.0;       ///< steps/s^2 (peak for S-curve)
+    Shape shape = Shape::Trapezoidal;
+};
+
+/**
+ * @brief Step/dir stepper driver with precomputed acceleration profiles.
+ *
+ * The ramp from rest to maxSpeed is tabulated once, one interval per step, at
+ * construction. Each step of a move takes the longer of its interval on the
+ * acceleration ramp and on the deceleration ramp to the target, or the cruise
+ * interval once past both, so a move costs O(1) per step however long its
+ * cruise. A dedicated thread emits the pulses at absolute PreciseTimer
+ * deadlines, so the step count is exact and timing does not accumulate error.
+ * A new target issued mid-move is re-planned from the current speed on the
+ * same deadline timeline, decelerating first if the new target requires
+ * reversing. If a pin write fails, the thread stops and moveTo(), move(),
+ * stop() and waitUntilIdle() rethrow its exception.
+ */
+class StepperDriver {
+public:
+    using Profile = StepperProfile;
+
+    /**
+     * @brief Lateness of emitted steps relative to their planned deadlines.
+     */
+    struct TimingStats {
+        uint64_t steps = 0;
+        std::chrono::nanoseconds maxLateness{0};
+        std::chrono::nanoseconds totalLateness{0};
+        /// histogram[i] counts steps late by less than 2^i microseconds (last bucket: the rest)
+        uint64_t histogram[12] = {};
+    };
+
+    /**
+     * @brief Constructs a driver and starts its pulse thread.
+     * @param stepPin GPIO pin for STEP.
+     * @param dirPin GPIO pin for DIR (high = positive direction).
+     * @param profile Speed and acceleration limits.
+     * @param pulseWidth STEP high time.
+     * @param rtPriority SCHED_FIFO priority for the pulse thread, or 0 to leave it unchanged.
+     * @throws std::invalid_argument if the profile limits are not positive.
+     */
+    StepperDriver(int stepPin, int dirPin, const Profile& profile = Profile(),
+                  std::chrono::nanoseconds pulseWidth = std::chrono::microseconds(2),
+                  int rtPriority = 0);
+
+    /**
+     * @brief Stops the pulse thread immediately (no deceleration).
+     */
+    ~StepperDriver();
+
+    StepperDriver(const StepperDriver&) = delete;
+    StepperDriver& operator=(const StepperDriver&) = delete;
+
+    /**
+     * @brief Moves to an absolute position, retargeting any move in progress.
+     */
+    void moveTo(int64_t target);
+
+    /**
+     * @brief Moves by a relative number of steps from the current target.
+     */
+    void move(int64_t delta);
+
+    /**
+     * @brief Decelerates to a stop as quickly as the profile allows.
+     */
+    void stop();
+
+    /**
+     * @brief Blocks until the motor reaches its target.
+     * @return false if the timeout expired first.
+     */
+    bool waitUntilIdle(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    int64_t position() const;
+    int64_t target() const;
+    bool isMoving() const;
+
+    TimingStats timingStats() const;
+
+    /**
+     * @brief Tabulates the acceleration ramp from rest.
+     * @param profile Limits and ramp shape.
+     * @return Interval of each step of the ramp, up to the step that reaches maxSpeed.
+     */
+    static std::vector<std::chrono::nanoseconds> buildRamp(const Profile& profile);
+
+    /**
+     * @brief Returns the number of steps needed to stop from the given speed.
+     */
+    static uint64_t stoppingDistance(double speed, const Profile& profile);
+
+private:
+    void run();
+    void workerFailed(std::exception_ptr error);
+    void emitStep(PreciseTimer::Clock::time_point deadline);
+    std::chrono::nanoseconds stepInterval(uint64_t accelIndex, uint64_t decelIndex) const;
+
+    DigitalPin stepPin;
+    DigitalPin dirPin;
+    Profile profile;
+    std::chrono::nanoseconds pulseWidth;
+    std::vector<std::chrono::nanoseconds> ramp;
+    std::chrono::nanoseconds cruiseInterval;
+    std::chrono::nanoseconds lastInterval;      ///< Interval of the last step emitted
+    PreciseTimer timer;
+
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    int64_t targetPos;
+    bool retarget;
+    bool running;
+    std::exception_ptr failure;
+    TimingStats stats;
+
+    std::atomic<int64_t> pos;
+    std::atomic<bool> moving;
+    std::atomic<double> speed;
+    bool direction;
+
+    std::thread worker;
+};
+
+#endif // STEPPERDRIVER_H
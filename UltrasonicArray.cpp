@@ -0,0 +1,153 @@
+#include "UltrasonicArray.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace {
+constexpr std::chrono::microseconds TRIGGER_PULSE(10);
+} // namespace
+
+UltrasonicArray::UltrasonicArray(const std::vector<int>& triggerPins, unsigned int rate,
+                                 std::chrono::milliseconds timeout, Callback callback, int rtPriority)
+    : channels(triggerPins.size()),
+      slots(0),
+      slot(0),
+      timeout(timeout),
+      callback(std::move(callback)),
+      running(true) {
+    if (triggerPins.empty() || rate == 0) {
+        throw std::invalid_argument("UltrasonicArray needs sensors and a non-zero rate");
+    }
+    // A slot shorter than the timeout would ping while the previous slot's
+    // sensors still listen; neighbours need slots of their own.
+    const std::chrono::nanoseconds period(1000000000ULL / rate);
+    const std::size_t fit = timeout.count() > 0 ? static_cast<std::size_t>(period / timeout) : triggerPins.size();
+    slots = std::min(fit, triggerPins.size());
+    if (slots < std::min<std::size_t>(2, triggerPins.size())) {
+        throw std::invalid_argument("UltrasonicArray rate too high: neighbouring sensors need separate slots "
+                                    "that cover the echo timeout");
+    }
+    slot = period / slots;
+    for (std::size_t i = 0; i < triggerPins.size(); ++i) {
+        channels[i].trigger = std::make_unique<DigitalPin>(triggerPins[i], DigitalPin::Direction::Output,
+                                                           "Ultrasonic-TRIG" + std::to_string(i));
+        channels[i].trigger->write(false);
+    }
+
+    worker = PreciseTimer::startThread(rtPriority, [this]() { run(); },
+                                       [this](std::exception_ptr error) { workerFailed(error); });
+}
+
+UltrasonicArray::~UltrasonicArray() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+    }
+    cv.notify_all();
+    worker.join();
+}
+
+std::chrono::nanoseconds UltrasonicArray::monotonicNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(PreciseTimer::Clock::now().time_since_epoch());
+}
+
+void UltrasonicArray::run() {
+    auto deadline = PreciseTimer::Clock::now();
+    std::size_t current = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (cv.wait_until(lock, deadline, [this]() { return !running; })) {
+                return;
+            }
+            auto late = std::chrono::duration_cast<std::chrono::nanoseconds>(PreciseTimer::Clock::now() - deadline);
+            counters.maxTriggerLateness = std::max(counters.maxTriggerLateness, late);
+
+            const std::chrono::nanoseconds now = monotonicNow();
+            for (std::size_t i = current; i < channels.size(); i += slots) {
+                Channel& channel = channels[i];
+                if (channel.awaiting) {
+                    // The previous echo never completed.
+                    ++counters.timeouts;
+                    channel.last.valid = false;
+                }
+                channel.awaiting = true;
+                channel.echoHigh = false;
+                channel.triggeredAt = now;
+            }
+        }
+
+        // The sensors of a slot share one trigger pulse.
+        for (std::size_t i = current; i < channels.size(); i += slots) {
+            channels[i].trigger->write(true);
+        }
+        timer.sleepFor(TRIGGER_PULSE);
+        for (std::size_t i = current; i < channels.size(); i += slots) {
+            channels[i].trigger->write(false);
+        }
+
+        current = (current + 1) % slots;
+        deadline += slot;
+    }
+}
+
+void UltrasonicArray::workerFailed(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mtx);
+    failure = error;
+    running = false;
+}
+
+void UltrasonicArray::onEcho(std::size_t sensor, const EdgeEvent& event) {
+    if (sensor >= channels.size()) {
+        return;
+    }
+    double meters = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        Channel& channel = channels[sensor];
+        if (!channel.awaiting || event.timestamp < channel.triggeredAt) {
+            return;
+        }
+        if (event.rising) {
+            channel.echoStart = event.timestamp;
+            channel.echoHigh = true;
+            return;
+        }
+        if (!channel.echoHigh) {
+            return;
+        }
+
+        channel.awaiting = false;
+        channel.echoHigh = false;
+        const auto width = event.timestamp - channel.echoStart;
+        if (event.timestamp - channel.triggeredAt > timeout) {
+            ++counters.timeouts;
+            channel.last.valid = false;
+            return;
+        }
+        meters = std::chrono::duration<double>(width).count() * SPEED_OF_SOUND / 2;
+        channel.last = {true, meters, event.timestamp};
+        ++counters.measurements;
+    }
+    if (callback) {
+        callback(sensor, meters);
+    }
+}
+
+UltrasonicArray::Measurement UltrasonicArray::latest(std::size_t sensor) const {
+    if (sensor >= channels.size()) {
+        throw std::out_of_range("Ultrasonic sensor out of range");
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    return channels[sensor].last;
+}
+
+UltrasonicArray::Stats UltrasonicArray::stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return counters;
+}
@@ -0,0 +1,120 @@
+#ifndef ULTRASONICARRAY_H
+#define ULTRASONICARRAY_H
+
+#include "DigitalPin.h"
+#include "EdgeEvent.h"
+#include "PreciseTimer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Staggered HC-SR04 ranging engine for several sensors.
+ *
+ * A scheduler thread divides each measurement period into as many slots of
+ * at least the echo timeout as fit, up to one per sensor, and sensor i is
+ * triggered in slot i % slots. Neighbouring entries of the pin list are
+ * therefore never pinged together, and a slot only starts once the sensors
+ * of the previous one have stopped listening; list the sensors so that
+ * neighbours face overlapping directions. Echo pulses are timed purely from
+ * edge timestamps fed to onEcho(); nothing ever busy-waits on an echo line.
+ * A measurement whose echo has not ended within the timeout is counted and
+ * discarded at the sensor's next slot.
+ *
+ * The timeout bounds the range: an echo of t seconds is t * 343 / 2 metres
+ * away, so the default 25 ms reaches about 4.3 m, just beyond the HC-SR04's
+ * rated 4 m. Eight sensors at the default 20 Hz get two 25 ms slots of four
+ * sensors each; a higher rate or longer timeout needs fewer sensors.
+ */
+class UltrasonicArray {
+public:
+    using Callback = std::function<void(std::size_t sensor, double meters)>;
+
+    struct Measurement {
+        bool valid = false;
+        double meters = 0.0;
+        std::chrono::nanoseconds timestamp{0};  ///< Monotonic time of the echo end
+    };
+
+    struct Stats {
+        unsigned long measurements = 0;
+        unsigned long timeouts = 0;
+        std::chrono::nanoseconds maxTriggerLateness{0};
+    };
+
+    /**
+     * @brief Constructs the engine and starts triggering.
+     * @param triggerPins GPIO pin of each sensor's TRIG input.
+     * @param rate Measurements per second per sensor; rate * timeout must not exceed 0.5 s
+     *        with several sensors, so that neighbours get separate slots.
+     * @param timeout Longest echo accepted; sets the range limit (25 ms covers 4.3 m).
+     * @param callback Optional; called from the thread feeding onEcho().
+     * @param rtPriority SCHED_FIFO priority for the trigger thread, 0 to keep the default policy.
+     * @throws std::invalid_argument if no sensors are given, rate is zero or
+     *         fewer than two slots of the timeout fit in a period (one for a single sensor).
+     * @throws std::runtime_error if the real-time priority cannot be set.
+     */
+    UltrasonicArray(const std::vector<int>& triggerPins, unsigned int rate = 20,
+                    std::chrono::milliseconds timeout = std::chrono::milliseconds(25), Callback callback = nullptr,
+                    int rtPriority = 0);
+
+    ~UltrasonicArray();
+
+    UltrasonicArray(const UltrasonicArray&) = delete;
+    UltrasonicArray& operator=(const UltrasonicArray&) = delete;
+
+    /**
+     * @brief Feeds an edge from a sensor's ECHO line.
+     */
+    void onEcho(std::size_t sensor, const EdgeEvent& event);
+
+    /**
+     * @brief Returns the latest measurement of a sensor.
+     * @throws std::out_of_range if sensor is out of range.
+     * @throws The exception that stopped the trigger thread, if a trigger write failed.
+     */
+    Measurement latest(std::size_t sensor) const;
+
+    Stats stats() const;
+
+    /// Speed of sound at 20 degrees C, in metres per second.
+    static constexpr double SPEED_OF_SOUND = 343.0;
+
+private:
+    struct Channel {
+        std::unique_ptr<DigitalPin> trigger;
+        std::chrono::nanoseconds triggeredAt{0};
+        std::chrono::nanoseconds echoStart{0};
+        bool awaiting = false;
+        bool echoHigh = false;
+        Measurement last;
+    };
+
+    void run();
+    void workerFailed(std::exception_ptr error);
+    static std::chrono::nanoseconds monotonicNow();
+
+    std::vector<Channel> channels;
+    std::size_t slots;                  ///< Slots per period; sensor i fires in slot i % slots
+    std::chrono::nanoseconds slot;
+    std::chrono::nanoseconds timeout;
+    Callback callback;
+    PreciseTimer timer;
+
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    bool running;
+    std::exception_ptr failure;
+    Stats counters;
+    std::thread worker;
+};
+
+#endif // ULTRASONICARRAY_H
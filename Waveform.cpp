@@ -0,0 +1,179 @@
+#include "Waveform.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+Waveform& Waveform::step(uint64_t mask, uint64_t value, std::chrono::nanoseconds duration) {
+    if (duration.count() < 0) {
+        throw std::invalid_argument("Waveform step duration must not be negative");
+    }
+    stepList.push_back({mask, value & mask, duration});
+    return *this;
+}
+
+Waveform& Waveform::hold(std::chrono::nanoseconds duration) {
+    return step(0, 0, duration);
+}
+
+const std::vector<Waveform::Step>& Waveform::steps() const {
+    return stepList;
+}
+
+std::chrono::nanoseconds Waveform::duration() const {
+    std::chrono::nanoseconds total(0);
+    for (const Step& s : stepList) {
+        total += s.duration;
+    }
+    return total;
+}
+
+WaveformPlayer::WaveformPlayer(const std::vector<DigitalPort*>& ports, const std::vector<Mapping>& mapping,
+                               int rtPriority)
+    : ports(ports), mapping(mapping), running(true) {
+    if (mapping.empty() || mapping.size() > 64) {
+        throw std::invalid_argument("WaveformPlayer mapping must have 1 to 64 channels");
+    }
+    for (const Mapping& m : mapping) {
+        if (m.port >= ports.size() || ports[m.port] == nullptr || m.bit >= ports[m.port]->width()) {
+            throw std::invalid_argument("WaveformPlayer mapping out of range");
+        }
+    }
+
+    worker = PreciseTimer::startThread(rtPriority, [this]() { run(); },
+                                       [this](std::exception_ptr error) { workerFailed(error); });
+}
+
+WaveformPlayer::~WaveformPlayer() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        running = false;
+    }
+    cv.notify_all();
+    worker.join();
+}
+
+CompiledWaveform WaveformPlayer::compile(const Waveform& waveform) const {
+    const uint64_t channelMask = mapping.size() == 64 ? ~uint64_t(0) : (uint64_t(1) << mapping.size()) - 1;
+    CompiledWaveform compiled;
+
+    // Level of every channel once the previous instant's writes are done;
+    // a channel not yet driven by the waveform has no known level.
+    uint64_t known = 0;
+    uint64_t level = 0;
+    // Changes accumulated for the current instant, per port.
+    std::vector<uint64_t> pendingMask(ports.size(), 0);
+    std::vector<uint64_t> pendingValue(ports.size(), 0);
+    std::chrono::nanoseconds now(0);
+
+    auto flush = [&]() {
+        for (std::size_t port = 0; port < ports.size(); ++port) {
+            if (pendingMask[port] != 0) {
+                compiled.writes.push_back({now, port, pendingMask[port], pendingValue[port]});
+                pendingMask[port] = 0;
+                pendingValue[port] = 0;
+            }
+        }
+    };
+
+    for (const Waveform::Step& step : waveform.steps()) {
+        if (step.mask & ~channelMask) {
+            throw std::invalid_argument("Waveform step uses a channel outside the mapping");
+        }
+        // Only channels that actually change produce a write.
+        const uint64_t changed = step.mask & (~known | (level ^ step.value));
+        for (uint64_t bits = changed; bits != 0; bits &= bits - 1) {
+            const unsigned int channel = static_cast<unsigned int>(__builtin_ctzll(bits));
+            const Mapping& m = mapping[channel];
+            const uint64_t portBit = uint64_t(1) << m.bit;
+            pendingMask[m.port] |= portBit;
+            if (step.value & (uint64_t(1) << channel)) {
+                pendingValue[m.port] |= portBit;
+            } else {
+                pendingValue[m.port] &= ~portBit;
+            }
+        }
+        known |= step.mask;
+        level = (level & ~step.mask) | step.value;
+
+        if (step.duration.count() > 0) {
+            flush();
+            now += step.duration;
+        }
+    }
+    flush();
+    compiled.duration = now;
+    return compiled;
+}
+
+std::future<WaveformPlayer::Result> WaveformPlayer::play(const CompiledWaveform& waveform) {
+    for (const CompiledWaveform::Write& write : waveform.writes) {
+        if (write.port >= ports.size()) {
+            throw std::invalid_argument("Compiled waveform references a port outside the player");
+        }
+    }
+    Job job{waveform, std::promise<Result>(), PreciseTimer::Clock::now()};
+    std::future<Result> future = job.promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        jobs.push_back(std::move(job));
+    }
+    cv.notify_all();
+    return future;
+}
+
+void WaveformPlayer::workerFailed(std::exception_ptr error) {
+    std::deque<Job> pending;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        failure = error;
+        running = false;
+        pending.swap(jobs);
+    }
+    for (Job& job : pending) {
+        job.promise.set_exception(error);
+    }
+}
+
+void WaveformPlayer::run() {
+    // End of the previous waveform; a queued waveform starts there.
+    PreciseTimer::Clock::time_point end = PreciseTimer::Clock::now();
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this]() { return !running || !jobs.empty(); });
+            if (!running) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        // sleepUntil(end) always returns after end, so now() would push every
+        // queued waveform late; one queued before end starts exactly at it.
+        const auto start = job.queued <= end ? end : std::max(end, PreciseTimer::Clock::now());
+        Result result;
+        for (const CompiledWaveform::Write& write : job.waveform.writes) {
+            const auto deadline = start + write.offset;
+            timer.sleepUntil(deadline);
+            const auto late =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(PreciseTimer::Clock::now() - deadline);
+            try {
+                ports[write.port]->writeMasked(write.mask, write.value);
+            } catch (...) {
+                job.promise.set_exception(std::current_exception());
+                throw;
+            }
+            ++result.writes;
+            result.maxLateness = std::max(result.maxLateness, late);
+            result.totalLateness += late;
+        }
+        end = start + job.waveform.duration;
+        timer.sleepUntil(end);
+        job.promise.set_value(result);
+    }
+}
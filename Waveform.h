@@ -0,0 +1,155 @@
+#ifndef WAVEFORM_H
+#define WAVEFORM_H
+
+#include "DigitalPort.h"
+#include "PreciseTimer.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Description of a timed pin sequence over up to 64 logical channels.
+ *
+ * Each step drives the channels in its mask to the matching bits of its
+ * value, then holds for its duration. A zero-duration step lands at the same
+ * instant as the next one.
+ */
+class Waveform {
+public:
+    struct Step {
+        uint64_t mask;
+        uint64_t value;
+        std::chrono::nanoseconds duration;
+    };
+
+    /**
+     * @brief Appends a step.
+     * @throws std::invalid_argument if duration is negative.
+     */
+    Waveform& step(uint64_t mask, uint64_t value, std::chrono::nanoseconds duration);
+
+    /**
+     * @brief Appends a step that changes no channel.
+     */
+    Waveform& hold(std::chrono::nanoseconds duration);
+
+    const std::vector<Step>& steps() const;
+
+    /**
+     * @brief Returns the sum of all step durations.
+     */
+    std::chrono::nanoseconds duration() const;
+
+private:
+    std::vector<Step> stepList;
+};
+
+/**
+ * @brief A waveform lowered to a flat list of per-port bulk writes.
+ */
+struct CompiledWaveform {
+    struct Write {
+        std::chrono::nanoseconds offset;    ///< From the start of playback
+        std::size_t port;
+        uint64_t mask;
+        uint64_t value;
+    };
+
+    std::vector<Write> writes;              ///< Sorted by offset
+    std::chrono::nanoseconds duration{0};
+};
+
+/**
+ * @brief Compiles waveforms for a set of DigitalPorts and plays them on a dedicated thread.
+ *
+ * Compilation tracks the level of every channel, drops changes that leave a
+ * line where it already is, and merges every transition due at the same
+ * instant on the same port into one writeMasked() call, so playback is a
+ * straight walk over absolute PreciseTimer deadlines with no per-step logic.
+ * Waveforms queued while another is playing start exactly when it ends.
+ */
+class WaveformPlayer {
+public:
+    /**
+     * @brief Physical location of one logical channel.
+     */
+    struct Mapping {
+        std::size_t port;       ///< Index into the port list
+        unsigned int bit;       ///< Line within that port
+    };
+
+    /**
+     * @brief Timing of one playback.
+     */
+    struct Result {
+        std::size_t writes = 0;
+        std::chrono::nanoseconds maxLateness{0};
+        std::chrono::nanoseconds totalLateness{0};
+    };
+
+    /**
+     * @brief Constructs a player and starts its thread.
+     * @param ports Output ports referenced by the mapping; must outlive the player.
+     * @param mapping Location of channel i at mapping[i] (at most 64).
+     * @param rtPriority SCHED_FIFO priority for the playback thread, or 0 to leave it unchanged.
+     * @throws std::invalid_argument if the mapping is empty, too wide or out of range.
+     * @throws std::runtime_error if the real-time priority cannot be set.
+     */
+    WaveformPlayer(const std::vector<DigitalPort*>& ports, const std::vector<Mapping>& mapping,
+                   int rtPriority = 0);
+
+    /**
+     * @brief Abandons queued waveforms and stops the thread.
+     */
+    ~WaveformPlayer();
+
+    WaveformPlayer(const WaveformPlayer&) = delete;
+    WaveformPlayer& operator=(const WaveformPlayer&) = delete;
+
+    /**
+     * @brief Lowers a waveform to per-port bulk writes.
+     * @throws std::invalid_argument if a step uses a channel outside the mapping.
+     */
+    CompiledWaveform compile(const Waveform& waveform) const;
+
+    /**
+     * @brief Queues a compiled waveform for playback.
+     * @return Future that becomes ready once the waveform's full duration has elapsed.
+     *         If a port write fails, it and every queued waveform's future get the exception.
+     * @throws std::invalid_argument if the waveform references a port outside the player.
+     * @throws The exception that stopped the playback thread, if a port write failed.
+     */
+    std::future<Result> play(const CompiledWaveform& waveform);
+
+private:
+    struct Job {
+        CompiledWaveform waveform;
+        std::promise<Result> promise;
+        PreciseTimer::Clock::time_point queued;
+    };
+
+    void run();
+    void workerFailed(std::exception_ptr error);
+
+    std::vector<DigitalPort*> ports;
+    std::vector<Mapping> mapping;
+    PreciseTimer timer;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<Job> jobs;
+    bool running;
+    std::exception_ptr failure;
+
+    std::thread worker;
+};
+
+#endif // WAVEFORM_H
@@ -0,0 +1,148 @@
+#include "WiegandDecoder.h"
+
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Layout of a supported frame format.
+ *
+ * The leading parity bit is even over bits [0, evenEnd) and the trailing one is
+ * odd over bits [oddStart, bits); the 37-bit format shares its middle bit.
+ */
+struct Format {
+    int bits;
+    int evenEnd;
+    int oddStart;
+    int facilityBits;
+    int cardBits;
+};
+
+constexpr Format FORMATS[] = {
+    {26, 13, 13, 8, 16},    // H10301
+    {34, 17, 17, 16, 16},
+    {37, 19, 18, 16, 19},   // H10304
+};
+
+int onesIn(uint64_t raw, int bits, int from, int to) {
+    // Bit i counts from the first received bit.
+    int ones = 0;
+    for (int i = from; i < to; ++i) {
+        ones += (raw >> (bits - 1 - i)) & 1;
+    }
+    return ones;
+}
+
+} // namespace
+
+WiegandDecoder::WiegandDecoder(std::chrono::nanoseconds frameTimeout, std::chrono::nanoseconds minPulse,
+                               std::chrono::nanoseconds maxPulse)
+    : frameTimeout(frameTimeout),
+      minPulse(minPulse),
+      maxPulse(maxPulse),
+      fallTime{std::chrono::nanoseconds(0), std::chrono::nanoseconds(0)},
+      low{false, false},
+      shift(0),
+      count(0),
+      overrun(false),
+      lastBit(0) {
+    if (minPulse > maxPulse) {
+        throw std::invalid_argument("Wiegand pulse range is empty");
+    }
+}
+
+void WiegandDecoder::onEdge(Line line, const EdgeEvent& event) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (count > 0 && event.timestamp - lastBit >= frameTimeout) {
+        finishFrame();
+    }
+
+    const int index = line == Line::D1 ? 1 : 0;
+    if (!event.rising) {
+        fallTime[index] = event.timestamp;
+        low[index] = true;
+        return;
+    }
+    if (!low[index]) {
+        return;
+    }
+    low[index] = false;
+
+    // The bit is taken at the end of the pulse, once its width is known.
+    const auto width = event.timestamp - fallTime[index];
+    if (width < minPulse || width > maxPulse || low[1 - index]) {
+        ++counters.badPulses;
+        return;
+    }
+    if (count == 64) {
+        overrun = true;
+    } else {
+        shift = (shift << 1) | static_cast<uint64_t>(index);
+        ++count;
+    }
+    lastBit = event.timestamp;
+}
+
+void WiegandDecoder::poll(std::chrono::nanoseconds now) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (count > 0 && now - lastBit >= frameTimeout) {
+        finishFrame();
+    }
+}
+
+std::chrono::nanoseconds WiegandDecoder::nextDeadline() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return count > 0 ? lastBit + frameTimeout : std::chrono::nanoseconds(0);
+}
+
+void WiegandDecoder::finishFrame() {
+    if (overrun) {
+        ++counters.overruns;
+    } else {
+        WiegandFrame frame = decode(shift, count);
+        frame.timestamp = lastBit;
+        ++counters.frames;
+        if (!frame.known) {
+            ++counters.unknownLengths;
+        } else if (!frame.parityOk) {
+            ++counters.parityErrors;
+        }
+        frames.push_back(frame);
+    }
+    shift = 0;
+    count = 0;
+    overrun = false;
+}
+
+std::vector<WiegandFrame> WiegandDecoder::readAvailable() {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<WiegandFrame> result(frames.begin(), frames.end());
+    frames.clear();
+    return result;
+}
+
+WiegandDecoder::Stats WiegandDecoder::stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return counters;
+}
+
+WiegandFrame WiegandDecoder::decode(uint64_t raw, int bits) {
+    WiegandFrame frame;
+    frame.bits = bits;
+    frame.raw = raw;
+    for (const Format& format : FORMATS) {
+        if (format.bits != bits) {
+            continue;
+        }
+        frame.known = true;
+        const bool evenOk = onesIn(raw, bits, 0, format.evenEnd) % 2 == 0;
+        const bool oddOk = onesIn(raw, bits, format.oddStart, bits) % 2 == 1;
+        frame.parityOk = evenOk && oddOk;
+
+        const uint64_t payload = raw >> 1;  // drop the trailing parity bit
+        frame.card = static_cast<uint32_t>(payload & ((uint64_t(1) << format.cardBits) - 1));
+        frame.facility = static_cast<uint32_t>((payload >> format.cardBits) & ((uint64_t(1) << format.facilityBits) - 1));
+        break;
+    }
+    return frame;
+}
@@ -0,0 +1,112 @@
+#ifndef WIEGANDDECODER_H
+#define WIEGANDDECODER_H
+
+#include "EdgeEvent.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief A frame assembled by WiegandDecoder.
+ */
+struct WiegandFrame {
+    int bits = 0;                       ///< Frame length, parity bits included
+    uint64_t raw = 0;                   ///< All bits, first received in the most significant position
+    bool known = false;                 ///< Length matches a supported format (26, 34 or 37 bits)
+    bool parityOk = false;              ///< Both parity bits check (known formats only)
+    uint32_t facility = 0;              ///< Facility code (known formats only)
+    uint32_t card = 0;                  ///< Card number (known formats only)
+    std::chrono::nanoseconds timestamp{0}; ///< Time of the last bit
+};
+
+/**
+ * @brief Edge-driven Wiegand reader decoder.
+ *
+ * Both data lines idle high; a low pulse on D0 sends a 0 and a low pulse on D1
+ * sends a 1. The caller feeds edge events from the two lines and the decoder
+ * times each pulse from its timestamps, so nothing samples the lines. A frame
+ * is complete once the lines stay idle for the inter-frame timeout; call poll()
+ * with the current time (nextDeadline() says when) to close it.
+ *
+ * The decoder holds no thread, so one reactor thread can serve any number of
+ * readers by dispatching each line's edges to its decoder and polling them all.
+ */
+class WiegandDecoder {
+public:
+    enum class Line { D0, D1 };
+
+    struct Stats {
+        unsigned long frames = 0;
+        unsigned long parityErrors = 0;
+        unsigned long unknownLengths = 0;
+        unsigned long badPulses = 0;    ///< Pulses outside the accepted width range
+        unsigned long overruns = 0;     ///< Frames longer than 64 bits
+    };
+
+    /**
+     * @brief Constructs a decoder.
+     * @param frameTimeout Idle time that ends a frame.
+     * @param minPulse Shortest accepted data pulse.
+     * @param maxPulse Longest accepted data pulse.
+     * @throws std::invalid_argument if the pulse range is empty.
+     */
+    explicit WiegandDecoder(std::chrono::nanoseconds frameTimeout = std::chrono::milliseconds(25),
+                            std::chrono::nanoseconds minPulse = std::chrono::microseconds(20),
+                            std::chrono::nanoseconds maxPulse = std::chrono::microseconds(500));
+
+    /**
+     * @brief Feeds an edge from one of the data lines.
+     * @param line Line the edge occurred on.
+     * @param event Edge event; events of both lines must arrive in time order.
+     */
+    void onEdge(Line line, const EdgeEvent& event);
+
+    /**
+     * @brief Closes the current frame if the lines have been idle long enough.
+     * @param now Current monotonic time in nanoseconds.
+     */
+    void poll(std::chrono::nanoseconds now);
+
+    /**
+     * @brief Returns the time at which poll() would close the current frame.
+     * @return Deadline, or zero when no frame is in progress.
+     */
+    std::chrono::nanoseconds nextDeadline() const;
+
+    /**
+     * @brief Removes and returns all frames completed so far.
+     */
+    std::vector<WiegandFrame> readAvailable();
+
+    Stats stats() const;
+
+    /**
+     * @brief Decodes the bits of a complete frame.
+     * @param raw Frame bits, first received in the most significant position.
+     * @param bits Number of bits in the frame.
+     */
+    static WiegandFrame decode(uint64_t raw, int bits);
+
+private:
+    void finishFrame();
+
+    mutable std::mutex mtx;
+    std::chrono::nanoseconds frameTimeout;
+    std::chrono::nanoseconds minPulse;
+    std::chrono::nanoseconds maxPulse;
+
+    std::chrono::nanoseconds fallTime[2];
+    bool low[2];
+    uint64_t shift;
+    int count;
+    bool overrun;
+    std::chrono::nanoseconds lastBit;
+    std::deque<WiegandFrame> frames;
+    Stats counters;
+};
+
+#endif // WIEGANDDECODER_H
@@ -0,0 +1,144 @@
+#include "BitPermutation.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Pairs = std::vector<std::pair<unsigned int, unsigned int>>;
+
+/// Logical bit i at i * 64 / Width: gaps but no crossings, so pext/pdep apply.
+template <unsigned int Width, typename Sequence>
+struct SpreadMap;
+
+template <unsigned int Width, std::size_t... I>
+struct SpreadMap<Width, std::index_sequence<I...>> {
+    using type = StaticBitPermutation<static_cast<unsigned int>(I * 64 / Width)...>;
+};
+
+/// Logical bit i at Width - 1 - i: every pair crosses, so tables are needed.
+template <unsigned int Width, typename Sequence>
+struct ReversedMap;
+
+template <unsigned int Width, std::size_t... I>
+struct ReversedMap<Width, std::index_sequence<I...>> {
+    using type = StaticBitPermutation<static_cast<unsigned int>(Width - 1 - I)...>;
+};
+
+Pairs spreadPairs(unsigned int width) {
+    Pairs pairs;
+    for (unsigned int i = 0; i < width; ++i) {
+        pairs.emplace_back(i, i * 64 / width);
+    }
+    return pairs;
+}
+
+Pairs reversedPairs(unsigned int width) {
+    Pairs pairs;
+    for (unsigned int i = 0; i < width; ++i) {
+        pairs.emplace_back(i, width - 1 - i);
+    }
+    return pairs;
+}
+
+volatile uint64_t sink;
+
+/**
+ * @brief Returns the nanoseconds per round trip (toPhysical then toLogical).
+ */
+template <typename Map>
+double nsPerWord(unsigned long words, Map map) {
+    uint64_t value = 0x9E3779B97F4A7C15;
+    uint64_t accumulator = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < words; ++i) {
+        // xorshift keeps the input unpredictable so nothing is hoisted.
+        value ^= value << 13;
+        value ^= value >> 7;
+        value ^= value << 17;
+        accumulator += map(value);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    sink = accumulator;
+    return 1e9 * seconds / words;
+}
+
+uint64_t bitLoop(const Pairs& pairs, uint64_t value) {
+    uint64_t physical = 0;
+    for (const auto& pair : pairs) {
+        physical |= ((value >> pair.first) & 0x1) << pair.second;
+    }
+    uint64_t logical = 0;
+    for (const auto& pair : pairs) {
+        logical |= ((physical >> pair.second) & 0x1) << pair.first;
+    }
+    return logical;
+}
+
+template <unsigned int Width>
+void report(unsigned long words) {
+    using Spread = typename SpreadMap<Width, std::make_index_sequence<Width>>::type;
+    using Reversed = typename ReversedMap<Width, std::make_index_sequence<Width>>::type;
+    const Pairs spread = spreadPairs(Width);
+    const Pairs reversed = reversedPairs(Width);
+    const BitPermutation spreadMap(spread);
+    const BitPermutation reversedMap(reversed);
+
+    const double spreadLoop = nsPerWord(words, [&](uint64_t v) { return bitLoop(spread, v); });
+    const double spreadRuntime = nsPerWord(words, [&](uint64_t v) {
+        return spreadMap.toLogical(spreadMap.toPhysical(v));
+    });
+    const double spreadStatic = nsPerWord(words, [](uint64_t v) { return Spread::toLogical(Spread::toPhysical(v)); });
+    const double reversedLoop = nsPerWord(words, [&](uint64_t v) { return bitLoop(reversed, v); });
+    const double reversedRuntime = nsPerWord(words, [&](uint64_t v) {
+        return reversedMap.toLogical(reversedMap.toPhysical(v));
+    });
+    const double reversedStatic = nsPerWord(words, [](uint64_t v) {
+        return Reversed::toLogical(Reversed::toPhysical(v));
+    });
+
+    std::printf("%5u  %-8s  %-6s  %9.2f  %14.2f  %20.2f\n", Width, "spread", spreadMap.usesBmi2() ? "pext" : "tables",
+                spreadLoop, spreadRuntime, spreadStatic);
+    std::printf("%5u  %-8s  %-6s  %9.2f  %14.2f  %20.2f\n", Width, "reversed", "tables", reversedLoop,
+                reversedRuntime, reversedStatic);
+}
+
+} // namespace
+
+/**
+ * Compares the cost of the bit-mapping strategies for 8- to 64-bit ports.
+ *
+ * Usage: BitPermutationBenchmark [--words <n>]
+ *
+ * Maps each word to its physical lines and back with a plain bit loop, a
+ * BitPermutation and a StaticBitPermutation, for a spread mapping (gaps
+ * only, which uses pext/pdep on BMI2 CPUs) and a reversed one (tables), and
+ * prints nanoseconds per round trip. Needs no GPIO lines.
+ */
+int main(int argc, char** argv) {
+    unsigned long words = 10000000;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--words" && i + 1 < argc) {
+            words = std::strtoul(argv[++i], nullptr, 0);
+        }
+    }
+
+    try {
+        std::printf("width  mapping   path    loop (ns)  runtime (ns)  StaticBitPermutation (ns)\n");
+        report<8>(words);
+        report<16>(words);
+        report<32>(words);
+        report<64>(words);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "BitPermutationBenchmark: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include "LogicalPort.h"
+#include "PreciseTimer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Returns the writes per second of write() over the given time.
+ */
+template <typename Write>
+double writesPerSecond(double seconds, Write write) {
+    const auto duration = std::chrono::duration<double>(seconds);
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::duration::zero();
+    unsigned long writes = 0;
+    uint64_t value = 0x5A5A5A5A;
+    while (elapsed < duration) {
+        // Alternate every bit so each write changes all three backends.
+        value = ~value;
+        write(value);
+        ++writes;
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+    return writes / std::chrono::duration<double>(elapsed).count();
+}
+
+} // namespace
+
+/**
+ * Reports the 32-bit write rate of a LogicalPort spread over three backends.
+ *
+ * Usage: LogicalPortBenchmark <chip> <gpio0>...<gpio7> <data> <clock> <latch> <i2c-bus> <address>
+ *        [--seconds <n>] [--rt <priority>]
+ *
+ * Logical bits 0-7 go to eight GPIO lines, bits 8-23 to a 16-bit 74HC595
+ * chain and bits 24-31 to GPA0-GPA7 of an MCP23017. Prints the write rate
+ * of each backend on its own, the rate the three would reach one after
+ * another, and the rate of full 32-bit LogicalPort writes, which drive the
+ * backends concurrently.
+ */
+int main(int argc, char** argv) {
+    if (argc < 15) {
+        std::fprintf(stderr,
+                     "usage: %s <chip> <gpio0>...<gpio7> <data> <clock> <latch> <i2c-bus> <address> "
+                     "[--seconds <n>] [--rt <priority>]\n",
+                     argv[0]);
+        return 2;
+    }
+    const std::string chip = argv[1];
+    std::vector<unsigned int> pins;
+    for (int i = 2; i < 10; ++i) {
+        pins.push_back(static_cast<unsigned int>(std::atoi(argv[i])));
+    }
+    const int dataPin = std::atoi(argv[10]);
+    const int clockPin = std::atoi(argv[11]);
+    const int latchPin = std::atoi(argv[12]);
+    const int bus = std::atoi(argv[13]);
+    const uint8_t address = static_cast<uint8_t>(std::strtol(argv[14], nullptr, 0));
+    double seconds = 2.0;
+    int rtPriority = 0;
+    for (int i = 15; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else if (arg == "--rt" && i + 1 < argc) {
+            rtPriority = std::atoi(argv[++i]);
+        }
+    }
+
+    try {
+        if (rtPriority > 0) {
+            PreciseTimer::setRealtimePriority(rtPriority);
+        }
+        DigitalPort port(pins, DigitalPin::Direction::Output, "LogicalPortBenchmark", chip);
+        ShiftRegisterOutput chain(dataPin, clockPin, latchPin, 16, std::chrono::microseconds(0), 10000000);
+        I2cExpander expander(bus, address, I2cExpander::Chip::MCP23017);
+        for (std::size_t bit = 0; bit < 8; ++bit) {
+            expander.setDirection(bit, DigitalPin::Direction::Output);
+        }
+        DigitalPortBackend gpio(port);
+        ShiftRegisterBackend shift(chain);
+        I2cExpanderBackend i2c(expander);
+
+        std::vector<LogicalPort::Mapping> mapping;
+        for (unsigned int bit = 0; bit < 8; ++bit) {
+            mapping.push_back({0, bit});
+        }
+        for (unsigned int bit = 0; bit < 16; ++bit) {
+            mapping.push_back({1, bit});
+        }
+        for (unsigned int bit = 0; bit < 8; ++bit) {
+            mapping.push_back({2, bit});
+        }
+        LogicalPort logical({&gpio, &shift, &i2c}, mapping);
+
+        const double gpioRate = writesPerSecond(seconds, [&](uint64_t v) { gpio.writeMasked(0xFF, v); });
+        const double shiftRate = writesPerSecond(seconds, [&](uint64_t v) { shift.writeMasked(0xFFFF, v); });
+        const double i2cRate = writesPerSecond(seconds, [&](uint64_t v) { i2c.writeMasked(0xFF, v); });
+        const double sequential = 1.0 / (1.0 / gpioRate + 1.0 / shiftRate + 1.0 / i2cRate);
+        const double logicalRate = writesPerSecond(seconds, [&](uint64_t v) { logical.write(v & 0xFFFFFFFF); });
+
+        std::printf("backend                 writes/s  us/write\n");
+        std::printf("DigitalPort (8 bits)   %9.0f  %8.1f\n", gpioRate, 1e6 / gpioRate);
+        std::printf("74HC595 (16 bits)      %9.0f  %8.1f\n", shiftRate, 1e6 / shiftRate);
+        std::printf("MCP23017 (8 bits)      %9.0f  %8.1f\n", i2cRate, 1e6 / i2cRate);
+        std::printf("one after another      %9.0f  %8.1f\n", sequential, 1e6 / sequential);
+        std::printf("LogicalPort (32 bits)  %9.0f  %8.1f\n", logicalRate, 1e6 / logicalRate);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "LogicalPortBenchmark: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
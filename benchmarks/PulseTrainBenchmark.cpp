@@ -0,0 +1,152 @@
+#include "EdgeSource.h"
+#include "PulseTrain.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Checks that PulseTrain emits exact pulse counts under CPU load.
+ *
+ * Usage: PulseTrainBenchmark <pin> [--count <pin>] [--bursts <n>] [--pulses <n>] [--load <threads>] [--rt <priority>]
+ *
+ * Pulses <pin> on gpiochip0 (a gpio-sim line works) at 1 kHz to 50 kHz,
+ * queueing the bursts back-to-back, first on an idle CPU and then with
+ * <threads> busy-looping threads (one per CPU by default). Every burst's
+ * Result::emitted must equal its requested count; with --count, a jumper
+ * from <pin> to a second gpiochip0 line also has its rising edges counted
+ * from kernel edge events. Prints the pulses, the worst lateness and the
+ * duration against the nominal one, and exits with 1 if any count was off.
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr,
+                     "usage: %s <pin> [--count <pin>] [--bursts <n>] [--pulses <n>] [--load <threads>] "
+                     "[--rt <priority>]\n",
+                     argv[0]);
+        return 2;
+    }
+    const int pin = std::atoi(argv[1]);
+    int countPin = -1;
+    unsigned int bursts = 10;
+    uint64_t pulses = 1000;
+    unsigned int loadThreads = std::max(1u, std::thread::hardware_concurrency());
+    int rtPriority = 0;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--count" && i + 1 < argc) {
+            countPin = std::atoi(argv[++i]);
+        } else if (arg == "--bursts" && i + 1 < argc) {
+            bursts = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (arg == "--pulses" && i + 1 < argc) {
+            pulses = static_cast<uint64_t>(std::atoll(argv[++i]));
+        } else if (arg == "--load" && i + 1 < argc) {
+            loadThreads = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (arg == "--rt" && i + 1 < argc) {
+            rtPriority = std::atoi(argv[++i]);
+        }
+    }
+
+    try {
+        PulseTrain train(pin, "PulseTrainBenchmark", rtPriority);
+        std::unique_ptr<EdgeSource> counter;
+        if (countPin >= 0) {
+            counter = std::make_unique<EdgeSource>(std::vector<unsigned int>{static_cast<unsigned int>(countPin)},
+                                                   "PulseTrainBenchmark");
+        }
+
+        bool exact = true;
+        std::printf("load     rate (Hz)  requested  emitted  counted  max lateness (us)  duration/nominal\n");
+        for (unsigned int threads : {0u, loadThreads}) {
+            // Busy loops at normal priority, as many as requested.
+            std::atomic<bool> loading(true);
+            std::vector<std::thread> load;
+            for (unsigned int t = 0; t < threads; ++t) {
+                load.emplace_back([&loading]() {
+                    volatile uint64_t spin = 0;
+                    while (loading.load(std::memory_order_relaxed)) {
+                        ++spin;
+                    }
+                });
+            }
+
+            for (unsigned int rate : {1000u, 10000u, 50000u}) {
+                const std::chrono::nanoseconds half(500000000LL / rate);
+
+                // Count rising edges on the jumpered line while the bursts run.
+                std::atomic<bool> counting(true);
+                std::atomic<uint64_t> counted(0);
+                std::thread reader;
+                if (counter) {
+                    reader = std::thread([&]() {
+                        std::vector<EdgeSource::LineEdge> edges;
+                        while (counting) {
+                            edges.clear();
+                            counter->wait(std::chrono::milliseconds(10), edges);
+                            for (const EdgeSource::LineEdge& edge : edges) {
+                                counted += edge.event.rising ? 1 : 0;
+                            }
+                        }
+                    });
+                }
+
+                const auto start = std::chrono::steady_clock::now();
+                std::vector<std::future<PulseTrain::Result>> results;
+                for (unsigned int b = 0; b < bursts; ++b) {
+                    results.push_back(train.queue(pulses, half, half));
+                }
+                uint64_t requested = 0;
+                uint64_t emitted = 0;
+                std::chrono::nanoseconds lateness(0);
+                for (std::future<PulseTrain::Result>& future : results) {
+                    const PulseTrain::Result result = future.get();
+                    requested += result.requested;
+                    emitted += result.emitted;
+                    lateness = std::max(lateness, result.maxLateness);
+                    exact = exact && result.emitted == result.requested;
+                }
+                const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                if (counter) {
+                    // Let the last edges arrive before the reader stops.
+                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                    counting = false;
+                    reader.join();
+                    exact = exact && counted == requested;
+                }
+                const double nominal = static_cast<double>(requested) / rate;
+                char countedText[24] = "-";
+                if (counter) {
+                    std::snprintf(countedText, sizeof(countedText), "%llu",
+                                  static_cast<unsigned long long>(counted.load()));
+                }
+                std::printf("%-7s  %9u  %9llu  %7llu  %7s  %17.1f  %16.3f\n",
+                            threads ? (std::to_string(threads) + " cpu").c_str() : "idle", rate,
+                            static_cast<unsigned long long>(requested), static_cast<unsigned long long>(emitted),
+                            countedText, lateness.count() / 1e3, elapsed / nominal);
+            }
+
+            loading = false;
+            for (std::thread& thread : load) {
+                thread.join();
+            }
+        }
+
+        if (!exact) {
+            std::fprintf(stderr, "PulseTrainBenchmark: a burst did not emit its requested count\n");
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "PulseTrainBenchmark: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include "EdgeSource.h"
+#include "PreciseTimer.h"
+#include "QuadratureEncoder.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Drives a gpio-sim line by writing its pull attribute.
+ */
+class SimLine {
+public:
+    SimLine(const std::string& simDir, unsigned int offset) {
+        const std::string path = simDir + "/sim_gpio" + std::to_string(offset) + "/pull";
+        fd = ::open(path.c_str(), O_WRONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open " + path + ": " + std::strerror(errno));
+        }
+    }
+
+    ~SimLine() {
+        ::close(fd);
+    }
+
+    SimLine(const SimLine&) = delete;
+    SimLine& operator=(const SimLine&) = delete;
+
+    void set(bool level) {
+        const char* value = level ? "pull-up" : "pull-down";
+        if (::pwrite(fd, value, std::strlen(value), 0) < 0) {
+            throw std::runtime_error(std::string("Failed to set gpio-sim pull: ") + std::strerror(errno));
+        }
+    }
+
+private:
+    int fd;
+};
+
+} // namespace
+
+/**
+ * Measures the count rate QuadratureEncoder sustains on gpio-sim lines.
+ *
+ * Usage: QuadratureBenchmark <chip> <a> <b> <sim-dir> [--counts <n>] [--rt <priority>]
+ *
+ * <sim-dir> is the gpio-sim chip's sysfs directory (for example
+ * /sys/devices/platform/gpio-sim.0/gpiochip2). A driver thread steps the
+ * A/B pulls through the quadrature sequence at paced rates and then flat
+ * out, while the main thread drains both lines' edge events in batches
+ * from one EdgeSource and feeds them to the decoder. Each row reports the
+ * edge rate achieved, the counts lost, the illegal transitions, the mean
+ * events per drain and the decoding cost per edge.
+ */
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        std::fprintf(stderr, "usage: %s <chip> <a> <b> <sim-dir> [--counts <n>] [--rt <priority>]\n", argv[0]);
+        return 2;
+    }
+    const std::string chip = argv[1];
+    const unsigned int pinA = static_cast<unsigned int>(std::atoi(argv[2]));
+    const unsigned int pinB = static_cast<unsigned int>(std::atoi(argv[3]));
+    const std::string simDir = argv[4];
+    long counts = 100000;
+    int rtPriority = 0;
+    for (int i = 5; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--counts" && i + 1 < argc) {
+            counts = std::atol(argv[++i]);
+        } else if (arg == "--rt" && i + 1 < argc) {
+            rtPriority = std::atoi(argv[++i]);
+        }
+    }
+
+    try {
+        if (rtPriority > 0) {
+            PreciseTimer::setRealtimePriority(rtPriority);
+        }
+        SimLine a(simDir, pinA);
+        SimLine b(simDir, pinB);
+        a.set(false);
+        b.set(false);
+        EdgeSource source({pinA, pinB}, "QuadratureBenchmark", chip);
+        const QuadratureEncoder::Channel channelOf[] = {QuadratureEncoder::Channel::A,
+                                                        QuadratureEncoder::Channel::B};
+
+        std::printf("requested (counts/s)  achieved (edges/s)  lost  illegal  events/drain  decode (ns/edge)\n");
+        for (long rate : {1000L, 10000L, 100000L, 0L}) {
+            QuadratureEncoder encoder(false, false);
+            std::atomic<bool> driving(true);
+            double driveSeconds = 0.0;
+            std::thread driver([&]() {
+                PreciseTimer timer;
+                const auto start = PreciseTimer::now();
+                auto deadline = start;
+                bool levelA = false;
+                bool levelB = false;
+                for (long i = 0; i < counts; ++i) {
+                    // Forward sequence 00 -> 10 -> 11 -> 01: A moves on even steps, B on odd.
+                    if (i % 2 == 0) {
+                        a.set(levelA = !levelA);
+                    } else {
+                        b.set(levelB = !levelB);
+                    }
+                    if (rate > 0) {
+                        deadline += std::chrono::nanoseconds(1000000000L / rate);
+                        timer.sleepUntil(deadline);
+                    }
+                }
+                driveSeconds = std::chrono::duration<double>(PreciseTimer::now() - start).count();
+                driving = false;
+            });
+
+            std::vector<EdgeSource::LineEdge> edges;
+            std::vector<QuadratureEncoder::Channel> channels;
+            std::vector<EdgeEvent> events;
+            unsigned long drains = 0;
+            unsigned long total = 0;
+            double decodeSeconds = 0.0;
+            while (true) {
+                edges.clear();
+                const bool wasDriving = driving;
+                if (source.wait(std::chrono::milliseconds(20), edges) == 0 && !wasDriving) {
+                    break;
+                }
+                channels.clear();
+                events.clear();
+                for (const EdgeSource::LineEdge& edge : edges) {
+                    channels.push_back(channelOf[edge.line]);
+                    events.push_back(edge.event);
+                }
+                const auto start = std::chrono::steady_clock::now();
+                encoder.onEdges(channels.data(), events.data(), events.size());
+                decodeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                drains += edges.empty() ? 0 : 1;
+                total += edges.size();
+            }
+            driver.join();
+
+            std::printf("%20s  %18.0f  %4ld  %7llu  %12.1f  %16.1f\n",
+                        rate > 0 ? std::to_string(rate).c_str() : "max", counts / driveSeconds,
+                        counts - encoder.position(), static_cast<unsigned long long>(encoder.illegalTransitions()),
+                        drains ? static_cast<double>(total) / drains : 0.0, total ? 1e9 * decodeSeconds / total : 0.0);
+
+            // Return both lines low so the next run starts from state 00.
+            if (counts % 4 != 0) {
+                a.set(false);
+                b.set(false);
+                std::vector<EdgeSource::LineEdge> settle;
+                source.wait(std::chrono::milliseconds(20), settle);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "QuadratureBenchmark: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include "ServoController.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Reports ServoController pulse-width jitter against the number of channels.
+ *
+ * Usage: ServoJitterBenchmark <chip> <pin> [<pin> ...] [--rt <priority>] [--seconds <n>]
+ *
+ * For every channel count from 1 to the number of pins, drives that many
+ * servos at angles spread over the range for the given time and prints the
+ * worst and mean maxWidth - minWidth over the channels.
+ */
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <chip> <pin> [<pin> ...] [--rt <priority>] [--seconds <n>]\n", argv[0]);
+        return 2;
+    }
+    const std::string chip = argv[1];
+    std::vector<unsigned int> pins;
+    int rtPriority = 0;
+    int seconds = 5;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--rt" && i + 1 < argc) {
+            rtPriority = std::atoi(argv[++i]);
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::atoi(argv[++i]);
+        } else {
+            pins.push_back(static_cast<unsigned int>(std::atoi(arg.c_str())));
+        }
+    }
+
+    try {
+        DigitalPort port(pins, DigitalPin::Direction::Output, "ServoJitterBenchmark", chip);
+        ServoConfig config;
+        config.rtPriority = rtPriority;
+
+        std::printf("channels  pulses  worst jitter (us)  mean jitter (us)\n");
+        for (std::size_t count = 1; count <= pins.size(); ++count) {
+            std::vector<unsigned int> bits;
+            for (unsigned int bit = 0; bit < count; ++bit) {
+                bits.push_back(bit);
+            }
+            ServoController servos(port, bits, config);
+            for (std::size_t channel = 0; channel < count; ++channel) {
+                servos.setAngle(channel, 180.0 * static_cast<double>(channel) / static_cast<double>(pins.size()));
+            }
+            // Let the new schedule take effect before measuring.
+            std::this_thread::sleep_for(config.frame * 2);
+            servos.resetStats();
+            std::this_thread::sleep_for(std::chrono::seconds(seconds));
+
+            unsigned long pulses = 0;
+            std::chrono::nanoseconds worst(0);
+            std::chrono::nanoseconds total(0);
+            for (const ServoController::ChannelStats& stats : servos.stats()) {
+                const auto jitter = stats.maxWidth - stats.minWidth;
+                pulses += stats.pulses;
+                worst = std::max(worst, jitter);
+                total += jitter;
+            }
+            std::printf("%8zu  %6lu  %17.1f  %16.1f\n", count, pulses, worst.count() / 1e3,
+                        total.count() / 1e3 / static_cast<double>(count));
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "ServoJitterBenchmark: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "PreciseTimer.h"
+#include "ShiftRegister.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+
+/**
+ * Reports effective update rates of a 64-bit 74HC595 chain.
+ *
+ * Usage: ShiftRegisterBenchmark <data> <clock> <latch> [--seconds <n>] [--rt <priority>]
+ *
+ * For each shift clock, first flushes after every bit change (one full
+ * 64-bit shift per update) and then lets the frame thread coalesce the
+ * changes made within each 1 ms frame, printing bit updates per second,
+ * shifts per second and updates carried by each shift.
+ */
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        std::fprintf(stderr, "usage: %s <data> <clock> <latch> [--seconds <n>] [--rt <priority>]\n", argv[0]);
+        return 2;
+    }
+    const int dataPin = std::atoi(argv[1]);
+    const int clockPin = std::atoi(argv[2]);
+    const int latchPin = std::atoi(argv[3]);
+    double seconds = 2.0;
+    int rtPriority = 0;
+    for (int i = 4; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else if (arg == "--rt" && i + 1 < argc) {
+            rtPriority = std::atoi(argv[++i]);
+        }
+    }
+    constexpr std::size_t BITS = 64;
+    const auto duration = std::chrono::duration<double>(seconds);
+
+    try {
+        if (rtPriority > 0) {
+            PreciseTimer::setRealtimePriority(rtPriority);
+        }
+        std::printf("clock (Hz)  mode       updates/s   shifts/s  updates/shift\n");
+        for (uint32_t clockHz : {100000u, 1000000u, 10000000u}) {
+            for (bool coalesced : {false, true}) {
+                ShiftRegisterOutput chain(dataPin, clockPin, latchPin, BITS,
+                                          coalesced ? std::chrono::milliseconds(1) : std::chrono::microseconds(0),
+                                          clockHz);
+                const unsigned long shiftsBefore = chain.shiftCount();
+                unsigned long updates = 0;
+                const auto start = std::chrono::steady_clock::now();
+                auto elapsed = std::chrono::steady_clock::duration::zero();
+                while (elapsed < duration) {
+                    // Walk a toggle through the chain so every update changes a bit.
+                    const std::size_t bit = updates % BITS;
+                    chain.set(bit, !chain.get(bit));
+                    if (!coalesced) {
+                        chain.flush();
+                    }
+                    ++updates;
+                    elapsed = std::chrono::steady_clock::now() - start;
+                }
+                chain.flush();
+                const unsigned long shifts = chain.shiftCount() - shiftsBefore;
+                const double measured = std::chrono::duration<double>(elapsed).count();
+                std::printf("%10u  %-9s  %10.0f  %9.0f  %13.1f\n", clockHz, coalesced ? "coalesced" : "per-bit",
+                            updates / measured, shifts / measured,
+                            shifts ? static_cast<double>(updates) / shifts : 0.0);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "ShiftRegisterBenchmark: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "SoftSpi.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <vector>
+
+/**
+ * Reports SoftSpi throughput against the requested clock.
+ *
+ * Usage: SoftSpiBenchmark <chip> <sck> <mosi> <miso> <cs> [--bytes <n>] [--rt <priority>]
+ *
+ * Transfers the same buffer at clocks from 10 kHz up to 10 MHz, in every SPI
+ * mode, and prints the achieved bytes per second and effective SCK
+ * frequency. Wire MOSI to MISO to also check the data: the report counts
+ * the bytes that did not come back unchanged.
+ */
+int main(int argc, char** argv) {
+    if (argc < 6) {
+        std::fprintf(stderr, "usage: %s <chip> <sck> <mosi> <miso> <cs> [--bytes <n>] [--rt <priority>]\n", argv[0]);
+        return 2;
+    }
+    const std::string chip = argv[1];
+    const int sck = std::atoi(argv[2]);
+    const int mosi = std::atoi(argv[3]);
+    const int miso = std::atoi(argv[4]);
+    const int cs = std::atoi(argv[5]);
+    std::size_t bytes = 4096;
+    int rtPriority = 0;
+    for (int i = 6; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--bytes" && i + 1 < argc) {
+            bytes = static_cast<std::size_t>(std::atol(argv[++i]));
+        } else if (arg == "--rt" && i + 1 < argc) {
+            rtPriority = std::atoi(argv[++i]);
+        }
+    }
+
+    try {
+        if (rtPriority > 0) {
+            PreciseTimer::setRealtimePriority(rtPriority);
+        }
+        SoftSpi spi(sck, mosi, miso, cs, SoftSpiConfig(), chip);
+        std::vector<uint8_t> tx(bytes);
+        for (std::size_t i = 0; i < bytes; ++i) {
+            tx[i] = static_cast<uint8_t>(i * 37 + 11);
+        }
+        std::vector<uint8_t> rx(bytes);
+
+        std::printf("mode  requested (Hz)  bytes/s     effective SCK (Hz)  mismatches\n");
+        for (int mode = 0; mode < 4; ++mode) {
+            for (uint32_t clockHz : {10000u, 100000u, 1000000u, 10000000u}) {
+                SoftSpiConfig config;
+                config.mode = mode;
+                config.clockHz = clockHz;
+                spi.setConfig(config);
+
+                const auto start = std::chrono::steady_clock::now();
+                spi.transfer(tx.data(), rx.data(), bytes);
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                std::size_t mismatches = 0;
+                for (std::size_t i = 0; i < bytes; ++i) {
+                    mismatches += rx[i] != tx[i];
+                }
+                std::printf("%4d  %14u  %10.0f  %18.0f  %10zu\n", mode, clockHz, bytes / seconds,
+                            bytes * 8 / seconds, mismatches);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "SoftSpiBenchmark: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "EdgeSource.h"
+#include "SoftUart.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Finds the highest baud rate SoftUart sustains on a TX-to-RX loopback.
+ *
+ * Usage: SoftUartBenchmark <tx> <rx> [--bytes <n>] [--rt <priority>]
+ *
+ * Wire TX to RX (both on gpiochip0). For standard rates from 9600 to
+ * 921600 baud the benchmark sends a buffer from TX, decodes RX from its
+ * kernel edge events on a reader thread, and prints the bytes that came
+ * back intact with the parity and framing errors; the last line names the
+ * highest rate at which every byte arrived.
+ */
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <tx> <rx> [--bytes <n>] [--rt <priority>]\n", argv[0]);
+        return 2;
+    }
+    const int txPin = std::atoi(argv[1]);
+    const unsigned int rxPin = static_cast<unsigned int>(std::atoi(argv[2]));
+    std::size_t bytes = 1024;
+    int rtPriority = 0;
+    for (int i = 3; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--bytes" && i + 1 < argc) {
+            bytes = static_cast<std::size_t>(std::atol(argv[++i]));
+        } else if (arg == "--rt" && i + 1 < argc) {
+            rtPriority = std::atoi(argv[++i]);
+        }
+    }
+
+    try {
+        if (rtPriority > 0) {
+            PreciseTimer::setRealtimePriority(rtPriority);
+        }
+        std::vector<uint8_t> sent(bytes);
+        for (std::size_t i = 0; i < bytes; ++i) {
+            sent[i] = static_cast<uint8_t>(i * 37 + 11);
+        }
+
+        uint32_t best = 0;
+        std::printf("baud     intact  parity errors  framing errors  false starts\n");
+        for (uint32_t baud : {9600u, 19200u, 38400u, 57600u, 115200u, 230400u, 460800u, 921600u}) {
+            SoftUart::Config config;
+            config.baud = baud;
+            config.parity = SoftUart::Parity::Even;
+            SoftUart uart(txPin, config);
+            EdgeSource source({rxPin}, "SoftUartBenchmark");
+
+            std::atomic<bool> running(true);
+            std::thread reader([&]() {
+                std::vector<EdgeSource::LineEdge> edges;
+                while (running) {
+                    edges.clear();
+                    source.wait(std::chrono::milliseconds(10), edges);
+                    for (const EdgeSource::LineEdge& edge : edges) {
+                        uart.onEdge(edge.event);
+                    }
+                }
+            });
+            uart.write(sent);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            running = false;
+            reader.join();
+            uart.poll(PreciseTimer::now().time_since_epoch());
+
+            const std::vector<uint8_t> received = uart.readAvailable();
+            std::size_t intact = 0;
+            for (std::size_t i = 0; i < received.size() && i < sent.size(); ++i) {
+                intact += received[i] == sent[i];
+            }
+            const SoftUart::Stats stats = uart.stats();
+            std::printf("%-7u  %6zu  %13lu  %14lu  %12lu\n", baud, intact, stats.parityErrors,
+                        stats.framingErrors, stats.falseStarts);
+            if (intact == bytes && received.size() == bytes) {
+                best = baud;
+            }
+        }
+        std::printf("highest clean rate: %u baud\n", best);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "SoftUartBenchmark: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "Waveform.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <future>
+#include <vector>
+
+/**
+ * Measures WaveformPlayer compile time and playback lateness.
+ *
+ * Usage: WaveformBenchmark <chip> <pin> [<pin> ...] [--rt <priority>]
+ *
+ * Builds a pseudo-random waveform over the given lines, in which about a
+ * quarter of the steps change nothing, a quarter land at the same instant as
+ * the next step and the rest toggle a few channels. Compiles it repeatedly,
+ * then plays it back-to-back three times on the hardware.
+ */
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <chip> <pin> [<pin> ...] [--rt <priority>]\n", argv[0]);
+        return 2;
+    }
+    const std::string chip = argv[1];
+    std::vector<unsigned int> pins;
+    int rtPriority = 0;
+    for (int i = 2; i < argc; ++i) {
+        if (std::string(argv[i]) == "--rt" && i + 1 < argc) {
+            rtPriority = std::atoi(argv[++i]);
+        } else {
+            pins.push_back(static_cast<unsigned int>(std::atoi(argv[i])));
+        }
+    }
+
+    constexpr std::size_t STEPS = 100000;
+    constexpr int COMPILE_RUNS = 20;
+    const std::chrono::microseconds stepTime(20);
+
+    try {
+        DigitalPort port(pins, DigitalPin::Direction::Output, "WaveformBenchmark", chip);
+        std::vector<WaveformPlayer::Mapping> mapping;
+        for (unsigned int bit = 0; bit < pins.size(); ++bit) {
+            mapping.push_back({0, bit});
+        }
+        WaveformPlayer player({&port}, mapping, rtPriority);
+
+        const uint64_t channels = pins.size() == 64 ? ~uint64_t(0) : (uint64_t(1) << pins.size()) - 1;
+        Waveform waveform;
+        uint64_t level = 0;
+        uint32_t seed = 12345;
+        for (std::size_t i = 0; i < STEPS; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            const unsigned int kind = seed >> 30;
+            const uint64_t bits = ((uint64_t(seed) << 32) | (seed >> 8)) & channels;
+            if (kind == 0) {
+                waveform.step(channels, level, stepTime);                   // redundant
+            } else if (kind == 1) {
+                level ^= bits;
+                waveform.step(channels, level, std::chrono::nanoseconds(0)); // same instant
+            } else {
+                level ^= bits;
+                waveform.step(channels, level, stepTime);
+            }
+        }
+
+        CompiledWaveform compiled;
+        const auto compileStart = std::chrono::steady_clock::now();
+        for (int run = 0; run < COMPILE_RUNS; ++run) {
+            compiled = player.compile(waveform);
+        }
+        const double compileNs =
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - compileStart).count() /
+            COMPILE_RUNS;
+        std::printf("compile: %zu steps -> %zu writes, %.1f ms (%.1f ns/step)\n", STEPS, compiled.writes.size(),
+                    compileNs / 1e6, compileNs / STEPS);
+
+        std::vector<std::future<WaveformPlayer::Result>> plays;
+        const auto playStart = std::chrono::steady_clock::now();
+        for (int run = 0; run < 3; ++run) {
+            plays.push_back(player.play(compiled));
+        }
+        for (std::size_t run = 0; run < plays.size(); ++run) {
+            const WaveformPlayer::Result result = plays[run].get();
+            std::printf("play %zu: %zu writes, lateness max %lld ns, mean %lld ns\n", run, result.writes,
+                        static_cast<long long>(result.maxLateness.count()),
+                        static_cast<long long>(result.writes ? result.totalLateness.count() /
+                                                                   static_cast<long long>(result.writes)
+                                                             : 0));
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - playStart;
+        std::printf("3 plays of %lld us each took %lld us\n",
+                    static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                               compiled.duration).count()),
+                    static_cast<long long>(
+                        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "WaveformBenchmark: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
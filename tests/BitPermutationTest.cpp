@@ -0,0 +1,141 @@
+#include "BitPermutation.h"
+#include "Check.h"
+#include "FakeGpio.h"
+#include "LogicalPort.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Pairs = std::vector<std::pair<unsigned int, unsigned int>>;
+
+uint64_t scatter(const Pairs& pairs, uint64_t value) {
+    uint64_t result = 0;
+    for (const auto& pair : pairs) {
+        result |= ((value >> pair.first) & 0x1) << pair.second;
+    }
+    return result;
+}
+
+uint64_t gather(const Pairs& pairs, uint64_t value) {
+    uint64_t result = 0;
+    for (const auto& pair : pairs) {
+        result |= ((value >> pair.second) & 0x1) << pair.first;
+    }
+    return result;
+}
+
+/**
+ * @brief Maps `width` random logical bits to random physical bits.
+ */
+Pairs randomPairs(std::mt19937_64& random, unsigned int width, bool ordered) {
+    std::vector<unsigned int> logical(64);
+    std::vector<unsigned int> physical(64);
+    for (unsigned int i = 0; i < 64; ++i) {
+        logical[i] = physical[i] = i;
+    }
+    std::shuffle(logical.begin(), logical.end(), random);
+    std::shuffle(physical.begin(), physical.end(), random);
+    logical.resize(width);
+    physical.resize(width);
+    if (ordered) {
+        std::sort(logical.begin(), logical.end());
+        std::sort(physical.begin(), physical.end());
+    }
+    Pairs pairs;
+    for (unsigned int i = 0; i < width; ++i) {
+        pairs.emplace_back(logical[i], physical[i]);
+    }
+    return pairs;
+}
+
+void testMatchesBitLoop() {
+    std::mt19937_64 random(61);
+    for (bool ordered : {false, true}) {
+        for (unsigned int width : {1u, 8u, 16u, 32u, 63u, 64u}) {
+            const Pairs pairs = randomPairs(random, width, ordered);
+            const BitPermutation permutation(pairs);
+            CHECK(permutation.logicalMask() == gather(pairs, ~uint64_t(0)));
+            CHECK(permutation.physicalMask() == scatter(pairs, ~uint64_t(0)));
+            for (int i = 0; i < 1000; ++i) {
+                const uint64_t value = random();
+                CHECK(permutation.toPhysical(value) == scatter(pairs, value));
+                CHECK(permutation.toLogical(value) == gather(pairs, value));
+            }
+        }
+    }
+}
+
+void testBmi2Selection() {
+    const BitPermutation ordered({{0, 3}, {1, 9}, {2, 40}});
+    const BitPermutation crossed({{0, 40}, {1, 9}, {2, 3}});
+    CHECK(!crossed.usesBmi2());
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    // Chosen at run time, so a generic x86-64 build uses pext/pdep on any BMI2 CPU.
+    CHECK(ordered.usesBmi2() == static_cast<bool>(__builtin_cpu_supports("bmi2")));
+#else
+    CHECK(!ordered.usesBmi2());
+#endif
+    CHECK(ordered.toPhysical(0x5) == ((uint64_t(1) << 3) | (uint64_t(1) << 40)));
+    CHECK(crossed.toPhysical(0x5) == ((uint64_t(1) << 40) | (uint64_t(1) << 3)));
+}
+
+void testInvalidPairs() {
+    bool threw = false;
+    try {
+        BitPermutation({{0, 1}, {1, 1}});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+    threw = false;
+    try {
+        BitPermutation({{64, 0}});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+using NibbleSwap = StaticBitPermutation<4, 5, 6, 7, 0, 1, 2, 3>;
+static_assert(NibbleSwap::toPhysical(0x12) == 0x21, "StaticBitPermutation scatters at compile time");
+static_assert(NibbleSwap::toLogical(0x21) == 0x12, "StaticBitPermutation gathers at compile time");
+static_assert(NibbleSwap::physicalMask() == 0xFF && NibbleSwap::width() == 8, "");
+
+void testStaticLogicalPort() {
+    FakeGpio::reset();
+    DigitalPort port({10, 11, 12, 13, 14, 15, 16, 17, 18, 19}, DigitalPin::Direction::Output);
+    // Logical bit i on port bit 7 - i; port bits 8 and 9 are not mapped.
+    StaticLogicalPort<StaticBitPermutation<7, 6, 5, 4, 3, 2, 1, 0>> reversed(port);
+    port.write(0x300);
+    reversed.write(0x01);
+    CHECK(port.lastWritten() == 0x380);
+    CHECK(FakeGpio::level(17));
+    CHECK(!FakeGpio::level(10));
+    reversed.writeMasked(0x03, 0x02);
+    CHECK(port.lastWritten() == 0x340);
+    CHECK(reversed.read() == 0x02);
+
+    bool threw = false;
+    try {
+        StaticLogicalPort<StaticBitPermutation<0, 10>> tooWide(port);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+} // namespace
+
+int main() {
+    testMatchesBitLoop();
+    testBmi2Selection();
+    testInvalidPairs();
+    testStaticLogicalPort();
+    return checkResult();
+}
@@ -0,0 +1,33 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdio>
+
+/**
+ * @brief Minimal assertion helpers for the decoder tests.
+ *
+ * CHECK records a failure and keeps going so one run reports every broken
+ * expectation; main() returns checkResult() as the process exit status.
+ */
+inline int& checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                 \
+    do {                                                                                 \
+        if (!(condition)) {                                                              \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++checkFailures();                                                           \
+        }                                                                                \
+    } while (0)
+
+inline int checkResult() {
+    if (checkFailures() != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", checkFailures());
+        return 1;
+    }
+    return 0;
+}
+
+#endif // CHECK_H
@@ -0,0 +1,94 @@
+#include "Check.h"
+#include "DhtSensor.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+/**
+ * @brief Builds the edges of a DHT response carrying five bytes.
+ * @param withRelease Include the host's release edge before the response.
+ */
+std::vector<EdgeEvent> response(const uint8_t bytes[5], bool withRelease = true) {
+    std::vector<EdgeEvent> edges;
+    nanoseconds t = seconds(5);
+    if (withRelease) {
+        edges.push_back({true, t});
+        t += microseconds(30);
+    }
+    // 80 us low, 80 us high preamble.
+    edges.push_back({false, t});
+    t += microseconds(80);
+    edges.push_back({true, t});
+    t += microseconds(80);
+    for (int bit = 0; bit < 40; ++bit) {
+        edges.push_back({false, t});
+        t += microseconds(50);
+        edges.push_back({true, t});
+        t += (bytes[bit / 8] & (0x80 >> (bit % 8))) ? microseconds(70) : microseconds(27);
+    }
+    edges.push_back({false, t});
+    edges.push_back({true, t + microseconds(50)});
+    return edges;
+}
+
+void testDecodeBytes() {
+    const uint8_t sent[5] = {0x02, 0x8C, 0x01, 0x5F, 0xEE};
+    uint8_t received[5] = {};
+    CHECK(DhtSensor::decodeBytes(response(sent), received));
+    for (int i = 0; i < 5; ++i) {
+        CHECK(received[i] == sent[i]);
+    }
+    // Missing the release edge changes nothing: only the last 40 highs count.
+    CHECK(DhtSensor::decodeBytes(response(sent, false), received));
+    CHECK(received[1] == 0x8C);
+}
+
+void testIncompleteResponse() {
+    const uint8_t sent[5] = {1, 2, 3, 4, 10};
+    std::vector<EdgeEvent> edges = response(sent);
+    edges.resize(edges.size() / 2);
+    uint8_t received[5];
+    CHECK(!DhtSensor::decodeBytes(edges, received));
+}
+
+void testConvertDht22() {
+    // 65.2 %RH, -10.1 C
+    const uint8_t bytes[5] = {0x02, 0x8C, 0x80, 0x65, static_cast<uint8_t>(0x02 + 0x8C + 0x80 + 0x65)};
+    const auto reading = DhtSensor::convert(bytes, DhtSensor::Model::DHT22);
+    CHECK(reading.has_value());
+    if (reading) {
+        CHECK(reading->humidity > 65.19 && reading->humidity < 65.21);
+        CHECK(reading->temperature > -10.11 && reading->temperature < -10.09);
+    }
+}
+
+void testConvertDht11() {
+    const uint8_t bytes[5] = {45, 0, 23, 5, 73};
+    const auto reading = DhtSensor::convert(bytes, DhtSensor::Model::DHT11);
+    CHECK(reading.has_value());
+    if (reading) {
+        CHECK(reading->humidity == 45.0);
+        CHECK(reading->temperature > 23.49 && reading->temperature < 23.51);
+    }
+}
+
+void testChecksumMismatch() {
+    const uint8_t bytes[5] = {1, 2, 3, 4, 11};
+    CHECK(!DhtSensor::convert(bytes, DhtSensor::Model::DHT22).has_value());
+}
+
+} // namespace
+
+int main() {
+    testDecodeBytes();
+    testIncompleteResponse();
+    testConvertDht22();
+    testConvertDht11();
+    testChecksumMismatch();
+    return checkResult();
+}
@@ -0,0 +1,454 @@
+#include "FakeGpio.h"
+#include "PreciseTimer.h"
+
+#include <gpiod.h>
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+
+struct gpiod_chip {
+    int unused;
+};
+
+struct gpiod_line {
+    unsigned int offset;
+    bool held;
+    bool output;
+    bool openDrain;
+    int edges;          ///< GPIOD_LINE_REQUEST_EVENT_* or 0 without edge detection
+    int value;          ///< last value written by the consumer
+    bool lastLevel;     ///< level when edges were last checked
+    std::deque<gpiod_line_event> events;
+};
+
+namespace {
+
+struct Chip {
+    std::recursive_mutex mtx;
+    std::condition_variable_any cv;
+    std::map<unsigned int, std::unique_ptr<gpiod_line>> lines;
+    std::map<unsigned int, bool> inputs;
+    FakeGpio::Device* device = nullptr;
+    std::vector<FakeGpio::Write> log;
+};
+
+Chip& chip() {
+    static Chip instance;
+    return instance;
+}
+
+gpiod_line* lineAt(unsigned int offset) {
+    std::unique_ptr<gpiod_line>& line = chip().lines[offset];
+    if (!line) {
+        line.reset(new gpiod_line{offset, false, false, false, 0, 0, true, {}});
+    }
+    return line.get();
+}
+
+bool levelOf(const gpiod_line& line) {
+    Chip& c = chip();
+    if (line.held && line.output && !line.openDrain) {
+        return line.value != 0;
+    }
+    bool external = true;
+    if (c.device) {
+        external = c.device->drive(line.offset);
+    } else {
+        auto it = c.inputs.find(line.offset);
+        external = it == c.inputs.end() || it->second;
+    }
+    if (line.held && line.output && line.openDrain && line.value == 0) {
+        return false;
+    }
+    return external;
+}
+
+void refreshLocked() {
+    Chip& c = chip();
+    bool queued = false;
+    for (auto& entry : c.lines) {
+        gpiod_line& line = *entry.second;
+        if (!line.held || line.edges == 0) {
+            continue;
+        }
+        const bool level = levelOf(line);
+        if (level == line.lastLevel) {
+            continue;
+        }
+        line.lastLevel = level;
+        if (line.edges == GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES ||
+            (line.edges == GPIOD_LINE_REQUEST_EVENT_RISING_EDGE && level) ||
+            (line.edges == GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE && !level)) {
+            // Stamped from PreciseTimer so edges follow a virtual clock when one is linked.
+            const auto stamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                PreciseTimer::now().time_since_epoch());
+            gpiod_line_event event{};
+            event.ts.tv_sec = static_cast<time_t>(stamp.count() / 1000000000);
+            event.ts.tv_nsec = static_cast<long>(stamp.count() % 1000000000);
+            event.event_type = level ? GPIOD_LINE_EVENT_RISING_EDGE : GPIOD_LINE_EVENT_FALLING_EDGE;
+            line.events.push_back(event);
+            queued = true;
+        }
+    }
+    if (queued) {
+        c.cv.notify_all();
+    }
+}
+
+/**
+ * @brief Tells the device about a consumer write and queues the edges it caused.
+ */
+void changedLocked() {
+    Chip& c = chip();
+    if (c.device) {
+        c.device->changed();
+    }
+    refreshLocked();
+}
+
+int requestBulk(gpiod_line_bulk* bulk, int type, int flags, const int* values) {
+    std::lock_guard<std::recursive_mutex> lock(chip().mtx);
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) {
+        if (bulk->lines[i]->held) {
+            errno = EBUSY;
+            return -1;
+        }
+    }
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) {
+        gpiod_line& line = *bulk->lines[i];
+        line.held = true;
+        line.output = type == GPIOD_LINE_REQUEST_DIRECTION_OUTPUT;
+        line.openDrain = line.output && (flags & GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN);
+        line.edges = type >= GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE ? type : 0;
+        line.value = values ? values[i] : 0;
+        line.events.clear();
+    }
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) {
+        bulk->lines[i]->lastLevel = levelOf(*bulk->lines[i]);
+    }
+    changedLocked();
+    return 0;
+}
+
+int requestOne(gpiod_line* line, int type, int flags, int value) {
+    gpiod_line_bulk bulk{};
+    bulk.lines[0] = line;
+    bulk.num_lines = 1;
+    return requestBulk(&bulk, type, flags, &value);
+}
+
+bool heldBulk(const gpiod_line_bulk* bulk) {
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) {
+        if (!bulk->lines[i]->held) {
+            errno = EPERM;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+namespace FakeGpio {
+
+void reset() {
+    Chip& c = chip();
+    std::lock_guard<std::recursive_mutex> lock(c.mtx);
+    // Lines are reset in place; gpiod_line pointers stay valid.
+    for (auto& entry : c.lines) {
+        *entry.second = gpiod_line{entry.first, false, false, false, 0, 0, true, {}};
+    }
+    c.inputs.clear();
+    c.device = nullptr;
+    c.log.clear();
+}
+
+void attach(Device* device) {
+    Chip& c = chip();
+    std::lock_guard<std::recursive_mutex> lock(c.mtx);
+    c.device = device;
+    refreshLocked();
+}
+
+void setInput(unsigned int offset, bool level) {
+    Chip& c = chip();
+    std::lock_guard<std::recursive_mutex> lock(c.mtx);
+    c.inputs[offset] = level;
+    refreshLocked();
+}
+
+void refresh() {
+    std::lock_guard<std::recursive_mutex> lock(chip().mtx);
+    refreshLocked();
+}
+
+bool level(unsigned int offset) {
+    std::lock_guard<std::recursive_mutex> lock(chip().mtx);
+    return levelOf(*lineAt(offset));
+}
+
+bool driven(unsigned int offset) {
+    std::lock_guard<std::recursive_mutex> lock(chip().mtx);
+    const gpiod_line& line = *lineAt(offset);
+    return !(line.held && line.output) || line.value != 0;
+}
+
+bool requested(unsigned int offset) {
+    std::lock_guard<std::recursive_mutex> lock(chip().mtx);
+    return lineAt(offset)->held;
+}
+
+std::vector<Write> writes() {
+    std::lock_guard<std::recursive_mutex> lock(chip().mtx);
+    return chip().log;
+}
+
+} // namespace FakeGpio
+
+extern "C" {
+
+gpiod_chip* gpiod_chip_open(const char*) {
+    return new gpiod_chip{0};
+}
+
+gpiod_chip* gpiod_chip_open_by_name(const char*) {
+    return new gpiod_chip{0};
+}
+
+gpiod_chip* gpiod_chip_open_by_number(unsigned int) {
+    return new gpiod_chip{0};
+}
+
+void gpiod_chip_close(gpiod_chip* chip) {
+    delete chip;
+}
+
+gpiod_line* gpiod_chip_get_line(gpiod_chip*, unsigned int offset) {
+    std::lock_guard<std::recursive_mutex> lock(chip().mtx);
+    return lineAt(offset);
+}
+
+int gpiod_chip_get_lines(gpiod_chip*, unsigned int* offsets, unsigned int num_offsets, gpiod_line_bulk* bulk) {
+    if (num_offsets > GPIOD_LINE_BULK_MAX_LINES) {
+        errno = EINVAL;
+        return -1;
+    }
+    std::lock_guard<std::recursive_mutex> lock(chip().mtx);
+    for (unsigned int i = 0; i < num_offsets; ++i) {
+        bulk->lines[i] = lineAt(offsets[i]);
+    }
+    bulk->num_lines = num_offsets;
+    return 0;
+}
+
+unsigned int gpiod_line_offset(gpiod_line* line) {
+    return line->offset;
+}
+
+int gpiod_line_request(gpiod_line* line, const gpiod_line_request_config* config, int default_val) {
+    return requestOne(line, config->request_type, config->flags, default_val);
+}
+
+int gpiod_line_request_input(gpiod_line* line, const char*) {
+    return requestOne(line, GPIOD_LINE_REQUEST_DIRECTION_INPUT, 0, 0);
+}
+
+int gpiod_line_request_output(gpiod_line* line, const char*, int default_val) {
+    return requestOne(line, GPIOD_LINE_REQUEST_DIRECTION_OUTPUT, 0, default_val);
+}
+
+int gpiod_line_request_rising_edge_events(gpiod_line* line, const char*) {
+    return requestOne(line, GPIOD_LINE_REQUEST_EVENT_RISING_EDGE, 0, 0);
+}
+
+int gpiod_line_request_falling_edge_events(gpiod_line* line, const char*) {
+    return requestOne(line, GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE, 0, 0);
+}
+
+int gpiod_line_request_both_edges_events(gpiod_line* line, const char*) {
+    return requestOne(line, GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES, 0, 0);
+}
+
+int gpiod_line_request_bulk(gpiod_line_bulk* bulk, const gpiod_line_request_config* config, const int* default_vals) {
+    return requestBulk(bulk, config->request_type, config->flags, default_vals);
+}
+
+int gpiod_line_request_bulk_input(gpiod_line_bulk* bulk, const char*) {
+    return requestBulk(bulk, GPIOD_LINE_REQUEST_DIRECTION_INPUT, 0, nullptr);
+}
+
+int gpiod_line_request_bulk_output(gpiod_line_bulk* bulk, const char*, const int* default_vals) {
+    return requestBulk(bulk, GPIOD_LINE_REQUEST_DIRECTION_OUTPUT, 0, default_vals);
+}
+
+int gpiod_line_request_bulk_falling_edge_events(gpiod_line_bulk* bulk, const char*) {
+    return requestBulk(bulk, GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE, 0, nullptr);
+}
+
+int gpiod_line_request_bulk_both_edges_events(gpiod_line_bulk* bulk, const char*) {
+    return requestBulk(bulk, GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES, 0, nullptr);
+}
+
+void gpiod_line_release(gpiod_line* line) {
+    gpiod_line_bulk bulk{};
+    bulk.lines[0] = line;
+    bulk.num_lines = 1;
+    gpiod_line_release_bulk(&bulk);
+}
+
+void gpiod_line_release_bulk(gpiod_line_bulk* bulk) {
+    std::lock_guard<std::recursive_mutex> lock(chip().mtx);
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) {
+        gpiod_line& line = *bulk->lines[i];
+        line = gpiod_line{line.offset, false, false, false, 0, 0, true, {}};
+    }
+    changedLocked();
+}
+
+int gpiod_line_get_value(gpiod_line* line) {
+    int value = 0;
+    gpiod_line_bulk bulk{};
+    bulk.lines[0] = line;
+    bulk.num_lines = 1;
+    return gpiod_line_get_value_bulk(&bulk, &value) < 0 ? -1 : value;
+}
+
+int gpiod_line_get_value_bulk(gpiod_line_bulk* bulk, int* values) {
+    std::lock_guard<std::recursive_mutex> lock(chip().mtx);
+    if (!heldBulk(bulk)) {
+        return -1;
+    }
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) {
+        values[i] = levelOf(*bulk->lines[i]) ? 1 : 0;
+    }
+    return 0;
+}
+
+int gpiod_line_set_value(gpiod_line* line, int value) {
+    gpiod_line_bulk bulk{};
+    bulk.lines[0] = line;
+    bulk.num_lines = 1;
+    return gpiod_line_set_value_bulk(&bulk, &value);
+}
+
+int gpiod_line_set_value_bulk(gpiod_line_bulk* bulk, const int* values) {
+    Chip& c = chip();
+    std::lock_guard<std::recursive_mutex> lock(c.mtx);
+    if (!heldBulk(bulk)) {
+        return -1;
+    }
+    FakeGpio::Write write;
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) {
+        if (!bulk->lines[i]->output) {
+            errno = EPERM;
+            return -1;
+        }
+    }
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) {
+        bulk->lines[i]->value = values[i] ? 1 : 0;
+        write.offsets.push_back(bulk->lines[i]->offset);
+        write.values.push_back(values[i] ? 1 : 0);
+    }
+    c.log.push_back(write);
+    changedLocked();
+    return 0;
+}
+
+int gpiod_line_set_direction_input(gpiod_line* line) {
+    gpiod_line_bulk bulk{};
+    bulk.lines[0] = line;
+    bulk.num_lines = 1;
+    return gpiod_line_set_direction_input_bulk(&bulk);
+}
+
+int gpiod_line_set_direction_input_bulk(gpiod_line_bulk* bulk) {
+    std::lock_guard<std::recursive_mutex> lock(chip().mtx);
+    if (!heldBulk(bulk)) {
+        return -1;
+    }
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) {
+        bulk->lines[i]->output = false;
+    }
+    changedLocked();
+    return 0;
+}
+
+int gpiod_line_set_direction_output(gpiod_line* line, int value) {
+    gpiod_line_bulk bulk{};
+    bulk.lines[0] = line;
+    bulk.num_lines = 1;
+    return gpiod_line_set_direction_output_bulk(&bulk, &value);
+}
+
+int gpiod_line_set_direction_output_bulk(gpiod_line_bulk* bulk, const int* values) {
+    std::lock_guard<std::recursive_mutex> lock(chip().mtx);
+    if (!heldBulk(bulk)) {
+        return -1;
+    }
+    for (unsigned int i = 0; i < bulk->num_lines; ++i) {
+        bulk->lines[i]->output = true;
+    }
+    return gpiod_line_set_value_bulk(bulk, values);
+}
+
+int gpiod_line_event_wait(gpiod_line* line, const timespec* timeout) {
+    gpiod_line_bulk bulk{};
+    bulk.lines[0] = line;
+    bulk.num_lines = 1;
+    return gpiod_line_event_wait_bulk(&bulk, timeout, nullptr);
+}
+
+int gpiod_line_event_wait_bulk(gpiod_line_bulk* bulk, const timespec* timeout, gpiod_line_bulk* event_bulk) {
+    Chip& c = chip();
+    std::unique_lock<std::recursive_mutex> lock(c.mtx);
+    auto pending = [bulk]() {
+        for (unsigned int i = 0; i < bulk->num_lines; ++i) {
+            if (!bulk->lines[i]->events.empty()) {
+                return true;
+            }
+        }
+        return false;
+    };
+    if (timeout) {
+        const auto limit = std::chrono::seconds(timeout->tv_sec) + std::chrono::nanoseconds(timeout->tv_nsec);
+        if (!c.cv.wait_for(lock, limit, pending)) {
+            return 0;
+        }
+    } else {
+        c.cv.wait(lock, pending);
+    }
+    if (event_bulk) {
+        event_bulk->num_lines = 0;
+        for (unsigned int i = 0; i < bulk->num_lines; ++i) {
+            if (!bulk->lines[i]->events.empty()) {
+                event_bulk->lines[event_bulk->num_lines++] = bulk->lines[i];
+            }
+        }
+    }
+    return 1;
+}
+
+int gpiod_line_event_read(gpiod_line* line, gpiod_line_event* event) {
+    return gpiod_line_event_read_multiple(line, event, 1) == 1 ? 0 : -1;
+}
+
+int gpiod_line_event_read_multiple(gpiod_line* line, gpiod_line_event* events, unsigned int num_events) {
+    std::lock_guard<std::recursive_mutex> lock(chip().mtx);
+    if (!line->held || line->edges == 0) {
+        errno = EPERM;
+        return -1;
+    }
+    unsigned int count = 0;
+    while (count < num_events && !line->events.empty()) {
+        events[count++] = line->events.front();
+        line->events.pop_front();
+    }
+    return static_cast<int>(count);
+}
+
+} // extern "C"
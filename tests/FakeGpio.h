@@ -0,0 +1,90 @@
+#ifndef FAKEGPIO_H
+#define FAKEGPIO_H
+
+#include <vector>
+
+/**
+ * @brief Control side of the in-memory chip behind tests/fake/gpiod.h.
+ *
+ * A line's level is what its consumer drives when it is a push-pull
+ * output; otherwise it is what the attached Device (or setInput()) puts on
+ * it, pulled high when nobody does, and an open-drain output additionally
+ * pulls it low while written 0. Every value write is logged, and edges on
+ * lines requested for events are queued for the event calls, stamped with
+ * PreciseTimer::now() so they follow VirtualTimer.cpp in tests linking it.
+ *
+ * All calls are serialised on one recursive lock, which is also held while
+ * a Device is called back, so a Device may query level() freely.
+ */
+namespace FakeGpio {
+
+/**
+ * @brief Simulated hardware attached to the chip.
+ */
+class Device {
+public:
+    virtual ~Device() = default;
+
+    /**
+     * @brief Returns the level the device puts on a line; true leaves it to the pull-up.
+     */
+    virtual bool drive(unsigned int offset) = 0;
+
+    /**
+     * @brief Called after every value write by a consumer, once the new values are in place.
+     */
+    virtual void changed() {}
+};
+
+/**
+ * @brief One gpiod_line_set_value(_bulk) call.
+ */
+struct Write {
+    std::vector<unsigned int> offsets;
+    std::vector<int> values;
+};
+
+/**
+ * @brief Forgets every line, the write log and the attached device.
+ */
+void reset();
+
+/**
+ * @brief Attaches the device that drives the lines (nullptr to detach).
+ */
+void attach(Device* device);
+
+/**
+ * @brief Sets the externally driven level of a line when no device is attached.
+ */
+void setInput(unsigned int offset, bool level);
+
+/**
+ * @brief Re-evaluates the line levels; call after a device changes what it drives on its own.
+ */
+void refresh();
+
+/**
+ * @brief Returns the current level of a line.
+ */
+bool level(unsigned int offset);
+
+/**
+ * @brief Returns what the consumer drives on a line: its last written value
+ * while it is an output, otherwise true (released).
+ */
+bool driven(unsigned int offset);
+
+/**
+ * @brief Returns true while a consumer holds the line.
+ */
+bool requested(unsigned int offset);
+
+/**
+ * @brief Returns the value writes logged since reset().
+ */
+std::vector<Write> writes();
+
+} // namespace FakeGpio
+
+#endif // FAKEGPIO_H
@@ -0,0 +1,103 @@
+#include "Check.h"
+#include "FakeGpio.h"
+#include "Hub75Panel.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+/**
+ * @brief Bit-by-bit reference for Hub75Panel::convertBitplanes().
+ */
+std::vector<uint8_t> referenceBitplanes(const std::vector<uint8_t>& r, const std::vector<uint8_t>& g,
+                                        const std::vector<uint8_t>& b, std::size_t width, std::size_t height,
+                                        unsigned int planes) {
+    const std::size_t pairs = height / 2;
+    std::vector<uint8_t> out(planes * pairs * width);
+    for (unsigned int plane = 0; plane < planes; ++plane) {
+        const unsigned int bit = 8 - planes + plane;
+        for (std::size_t row = 0; row < pairs; ++row) {
+            for (std::size_t x = 0; x < width; ++x) {
+                const std::size_t top = row * width + x;
+                const std::size_t bottom = (row + pairs) * width + x;
+                const uint8_t channels[6] = {r[top], g[top], b[top], r[bottom], g[bottom], b[bottom]};
+                uint8_t packed = 0;
+                for (unsigned int c = 0; c < 6; ++c) {
+                    packed |= static_cast<uint8_t>(((channels[c] >> bit) & 1) << c);
+                }
+                out[(plane * pairs + row) * width + x] = packed;
+            }
+        }
+    }
+    return out;
+}
+
+void testConvertMatchesScalar() {
+    std::mt19937 random(64);
+    // Widths below 16 run only the scalar loop, multiples of 16 only the SSE2
+    // loop on x86, and the rest both.
+    for (std::size_t width : {1u, 8u, 16u, 37u, 64u, 100u}) {
+        for (std::size_t height : {2u, 16u, 32u}) {
+            for (unsigned int planes : {1u, 3u, 8u}) {
+                std::vector<uint8_t> r(width * height);
+                std::vector<uint8_t> g(width * height);
+                std::vector<uint8_t> b(width * height);
+                for (std::size_t i = 0; i < r.size(); ++i) {
+                    r[i] = static_cast<uint8_t>(random());
+                    g[i] = static_cast<uint8_t>(random());
+                    b[i] = static_cast<uint8_t>(random());
+                }
+                // Guard bytes catch a vector store running past the row.
+                std::vector<uint8_t> out(planes * (height / 2) * width + 16, 0xAA);
+                Hub75Panel::convertBitplanes(r.data(), g.data(), b.data(), width, height, planes, out.data());
+                const std::vector<uint8_t> expected = referenceBitplanes(r, g, b, width, height, planes);
+                CHECK(std::vector<uint8_t>(out.begin(), out.begin() + expected.size()) == expected);
+                CHECK(std::vector<uint8_t>(out.begin() + expected.size(), out.end()) == std::vector<uint8_t>(16, 0xAA));
+            }
+        }
+    }
+}
+
+void testDrawingDuringFlipWait() {
+    FakeGpio::reset();
+    DigitalPort port({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, DigitalPin::Direction::Output);
+    Hub75Config config;
+    config.width = 8;
+    config.height = 4;
+    config.planes = 2;
+    // 60 ms frames, so a swap waits up to that long for its flip.
+    config.lsbTime = milliseconds(10);
+    Hub75Panel panel(port, config);
+
+    int drawnWhilePending = 0;
+    for (int i = 0; i < 5; ++i) {
+        std::atomic<bool> swapped(false);
+        std::thread swapper([&]() {
+            panel.swapBuffers();
+            swapped = true;
+        });
+        std::this_thread::sleep_for(milliseconds(5));
+        panel.setPixel(static_cast<std::size_t>(i), 1, 0xFF, 0, 0);
+        if (!swapped) {
+            ++drawnWhilePending;
+        }
+        swapper.join();
+    }
+    CHECK(drawnWhilePending > 0);
+    CHECK(panel.frames() >= 4);
+}
+
+} // namespace
+
+int main() {
+    testConvertMatchesScalar();
+    testDrawingDuringFlipWait();
+    return checkResult();
+}
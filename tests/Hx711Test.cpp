@@ -0,0 +1,171 @@
+#include "Check.h"
+#include "FakeGpio.h"
+#include "Hx711.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+constexpr unsigned int DOUT = 5;
+constexpr unsigned int SCK = 6;
+
+/**
+ * @brief HX711 model: conversion n is ready period * (n + 1) after start.
+ *
+ * DOUT is low while an unread conversion is waiting. Each SCK rising edge
+ * shifts out the next of its 24 bits, MSB first; the 25th pulls DOUT high
+ * again until the following conversion.
+ */
+class LoadCell : public FakeGpio::Device {
+public:
+    explicit LoadCell(unsigned int rate) : period(nanoseconds(seconds(1)) / rate), start(steady_clock::now()) {
+        ticker = std::thread([this]() {
+            // Re-evaluate DOUT at each conversion so that it falls on time.
+            for (long n = 1; !stopping; ++n) {
+                std::this_thread::sleep_until(start + period * n);
+                FakeGpio::refresh();
+            }
+        });
+    }
+
+    ~LoadCell() override {
+        stopping = true;
+        ticker.join();
+    }
+
+    /**
+     * @brief Returns the 24-bit two's complement value of conversion n.
+     */
+    static int32_t value(long n) {
+        const int32_t raw = static_cast<int32_t>((n * 2654435761u) & 0xFFFFFF);
+        return raw & 0x800000 ? raw - 0x1000000 : raw;
+    }
+
+    bool drive(unsigned int offset) override {
+        if (offset != DOUT) {
+            return true;
+        }
+        if (pulse >= 1 && pulse <= 24) {
+            return (value(index) >> (24 - pulse)) & 0x1;
+        }
+        return available() <= lastRead;
+    }
+
+    void changed() override {
+        const bool high = FakeGpio::level(SCK);
+        if (high && !sckHigh) {
+            if ((pulse == 0 || pulse >= 25) && available() > lastRead) {
+                index = available();
+                skipped += index - lastRead - 1;
+                pulse = 1;
+            } else if (pulse > 0) {
+                ++pulse;
+            }
+            if (pulse == 24) {
+                lastRead = index;
+                reads.push_back(value(index));
+            }
+        }
+        sckHigh = high;
+    }
+
+    /**
+     * @brief Returns the number of conversions finished so far.
+     */
+    long produced() const {
+        return available() + 1;
+    }
+
+    std::vector<int32_t> reads;
+    long skipped = 0;
+
+private:
+    long available() const {
+        return static_cast<long>((steady_clock::now() - start) / period) - 1;
+    }
+
+    nanoseconds period;
+    steady_clock::time_point start;
+    std::atomic<bool> stopping{false};
+    std::thread ticker;
+    long index = -1;
+    long lastRead = -1;
+    int pulse = 0;
+    bool sckHigh = false;
+};
+
+double processCpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Samples for a while at one chip rate and reports what was kept up with.
+ */
+void sampleAt(unsigned int rate, milliseconds runTime, bool strict) {
+    FakeGpio::reset();
+    LoadCell cell(rate);
+    FakeGpio::attach(&cell);
+    std::vector<int32_t> values;
+    Hx711::Stats stats;
+    long produced;
+    double cpu;
+    {
+        Hx711 adc(DOUT, SCK, Hx711::Gain::A128, rate);
+        const double cpuStart = processCpuSeconds();
+        const auto end = steady_clock::now() + runTime;
+        Hx711::Sample sample;
+        while (steady_clock::now() < end) {
+            while (adc.pop(sample)) {
+                values.push_back(sample.value);
+            }
+            std::this_thread::sleep_for(milliseconds(5));
+        }
+        cpu = (processCpuSeconds() - cpuStart) / duration<double>(runTime).count();
+        produced = cell.produced();
+        stats = adc.stats();
+        while (adc.pop(sample)) {
+            values.push_back(sample.value);
+        }
+    }
+    FakeGpio::attach(nullptr);
+
+    // Every sample is the conversion the chip shifted out, bit for bit.
+    CHECK(values.size() == stats.samples);
+    CHECK(values.size() <= cell.reads.size());
+    bool exact = true;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        exact = exact && values[i] == cell.reads[i];
+    }
+    CHECK(exact);
+    CHECK(stats.dropped == 0);
+    if (strict) {
+        // At the chip's own rates no conversion is overwritten unread.
+        CHECK(cell.skipped == 0);
+        CHECK(static_cast<long>(stats.samples) + 2 >= produced);
+    }
+
+    const double seconds = duration<double>(runTime).count();
+    std::printf("Hx711: %u SPS chip: %.1f samples/s sustained, %ld of %ld conversions missed (%lu counted), "
+                "%lu long pulses, %.2f%% CPU\n",
+                rate, stats.samples / seconds, cell.skipped, produced, stats.missed, stats.longPulses, 100 * cpu);
+}
+
+} // namespace
+
+int main() {
+    sampleAt(10, milliseconds(1000), true);
+    sampleAt(80, milliseconds(2000), true);
+    // Beyond the chip's rates: shows the headroom of one read per edge.
+    sampleAt(1000, milliseconds(1000), false);
+    return checkResult();
+}
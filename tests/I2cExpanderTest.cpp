@@ -0,0 +1,227 @@
+#include "Check.h"
+#include "I2cExpander.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using Chip = I2cExpander::Chip;
+
+// MCP23017 registers with IOCON.BANK = 0.
+constexpr uint8_t IODIRA = 0x00;
+constexpr uint8_t GPINTENA = 0x04;
+constexpr uint8_t IOCON = 0x0A;
+constexpr uint8_t GPPUA = 0x0C;
+constexpr uint8_t GPIOA = 0x12;
+constexpr uint8_t OLATA = 0x14;
+
+/**
+ * @brief Simulated MCP23017 on the far end of a SOCK_SEQPACKET pair.
+ *
+ * Each packet is one I2C transaction. The test answers a read before it
+ * happens by queueing the GPIO value, then calls process() to apply the
+ * transactions the expander sent: a one-byte write sets the register
+ * pointer for a read, a longer one writes registers from its first byte on.
+ */
+class Mcp23017 {
+public:
+    Mcp23017() {
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) < 0) {
+            throw std::runtime_error("socketpair failed");
+        }
+        host = fds[0];
+        device = fds[1];
+    }
+
+    ~Mcp23017() {
+        if (device >= 0) {
+            ::close(device);
+        }
+    }
+
+    /**
+     * @brief Returns the descriptor to hand to the expander, which then owns it.
+     */
+    int hostFd() const {
+        return host;
+    }
+
+    /**
+     * @brief Queues the reply to the expander's next GPIO read.
+     */
+    void queueInputs(uint16_t value) {
+        const uint8_t bytes[2] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)};
+        CHECK(::send(device, bytes, 2, 0) == 2);
+    }
+
+    /**
+     * @brief Applies every transaction sent since the last call.
+     * @return The transactions, one vector of bytes each.
+     */
+    std::vector<std::vector<uint8_t>> process() {
+        std::vector<std::vector<uint8_t>> transactions;
+        uint8_t buffer[16];
+        ssize_t length;
+        while ((length = ::recv(device, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+            transactions.emplace_back(buffer, buffer + length);
+            for (ssize_t i = 1; i < length; ++i) {
+                registers[buffer[0] + i - 1] = buffer[i];
+            }
+        }
+        return transactions;
+    }
+
+    uint16_t word(uint8_t regA) const {
+        return static_cast<uint16_t>(registers[regA] | (registers[regA + 1] << 8));
+    }
+
+    void disconnect() {
+        ::close(device);
+        device = -1;
+    }
+
+    uint8_t registers[0x16] = {};
+
+private:
+    int host;
+    int device;
+};
+
+void testInitialisation() {
+    Mcp23017 chip;
+    I2cExpander expander(chip.hostFd(), Chip::MCP23017, true);
+    chip.process();
+    CHECK(chip.registers[IOCON] == 0x40);
+    CHECK(chip.word(IODIRA) == 0xFFFF);
+    CHECK(chip.word(GPPUA) == 0x0000);
+    CHECK(chip.word(OLATA) == 0x0000);
+    CHECK(chip.word(GPINTENA) == 0xFFFF);
+}
+
+void testFlushWritesChangedRegistersOnce() {
+    Mcp23017 chip;
+    I2cExpander expander(chip.hostFd(), Chip::MCP23017);
+    chip.process();
+    const unsigned long before = expander.transactions();
+
+    // A batch within port A is one single-register write.
+    expander.set(0, true);
+    expander.set(3, true);
+    expander.set(5, true);
+    CHECK(chip.process().empty());
+    expander.flush();
+    std::vector<std::vector<uint8_t>> sent = chip.process();
+    CHECK(sent.size() == 1);
+    CHECK(sent.size() == 1 && sent[0] == std::vector<uint8_t>({OLATA, 0x29}));
+
+    // Changes on both ports go out as one sequential OLATA/OLATB write.
+    expander.set(0, false);
+    expander.set(12, true);
+    expander.flush();
+    sent = chip.process();
+    CHECK(sent.size() == 1 && sent[0] == std::vector<uint8_t>({OLATA, 0x28, 0x10}));
+    CHECK(chip.word(OLATA) == 0x1028);
+
+    // Nothing changed, nothing sent; setting a bit back and forth is no change.
+    expander.set(3, false);
+    expander.set(3, true);
+    expander.flush();
+    CHECK(chip.process().empty());
+    CHECK(expander.transactions() == before + 2);
+
+    // A masked update leaves the unmasked lines alone.
+    expander.setMasked(0x0F0F, 0x0A05);
+    expander.flush();
+    sent = chip.process();
+    CHECK(sent.size() == 1 && sent[0] == std::vector<uint8_t>({OLATA, 0x25, 0x1A}));
+
+    // A PCF8574 has no port B.
+    Mcp23017 bus;
+    I2cExpander pcf(bus.hostFd(), Chip::PCF8574);
+    bool threw = false;
+    try {
+        pcf.setMasked(0x0100, 0x0100);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void testInputCache() {
+    Mcp23017 chip;
+    I2cExpander expander(chip.hostFd(), Chip::MCP23017, true);
+    chip.process();
+
+    chip.queueInputs(0x8001);
+    CHECK(expander.readAll() == 0x8001);
+    std::vector<std::vector<uint8_t>> sent = chip.process();
+    CHECK(sent.size() == 1 && sent[0] == std::vector<uint8_t>({GPIOA}));
+
+    // Served from the cache until INT fires.
+    const unsigned long before = expander.transactions();
+    CHECK(expander.read(0));
+    CHECK(expander.read(15));
+    CHECK(!expander.read(1));
+    CHECK(expander.transactions() == before);
+
+    expander.onInterrupt();
+    chip.queueInputs(0x0002);
+    CHECK(expander.readAll() == 0x0002);
+    CHECK(chip.process().size() == 1);
+    CHECK(expander.readAll() == 0x0002);
+    CHECK(chip.process().empty());
+}
+
+void testFlushInvalidatesCache() {
+    Mcp23017 chip;
+    I2cExpander expander(chip.hostFd(), Chip::MCP23017, true);
+    chip.process();
+    chip.queueInputs(0x0000);
+    CHECK(expander.readAll() == 0x0000);
+
+    // Driving an output changes what it reads back without any INT edge.
+    expander.setDirection(4, DigitalPin::Direction::Output);
+    chip.queueInputs(0x0000);
+    CHECK(expander.readAll() == 0x0000);
+    expander.write(4, true);
+    chip.queueInputs(0x0010);
+    CHECK(expander.read(4));
+    chip.process();
+
+    expander.set(4, false);
+    expander.flush();
+    chip.queueInputs(0x0000);
+    CHECK(!expander.read(4));
+    CHECK(chip.process().back() == std::vector<uint8_t>({GPIOA}));
+}
+
+void testBusFailure() {
+    Mcp23017 chip;
+    I2cExpander expander(chip.hostFd(), Chip::MCP23017);
+    chip.process();
+    chip.disconnect();
+    bool threw = false;
+    try {
+        expander.write(0, true);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+} // namespace
+
+int main() {
+    testInitialisation();
+    testFlushWritesChangedRegistersOnce();
+    testInputCache();
+    testFlushInvalidatesCache();
+    testBusFailure();
+    return checkResult();
+}
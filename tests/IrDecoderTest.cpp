@@ -0,0 +1,226 @@
+#include "Check.h"
+#include "IrDecoder.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+using Protocol = IrCommand::Protocol;
+
+/**
+ * @brief Drives an active-low demodulated receiver output.
+ */
+struct Transmitter {
+    IrDecoder& decoder;
+    nanoseconds t{seconds(1)};
+
+    void mark(long us) {
+        decoder.onEdge({false, t});
+        t += microseconds(us);
+    }
+
+    void space(long us) {
+        decoder.onEdge({true, t});
+        t += microseconds(us);
+    }
+
+    /// Ends the frame and lets the line idle for the given gap.
+    void idle(milliseconds gap) {
+        decoder.onEdge({true, t});
+        t += gap;
+        decoder.poll(t);
+    }
+
+    void nec(uint32_t value) {
+        mark(9000);
+        space(4500);
+        for (int i = 0; i < 32; ++i) {
+            mark(560);
+            space(((value >> i) & 1) ? 1690 : 560);
+        }
+        mark(560);
+        idle(milliseconds(40));
+    }
+
+    void necRepeat() {
+        mark(9000);
+        space(2250);
+        mark(560);
+        idle(milliseconds(95));
+    }
+
+    /// Plays unit-sized levels, skipping the leading and trailing idle space.
+    void levels(const std::vector<bool>& units, long unitUs) {
+        std::size_t i = 0;
+        while (i < units.size() && !units[i]) {
+            ++i;
+        }
+        while (i < units.size()) {
+            std::size_t j = i;
+            while (j < units.size() && units[j] == units[i]) {
+                ++j;
+            }
+            if (j == units.size() && !units[i]) {
+                break;
+            }
+            const long us = static_cast<long>(j - i) * unitUs;
+            if (units[i]) {
+                mark(us);
+            } else {
+                space(us);
+            }
+            i = j;
+        }
+        idle(milliseconds(100));
+    }
+
+    void rc5(bool toggle, unsigned address, unsigned command) {
+        const uint32_t value = (1u << 13) | ((command & 0x40) ? 0 : (1u << 12)) | (toggle ? 1u << 11 : 0) |
+                               ((address & 0x1F) << 6) | (command & 0x3F);
+        std::vector<bool> units;
+        for (int i = 13; i >= 0; --i) {
+            const bool bit = (value >> i) & 1;
+            units.push_back(!bit);
+            units.push_back(bit);
+        }
+        levels(units, 889);
+    }
+
+    void rc6(bool toggle, unsigned address, unsigned command) {
+        std::vector<bool> units(6, true);
+        units.insert(units.end(), 2, false);
+        auto bit = [&units](bool value, int width) {
+            units.insert(units.end(), static_cast<std::size_t>(width), value);
+            units.insert(units.end(), static_cast<std::size_t>(width), !value);
+        };
+        bit(true, 1);
+        for (int i = 0; i < 3; ++i) {
+            bit(false, 1);
+        }
+        bit(toggle, 2);
+        const unsigned data = ((address & 0xFF) << 8) | (command & 0xFF);
+        for (int i = 15; i >= 0; --i) {
+            bit((data >> i) & 1, 1);
+        }
+        levels(units, 444);
+    }
+};
+
+uint32_t necValue(uint8_t address, uint8_t command) {
+    return address | (uint32_t(uint8_t(~address)) << 8) | (uint32_t(command) << 16) |
+           (uint32_t(uint8_t(~command)) << 24);
+}
+
+void testNecWithRepeat() {
+    IrDecoder decoder;
+    Transmitter tx{decoder};
+    tx.nec(necValue(0x04, 0x08));
+    tx.necRepeat();
+    tx.necRepeat();
+
+    const auto commands = decoder.readAvailable();
+    CHECK(commands.size() == 3);
+    if (commands.size() == 3) {
+        CHECK(commands[0].protocol == Protocol::NEC);
+        CHECK(commands[0].address == 0x04 && commands[0].command == 0x08 && !commands[0].repeat);
+        CHECK(commands[1].repeat && commands[1].command == 0x08);
+        CHECK(commands[2].repeat && commands[2].address == 0x04);
+    }
+    CHECK(decoder.stats().frames == 1);
+    CHECK(decoder.stats().repeats == 2);
+}
+
+void testExtendedNec() {
+    IrDecoder decoder;
+    Transmitter tx{decoder};
+    tx.nec(0x1234 | (uint32_t(0x5A) << 16) | (uint32_t(0xA5) << 24));
+    const auto commands = decoder.readAvailable();
+    CHECK(commands.size() == 1 && commands[0].address == 0x1234 && commands[0].command == 0x5A);
+}
+
+void testRepeatWithoutCommandIsUnknown() {
+    IrDecoder decoder;
+    Transmitter tx{decoder};
+    tx.necRepeat();
+    CHECK(decoder.readAvailable().empty());
+    CHECK(decoder.stats().unknown == 1);
+}
+
+void testRc5() {
+    IrDecoder decoder;
+    Transmitter tx{decoder};
+    tx.rc5(true, 5, 0x23);
+    tx.rc5(true, 5, 0x23);
+    tx.rc5(false, 5, 0x45);
+
+    const auto commands = decoder.readAvailable();
+    CHECK(commands.size() == 3);
+    if (commands.size() == 3) {
+        CHECK(commands[0].protocol == Protocol::RC5);
+        CHECK(commands[0].address == 5 && commands[0].command == 0x23 && commands[0].toggle);
+        CHECK(!commands[0].repeat);
+        // Same toggle within the window: a held key.
+        CHECK(commands[1].repeat);
+        // Command bit 6 travels as the inverted second start bit.
+        CHECK(commands[2].command == 0x45 && !commands[2].toggle && !commands[2].repeat);
+    }
+}
+
+void testRc6() {
+    IrDecoder decoder;
+    Transmitter tx{decoder};
+    tx.rc6(true, 0x10, 0x0C);
+    tx.rc6(false, 0x10, 0x0C);
+
+    const auto commands = decoder.readAvailable();
+    CHECK(commands.size() == 2);
+    if (commands.size() == 2) {
+        CHECK(commands[0].protocol == Protocol::RC6);
+        CHECK(commands[0].address == 0x10 && commands[0].command == 0x0C && commands[0].toggle);
+        CHECK(!commands[1].toggle && !commands[1].repeat);
+    }
+}
+
+void testGarbageIsUnknown() {
+    IrDecoder decoder;
+    Transmitter tx{decoder};
+    tx.mark(3000);
+    tx.space(3000);
+    tx.mark(3000);
+    tx.idle(milliseconds(50));
+    CHECK(decoder.readAvailable().empty());
+    CHECK(decoder.stats().unknown == 1);
+}
+
+void testReceiversAreIndependent() {
+    // One reactor can interleave edges of several receivers.
+    IrDecoder first;
+    IrDecoder second;
+    Transmitter a{first};
+    Transmitter b{second};
+    a.mark(9000);
+    b.mark(2664);
+    a.space(4500);
+    b.space(888);
+    CHECK(first.nextDeadline() == a.t - microseconds(4500) + IrDecoder::FRAME_GAP);
+    first.poll(a.t);
+    second.poll(b.t);
+    CHECK(first.readAvailable().empty() && second.readAvailable().empty());
+}
+
+} // namespace
+
+int main() {
+    testNecWithRepeat();
+    testExtendedNec();
+    testRepeatWithoutCommandIsUnknown();
+    testRc5();
+    testRc6();
+    testGarbageIsUnknown();
+    testReceiversAreIndependent();
+    return checkResult();
+}
@@ -0,0 +1,199 @@
+#include "Check.h"
+#include "FakeGpio.h"
+#include "MatrixScanner.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+constexpr std::size_t ROWS = 4;
+constexpr std::size_t COLUMNS = 4;
+constexpr unsigned int ROW0 = 20;
+constexpr unsigned int COLUMN0 = 24;
+
+/**
+ * @brief Diode key matrix: a pressed key pulls its column low while its row is driven low.
+ */
+class KeyMatrix : public FakeGpio::Device {
+public:
+    bool drive(unsigned int offset) override {
+        if (offset < COLUMN0 || offset >= COLUMN0 + COLUMNS) {
+            return true;
+        }
+        const std::size_t column = offset - COLUMN0;
+        for (std::size_t row = 0; row < ROWS; ++row) {
+            if (((pressed[row] >> column) & 0x1) && !FakeGpio::level(ROW0 + static_cast<unsigned int>(row))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void set(std::size_t row, std::size_t column, bool down) {
+        if (down) {
+            pressed[row] |= uint64_t(1) << column;
+        } else {
+            pressed[row] &= ~(uint64_t(1) << column);
+        }
+        FakeGpio::refresh();
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, ROWS> pressed{};
+};
+
+using KeyEvent = std::tuple<std::size_t, std::size_t, bool>;
+
+/**
+ * @brief Scanner on the fake chip with a log of its callbacks.
+ */
+struct Keyboard {
+    KeyMatrix matrix;
+    DigitalPort rows;
+    std::mutex mtx;
+    std::vector<KeyEvent> events;
+    MatrixScanner scanner;
+
+    Keyboard()
+        : rows(attached({ROW0, ROW0 + 1, ROW0 + 2, ROW0 + 3}), DigitalPin::Direction::Output),
+          scanner(rows, {COLUMN0, COLUMN0 + 1, COLUMN0 + 2, COLUMN0 + 3},
+                  [this](std::size_t row, std::size_t column, bool pressed) {
+                      std::lock_guard<std::mutex> lock(mtx);
+                      events.emplace_back(row, column, pressed);
+                  }) {}
+
+    /**
+     * @brief Resets the chip and attaches the matrix before the rows are requested.
+     */
+    std::vector<unsigned int> attached(std::vector<unsigned int> pins) {
+        FakeGpio::reset();
+        FakeGpio::attach(&matrix);
+        return pins;
+    }
+
+    std::size_t eventCount() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return events.size();
+    }
+
+    /**
+     * @brief Waits up to a second for the callback log to reach count entries.
+     */
+    bool waitForEvents(std::size_t count) {
+        const auto limit = steady_clock::now() + seconds(1);
+        while (eventCount() < count && steady_clock::now() < limit) {
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+        return eventCount() == count;
+    }
+
+    /**
+     * @brief Waits until the scanner has gone back to waiting for edges.
+     */
+    void waitUntilIdle() {
+        unsigned long scans;
+        do {
+            scans = scanner.scans();
+            std::this_thread::sleep_for(milliseconds(20));
+        } while (scanner.scans() != scans);
+    }
+};
+
+double processCpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void testKeystroke() {
+    Keyboard keyboard;
+    keyboard.waitUntilIdle();
+
+    // No polling while idle.
+    const unsigned long idleScans = keyboard.scanner.scans();
+    std::this_thread::sleep_for(milliseconds(250));
+    CHECK(keyboard.scanner.scans() == idleScans);
+
+    keyboard.matrix.set(1, 2, true);
+    CHECK(keyboard.waitForEvents(1));
+    CHECK(keyboard.scanner.state()[1] == (uint64_t(1) << 2));
+    keyboard.matrix.set(1, 2, false);
+    CHECK(keyboard.waitForEvents(2));
+    CHECK(keyboard.events == std::vector<KeyEvent>({KeyEvent(1, 2, true), KeyEvent(1, 2, false)}));
+
+    // The scan's own row writes leave no edge behind to wake it again.
+    keyboard.waitUntilIdle();
+    const unsigned long afterScans = keyboard.scanner.scans();
+    std::this_thread::sleep_for(milliseconds(250));
+    CHECK(keyboard.scanner.scans() == afterScans);
+}
+
+void testRollover() {
+    Keyboard keyboard;
+    keyboard.waitUntilIdle();
+    keyboard.matrix.set(0, 0, true);
+    keyboard.matrix.set(2, 3, true);
+    keyboard.matrix.set(3, 1, true);
+    CHECK(keyboard.waitForEvents(3));
+    const std::vector<uint64_t> state = keyboard.scanner.state();
+    CHECK(state == std::vector<uint64_t>({0x1, 0x0, 0x8, 0x2}));
+
+    keyboard.matrix.set(2, 3, false);
+    CHECK(keyboard.waitForEvents(4));
+    keyboard.matrix.set(0, 0, false);
+    keyboard.matrix.set(3, 1, false);
+    CHECK(keyboard.waitForEvents(6));
+    CHECK(keyboard.scanner.state() == std::vector<uint64_t>(ROWS, 0));
+}
+
+/**
+ * @brief Reports the CPU the scanner uses while idle and while typing.
+ *
+ * Ten keystrokes per second of 40 ms each; the fake chip makes each line
+ * operation cheaper than a real ioctl, so this is a lower bound that shows
+ * the idle cost is only the periodic shutdown check.
+ */
+void reportCpu() {
+    Keyboard keyboard;
+    keyboard.waitUntilIdle();
+
+    double start = processCpuSeconds();
+    auto wall = steady_clock::now();
+    std::this_thread::sleep_for(seconds(1));
+    const double idle = (processCpuSeconds() - start) / duration<double>(steady_clock::now() - wall).count();
+
+    const unsigned long scansBefore = keyboard.scanner.scans();
+    start = processCpuSeconds();
+    wall = steady_clock::now();
+    for (std::size_t key = 0; key < 10; ++key) {
+        keyboard.matrix.set(key % ROWS, (key / ROWS) % COLUMNS, true);
+        std::this_thread::sleep_for(milliseconds(40));
+        keyboard.matrix.set(key % ROWS, (key / ROWS) % COLUMNS, false);
+        std::this_thread::sleep_for(milliseconds(60));
+    }
+    const double typing = (processCpuSeconds() - start) / duration<double>(steady_clock::now() - wall).count();
+    CHECK(keyboard.waitForEvents(20));
+
+    std::printf("MatrixScanner: %.2f%% CPU idle, %.2f%% CPU typing 10 keys/s (%lu scans)\n", 100 * idle,
+                100 * typing, keyboard.scanner.scans() - scansBefore);
+}
+
+} // namespace
+
+int main() {
+    testKeystroke();
+    testRollover();
+    reportCpu();
+    return checkResult();
+}
@@ -0,0 +1,144 @@
+#include "Check.h"
+#include "MotionPlanner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+using Tick = MotionPlanner::Tick;
+
+/**
+ * @brief One move of a planned path with the speeds the planner gave it.
+ */
+struct Segment {
+    std::vector<int64_t> delta;
+    double entrySpeed;
+    double cruiseSpeed;
+    double exitSpeed;
+};
+
+constexpr double ACCELERATION = 50000.0;
+
+/**
+ * @brief Three-axis path: accelerate along a diagonal, carry speed through
+ *        two gentle corners, reverse one axis from rest, and stop.
+ */
+const std::vector<Segment> PATH = {
+    {{1000, 400, 0}, 0.0, 8000.0, 3000.0},
+    {{800, 600, 50}, 3000.0, 8000.0, 2000.0},
+    {{-3, 250, 7}, 2000.0, 4000.0, 0.0},
+    {{0, -1, -999}, 0.0, 6000.0, 0.0},
+};
+
+int64_t majorSteps(const std::vector<int64_t>& delta) {
+    int64_t major = 0;
+    for (int64_t d : delta) {
+        major = std::max<int64_t>(major, std::llabs(d));
+    }
+    return major;
+}
+
+void testStepTotals() {
+    for (const Segment& segment : PATH) {
+        const std::vector<Tick> ticks = MotionPlanner::interpolate(segment.delta, segment.entrySpeed,
+                                                                    segment.cruiseSpeed, segment.exitSpeed,
+                                                                    ACCELERATION);
+        const int64_t major = majorSteps(segment.delta);
+        CHECK(static_cast<int64_t>(ticks.size()) == major);
+
+        std::vector<int64_t> steps(segment.delta.size(), 0);
+        for (std::size_t k = 0; k < ticks.size(); ++k) {
+            CHECK(ticks[k].stepBits >> segment.delta.size() == 0);
+            for (std::size_t i = 0; i < segment.delta.size(); ++i) {
+                if (ticks[k].stepBits & (uint64_t(1) << i)) {
+                    ++steps[i];
+                }
+                // Every axis stays within one step of the straight line.
+                const double ideal = static_cast<double>(k + 1) * std::llabs(segment.delta[i]) / major;
+                CHECK(std::fabs(steps[i] - ideal) <= 1.0);
+            }
+        }
+        for (std::size_t i = 0; i < segment.delta.size(); ++i) {
+            CHECK(steps[i] == std::llabs(segment.delta[i]));
+        }
+    }
+}
+
+void testTickTiming() {
+    nanoseconds t(0);
+    double previousSpeed = 0.0;
+    bool previousEndedAtSpeed = false;
+    for (const Segment& segment : PATH) {
+        const std::vector<Tick> ticks = MotionPlanner::interpolate(segment.delta, segment.entrySpeed,
+                                                                    segment.cruiseSpeed, segment.exitSpeed,
+                                                                    ACCELERATION);
+        const double stepLength = std::sqrt(static_cast<double>(std::inner_product(
+                                      segment.delta.begin(), segment.delta.end(), segment.delta.begin(), int64_t(0)))) /
+                                  majorSteps(segment.delta);
+        // Shortest interval the cruise speed allows, with a nanosecond for truncation.
+        const nanoseconds fastest(static_cast<int64_t>(1e9 * stepLength / segment.cruiseSpeed) - 1);
+
+        for (std::size_t k = 0; k < ticks.size(); ++k) {
+            CHECK(ticks[k].interval > nanoseconds(0));
+            CHECK(ticks[k].interval >= fastest);
+            t += ticks[k].interval;
+        }
+        // A junction taken at speed continues without a gap: the path speed of
+        // the first tick of this move is within 10% of the previous move's last.
+        if (previousEndedAtSpeed && segment.entrySpeed > 0 && !ticks.empty()) {
+            const double ratio = (1e9 * stepLength / ticks.front().interval.count()) / previousSpeed;
+            CHECK(ratio > 0.9 && ratio < 1.1);
+        }
+        previousEndedAtSpeed = segment.exitSpeed > 0;
+        if (!ticks.empty()) {
+            previousSpeed = 1e9 * stepLength / ticks.back().interval.count();
+        }
+    }
+    CHECK(t > nanoseconds(0));
+}
+
+void testAccelerationProfile() {
+    // A move long enough to cruise speeds up, holds, then slows down.
+    const std::vector<Tick> ticks = MotionPlanner::interpolate({4000, 1000}, 0.0, 5000.0, 0.0, ACCELERATION);
+    const std::size_t half = ticks.size() / 2;
+    for (std::size_t k = 1; k <= half; ++k) {
+        CHECK(ticks[k].interval <= ticks[k - 1].interval);
+    }
+    for (std::size_t k = half + 1; k < ticks.size(); ++k) {
+        CHECK(ticks[k].interval >= ticks[k - 1].interval);
+    }
+    CHECK(ticks[half].interval < ticks.front().interval);
+    CHECK(ticks[half].interval < ticks.back().interval);
+}
+
+void testInterpolatorOwnsDelta() {
+    // The interpolator keeps its own copy, so a temporary delta is fine.
+    MotionPlanner::Interpolator interpolator(std::vector<int64_t>{3, -2}, 0.0, 1000.0, 0.0, ACCELERATION);
+    Tick tick;
+    int64_t ticks = 0;
+    int64_t minor = 0;
+    while (interpolator.next(tick)) {
+        ++ticks;
+        minor += (tick.stepBits >> 1) & 0x1;
+    }
+    CHECK(ticks == 3);
+    CHECK(minor == 2);
+}
+
+} // namespace
+
+int main() {
+    testStepTotals();
+    testTickTiming();
+    testAccelerationProfile();
+    testInterpolatorOwnsDelta();
+    return checkResult();
+}
@@ -0,0 +1,333 @@
+#include "Check.h"
+#include "FakeGpio.h"
+#include "OneWire.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+constexpr unsigned int DQ = 7;
+
+/**
+ * @brief Builds a ROM code with a valid CRC from a family code and serial number.
+ */
+uint64_t makeRom(uint8_t family, uint64_t serial) {
+    uint8_t bytes[8];
+    bytes[0] = family;
+    for (int i = 1; i < 7; ++i) {
+        bytes[i] = static_cast<uint8_t>(serial >> (8 * (i - 1)));
+    }
+    bytes[7] = OneWire::crc8(bytes, 7);
+    uint64_t rom = 0;
+    for (int i = 0; i < 8; ++i) {
+        rom |= uint64_t(bytes[i]) << (8 * i);
+    }
+    return rom;
+}
+
+/**
+ * @brief One simulated DS18B20 following ROM and function commands bit by bit.
+ */
+class Sensor {
+public:
+    Sensor(uint64_t rom, double celsius) : rom(rom) {
+        const int16_t raw = static_cast<int16_t>(celsius * 16);
+        const uint8_t bytes[8] = {static_cast<uint8_t>(raw), static_cast<uint8_t>(raw >> 8), 0x4B, 0x46, 0x7F,
+                                  0xFF, 0x0C, 0x10};
+        std::copy(bytes, bytes + 8, scratchpad);
+        scratchpad[8] = OneWire::crc8(scratchpad, 8);
+    }
+
+    void reset() {
+        phase = Phase::RomCommand;
+        count = 0;
+        shift = 0;
+    }
+
+    /**
+     * @brief Returns true if the sensor sends in this slot, with the bit in bit.
+     */
+    bool sending(bool& bit) const {
+        if (phase == Phase::Search && searchStep < 2) {
+            bit = ((rom >> count) & 0x1) != (searchStep == 1);
+            return true;
+        }
+        if (phase == Phase::ReadScratchpad) {
+            bit = (scratchpad[count / 8] >> (count % 8)) & 0x1;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Finishes a slot in which the master wrote (or read) bit.
+     */
+    void slot(bool bit) {
+        switch (phase) {
+        case Phase::Idle:
+            break;
+        case Phase::RomCommand:
+        case Phase::Function:
+            shift |= uint64_t(bit) << count;
+            if (++count == 8) {
+                command(static_cast<uint8_t>(shift));
+            }
+            break;
+        case Phase::MatchRom:
+            shift |= uint64_t(bit) << count;
+            if (++count == 64) {
+                phase = shift == rom ? Phase::Function : Phase::Idle;
+                count = 0;
+                shift = 0;
+            }
+            break;
+        case Phase::Search:
+            if (searchStep < 2) {
+                ++searchStep;
+            } else if (bit != ((rom >> count) & 0x1)) {
+                // Lost the arbitration; wait for the next reset.
+                phase = Phase::Idle;
+            } else {
+                searchStep = 0;
+                if (++count == 64) {
+                    phase = Phase::Function;
+                    count = 0;
+                    shift = 0;
+                }
+            }
+            break;
+        case Phase::ReadScratchpad:
+            if (++count == 72) {
+                phase = Phase::Idle;
+            }
+            break;
+        }
+    }
+
+    const uint64_t rom;
+
+private:
+    enum class Phase { Idle, RomCommand, MatchRom, Search, Function, ReadScratchpad };
+
+    void command(uint8_t code) {
+        const bool romCommand = phase == Phase::RomCommand;
+        phase = Phase::Idle;
+        count = 0;
+        shift = 0;
+        if (romCommand && code == 0xF0) {
+            phase = Phase::Search;
+            searchStep = 0;
+        } else if (romCommand && code == 0x55) {
+            phase = Phase::MatchRom;
+        } else if (romCommand && code == 0xCC) {
+            phase = Phase::Function;
+        } else if (!romCommand && code == 0xBE) {
+            phase = Phase::ReadScratchpad;
+        }
+    }
+
+    uint8_t scratchpad[9];
+    Phase phase = Phase::Idle;
+    int count = 0;
+    int searchStep = 0;
+    uint64_t shift = 0;
+};
+
+/**
+ * @brief 1-Wire bus of simulated sensors, timed on the virtual clock.
+ *
+ * A master low of 240 us or more is a reset, answered by a presence pulse
+ * from 15 to 135 us after the release. Shorter lows are slots: a sensor
+ * that is sending a 0 holds the line for the first 30 us, and a written
+ * bit is 1 if the master released within 15 us.
+ */
+class Bus : public FakeGpio::Device {
+public:
+    std::vector<std::unique_ptr<Sensor>> sensors;
+    std::set<int> glitchResets;     ///< resets (1-based) after which the first sample of a 0 runs late
+    int resets = 0;
+
+    bool drive(unsigned int offset) override {
+        if (offset != DQ) {
+            return true;
+        }
+        const auto now = PreciseTimer::now();
+        if (!sensors.empty() && now >= presenceStart && now < presenceStart + microseconds(120)) {
+            return false;
+        }
+        if (inSlot) {
+            if (glitch) {
+                // The host stalled between release and sample.
+                glitch = false;
+                PreciseTimer().sleepFor(microseconds(20));
+            }
+            if (slotSendsZero && now < slotStart + microseconds(30)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void changed() override {
+        const bool master = FakeGpio::driven(DQ);
+        if (master == masterLevel) {
+            return;
+        }
+        masterLevel = master;
+        const auto now = PreciseTimer::now();
+        if (!master) {
+            slotStart = now;
+            inSlot = true;
+            slotSendsZero = false;
+            for (const auto& sensor : sensors) {
+                bool bit;
+                if (sensor->sending(bit) && !bit) {
+                    slotSendsZero = true;
+                }
+            }
+            return;
+        }
+        const auto low = now - slotStart;
+        inSlot = false;
+        if (low >= microseconds(240)) {
+            ++resets;
+            glitch = glitchResets.count(resets) != 0;
+            presenceStart = now + microseconds(15);
+            for (const auto& sensor : sensors) {
+                sensor->reset();
+            }
+            return;
+        }
+        // Keep the line-level view of a read slot for the sensors that sent.
+        const bool bit = low < microseconds(15) && !slotSendsZero;
+        for (const auto& sensor : sensors) {
+            sensor->slot(bit);
+        }
+        // A slot that is still being sampled keeps the sensors' drive until 30 us.
+        inSlot = slotSendsZero;
+    }
+
+private:
+    bool masterLevel = true;
+    bool inSlot = false;
+    bool slotSendsZero = false;
+    bool glitch = false;
+    PreciseTimer::Clock::time_point slotStart;
+    PreciseTimer::Clock::time_point presenceStart;
+};
+
+std::vector<uint64_t> sorted(std::vector<uint64_t> roms) {
+    std::sort(roms.begin(), roms.end());
+    return roms;
+}
+
+void testSearchAndRead() {
+    FakeGpio::reset();
+    Bus bus;
+    std::vector<uint64_t> expected;
+    const double temperatures[] = {21.5, -10.125, 85.0, 0.0625};
+    for (int i = 0; i < 4; ++i) {
+        const uint64_t rom = makeRom(OneWire::DS18B20_FAMILY, 0x1000 + 0x31 * i * i);
+        bus.sensors.push_back(std::make_unique<Sensor>(rom, temperatures[i]));
+        expected.push_back(rom);
+    }
+    FakeGpio::attach(&bus);
+    OneWire wire(static_cast<int>(DQ));
+
+    CHECK(wire.reset());
+    const std::vector<uint64_t> found = wire.search();
+    CHECK(sorted(found) == sorted(expected));
+    CHECK(wire.timingViolations() == 0);
+
+    for (int i = 0; i < 4; ++i) {
+        CHECK(wire.readTemperature(expected[i]) == temperatures[i]);
+    }
+    const std::map<uint64_t, double> swept = wire.sweep(found, milliseconds(750));
+    CHECK(swept.size() == 4);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(swept.at(expected[i]) == temperatures[i]);
+    }
+}
+
+void testFamilySearch() {
+    FakeGpio::reset();
+    Bus bus;
+    const uint64_t ds18b20 = makeRom(OneWire::DS18B20_FAMILY, 0x777);
+    bus.sensors.push_back(std::make_unique<Sensor>(makeRom(0x10, 0x123), 20.0));
+    bus.sensors.push_back(std::make_unique<Sensor>(ds18b20, 20.0));
+    bus.sensors.push_back(std::make_unique<Sensor>(makeRom(0x3B, 0x456), 20.0));
+    FakeGpio::attach(&bus);
+    OneWire wire(static_cast<int>(DQ));
+
+    CHECK(wire.search(OneWire::DS18B20_FAMILY) == std::vector<uint64_t>{ds18b20});
+    CHECK(wire.search().size() == 3);
+}
+
+void testEmptyBus() {
+    FakeGpio::reset();
+    Bus bus;
+    FakeGpio::attach(&bus);
+    OneWire wire(static_cast<int>(DQ));
+
+    CHECK(!wire.reset());
+    CHECK(wire.search().empty());
+    bool threw = false;
+    try {
+        wire.readTemperature(makeRom(OneWire::DS18B20_FAMILY, 1));
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void testRetriesArePerRom() {
+    FakeGpio::reset();
+    Bus bus;
+    std::vector<uint64_t> expected;
+    for (int i = 0; i < 2; ++i) {
+        expected.push_back(makeRom(OneWire::DS18B20_FAMILY, 0x42 + i));
+        bus.sensors.push_back(std::make_unique<Sensor>(expected.back(), 25.0));
+    }
+    // Three late passes before each ROM: within the budget only if it
+    // starts over after every ROM found.
+    bus.glitchResets = {1, 2, 3, 5, 6, 7};
+    FakeGpio::attach(&bus);
+    OneWire wire(static_cast<int>(DQ));
+
+    std::vector<uint64_t> found;
+    try {
+        found = wire.search();
+    } catch (const std::runtime_error&) {
+    }
+    CHECK(sorted(found) == sorted(expected));
+    CHECK(wire.timingViolations() == 6);
+
+    // A fourth late pass in a row still fails the search.
+    bus.resets = 0;
+    bus.glitchResets = {1, 2, 3, 4};
+    bool threw = false;
+    try {
+        wire.search();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+} // namespace
+
+int main() {
+    testSearchAndRead();
+    testFamilySearch();
+    testEmptyBus();
+    testRetriesArePerRom();
+    return checkResult();
+}
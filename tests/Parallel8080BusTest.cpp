@@ -0,0 +1,117 @@
+#include "Check.h"
+#include "FakeGpio.h"
+#include "Parallel8080Bus.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Returns the port words written since the chip was reset, from the write log.
+ */
+std::vector<uint64_t> portWords(const std::vector<unsigned int>& pins) {
+    std::vector<uint64_t> words;
+    for (const FakeGpio::Write& write : FakeGpio::writes()) {
+        uint64_t word = 0;
+        for (std::size_t i = 0; i < write.offsets.size(); ++i) {
+            for (std::size_t bit = 0; bit < pins.size(); ++bit) {
+                if (pins[bit] == write.offsets[i] && write.values[i]) {
+                    word |= uint64_t(1) << bit;
+                }
+            }
+        }
+        words.push_back(word);
+    }
+    return words;
+}
+
+std::vector<unsigned int> linesFor(unsigned int dataWidth) {
+    std::vector<unsigned int> pins;
+    for (unsigned int i = 0; i < dataWidth + 3; ++i) {
+        pins.push_back(30 + i);
+    }
+    return pins;
+}
+
+/**
+ * @brief Checks the bus protocol over a write log and returns the words latched.
+ *
+ * Every WR rising edge must see CS low, D/C and CS may only change while WR
+ * is high, and the log must end idle with WR and CS high.
+ */
+std::vector<uint64_t> latched(const std::vector<uint64_t>& words, unsigned int dataWidth,
+                              std::vector<bool>* dcLevels) {
+    const uint64_t wr = uint64_t(1) << dataWidth;
+    const uint64_t dc = wr << 1;
+    const uint64_t cs = wr << 2;
+    std::vector<uint64_t> data;
+    for (std::size_t i = 1; i < words.size(); ++i) {
+        const uint64_t before = words[i - 1];
+        const uint64_t after = words[i];
+        if (!(before & wr) && (after & wr)) {
+            CHECK(!(after & cs));
+            CHECK((before & ~wr) == (after & ~wr));
+            data.push_back(after & (wr - 1));
+            if (dcLevels) {
+                dcLevels->push_back((after & dc) != 0);
+            }
+        }
+        if ((before ^ after) & (dc | cs)) {
+            CHECK((before & wr) && (after & wr));
+        }
+    }
+    CHECK(!words.empty() && (words.back() & (wr | cs)) == (wr | cs));
+    return data;
+}
+
+void testEightBitSequence() {
+    FakeGpio::reset();
+    const std::vector<unsigned int> pins = linesFor(8);
+    DigitalPort port(pins, DigitalPin::Direction::Output);
+    Parallel8080Bus bus(port);
+    const uint64_t wr = 1u << 8;
+    const uint64_t cs = 1u << 10;
+
+    bus.writeCommand(0x2C);
+    // Idle, select with D/C low, data with WR low, latch, deselect.
+    CHECK(portWords(pins) == std::vector<uint64_t>({wr | cs, wr, 0x2C, 0x2C | wr, wr | cs}));
+
+    const uint8_t params[] = {0x12, 0x34};
+    bus.writeData(params, 2);
+    const uint16_t pixels[] = {0xF800, 0x07E0};
+    bus.writePixels(pixels, 2);
+    bus.fillPixels(0xABCD, 2);
+    std::vector<bool> dcLevels;
+    CHECK(latched(portWords(pins), 8, &dcLevels) ==
+          std::vector<uint64_t>({0x2C, 0x12, 0x34, 0xF8, 0x00, 0x07, 0xE0, 0xAB, 0xCD, 0xAB, 0xCD}));
+    CHECK(dcLevels == std::vector<bool>({false, true, true, true, true, true, true, true, true, true, true}));
+    CHECK(bus.strobes() == 11);
+
+    // Between calls the chip is deselected, so another device can share the data lines.
+    CHECK(port.lastWritten() == (wr | cs));
+}
+
+void testSixteenBitSequence() {
+    FakeGpio::reset();
+    const std::vector<unsigned int> pins = linesFor(16);
+    DigitalPort port(pins, DigitalPin::Direction::Output);
+    Parallel8080Bus bus(port, 16);
+
+    bus.writeCommand(0x2C);
+    const uint16_t pixels[] = {0xF800, 0x07E0, 0x001F};
+    bus.writePixels(pixels, 3);
+    bus.fillPixels(0x1234, 2);
+    std::vector<bool> dcLevels;
+    CHECK(latched(portWords(pins), 16, &dcLevels) ==
+          std::vector<uint64_t>({0x2C, 0xF800, 0x07E0, 0x001F, 0x1234, 0x1234}));
+    CHECK(dcLevels == std::vector<bool>({false, true, true, true, true, true}));
+}
+
+} // namespace
+
+int main() {
+    testEightBitSequence();
+    testSixteenBitSequence();
+    return checkResult();
+}
@@ -0,0 +1,137 @@
+#include "Check.h"
+#include "QuadratureEncoder.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+using namespace std::chrono;
+
+namespace {
+
+using Channel = QuadratureEncoder::Channel;
+
+/**
+ * @brief Generates x4 quadrature edges, one every period.
+ */
+struct Shaft {
+    QuadratureEncoder& encoder;
+    bool a = false;
+    bool b = false;
+    nanoseconds t{seconds(1)};
+    int phase = 0;
+
+    void step(int direction, nanoseconds period) {
+        // Forward sequence 00 -> 10 -> 11 -> 01 with state = (A << 1) | B.
+        phase = (phase + direction + 4) % 4;
+        t += period;
+        const bool newA = phase == 1 || phase == 2;
+        const bool newB = phase == 2 || phase == 3;
+        if (newA != a) {
+            a = newA;
+            encoder.onEdge(Channel::A, {a, t});
+        } else {
+            b = newB;
+            encoder.onEdge(Channel::B, {b, t});
+        }
+    }
+};
+
+void testCountsBothDirections() {
+    QuadratureEncoder encoder(false, false);
+    Shaft shaft{encoder};
+    for (int i = 0; i < 1000; ++i) {
+        shaft.step(+1, microseconds(100));
+    }
+    CHECK(encoder.position() == 1000);
+    for (int i = 0; i < 250; ++i) {
+        shaft.step(-1, microseconds(100));
+    }
+    CHECK(encoder.position() == 750);
+    CHECK(encoder.illegalTransitions() == 0);
+}
+
+void testMissedEdgeIsIllegal() {
+    QuadratureEncoder encoder(false, false);
+    Shaft shaft{encoder};
+    shaft.step(+1, microseconds(100));
+    // A rises again without the falling edge in between.
+    encoder.onEdge(Channel::A, {true, shaft.t + microseconds(100)});
+    CHECK(encoder.illegalTransitions() == 1);
+    CHECK(encoder.position() == 1);
+}
+
+void testVelocityDecaysWhenStopped() {
+    QuadratureEncoder encoder(false, false, milliseconds(10), false, milliseconds(50));
+    Shaft shaft{encoder};
+    for (int i = 0; i < 500; ++i) {
+        shaft.step(+1, microseconds(100));  // 10000 counts/s
+    }
+    const double running = encoder.velocity(shaft.t);
+    CHECK(std::fabs(running - 10000.0) < 100.0);
+    CHECK(encoder.velocity(shaft.t + milliseconds(40)) == running);
+    CHECK(encoder.velocity(shaft.t + milliseconds(60)) == 0.0);
+}
+
+void testSetPositionDoesNotShowAsMotion() {
+    QuadratureEncoder encoder(false, false, milliseconds(10));
+    Shaft shaft{encoder};
+    for (int i = 0; i < 50; ++i) {
+        shaft.step(+1, microseconds(100));
+    }
+    encoder.setPosition(1000000);
+    for (int i = 0; i < 200; ++i) {
+        shaft.step(+1, microseconds(100));
+    }
+    CHECK(encoder.position() == 1000200);
+    CHECK(std::fabs(encoder.velocity(shaft.t) - 10000.0) < 100.0);
+}
+
+void testConcurrentSetPosition() {
+    // Jumps landing anywhere in an update must never show up as motion.
+    QuadratureEncoder encoder(false, false, milliseconds(1));
+    std::atomic<bool> done(false);
+    std::thread setter([&]() {
+        int64_t value = 0;
+        while (!done) {
+            encoder.setPosition(value += 1000003);
+        }
+    });
+    Shaft shaft{encoder};
+    bool steady = true;
+    for (int i = 0; i < 200000; ++i) {
+        shaft.step(+1, microseconds(100));
+        if (i >= 20) {
+            steady = steady && std::fabs(encoder.velocity(shaft.t) - 10000.0) < 100.0;
+        }
+    }
+    done = true;
+    setter.join();
+    CHECK(steady);
+}
+
+void testIndexReset() {
+    QuadratureEncoder encoder(false, false, milliseconds(10), true);
+    Shaft shaft{encoder};
+    for (int i = 0; i < 37; ++i) {
+        shaft.step(+1, microseconds(100));
+    }
+    encoder.onEdge(Channel::Index, {true, shaft.t});
+    CHECK(encoder.indexPosition() == 37);
+    CHECK(encoder.position() == 0);
+    shaft.step(+1, microseconds(100));
+    CHECK(encoder.position() == 1);
+}
+
+} // namespace
+
+int main() {
+    testCountsBothDirections();
+    testMissedEdgeIsIllegal();
+    testVelocityDecaysWhenStopped();
+    testSetPositionDoesNotShowAsMotion();
+    testConcurrentSetPosition();
+    testIndexReset();
+    return checkResult();
+}
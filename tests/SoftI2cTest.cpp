@@ -0,0 +1,256 @@
+#include "Check.h"
+#include "FakeGpio.h"
+#include "SoftI2c.h"
+
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+constexpr unsigned int SDA = 2;
+constexpr unsigned int SCL = 3;
+constexpr uint8_t ADDRESS = 0x50;
+
+/**
+ * @brief Simulated 24Cxx-style slave: the first byte of a write sets the
+ * register pointer, later bytes are stored and reads return memory from
+ * the pointer on.
+ *
+ * It follows the bus from the line levels alone: START/STOP are SDA edges
+ * while SCL is high, bits are sampled on SCL rising edges and SDA is
+ * changed only while SCL is low.
+ */
+class I2cSlave : public FakeGpio::Device {
+public:
+    uint8_t memory[256] = {};
+    int starts = 0;
+    int stops = 0;
+    int stretchReads = 0;       ///< master SCL reads to hold the clock low for after each ACK
+    bool stretchForever = false;
+    int stretched = 0;          ///< master SCL reads answered low by stretching
+
+    bool drive(unsigned int offset) override {
+        if (offset == SDA) {
+            return sdaOut;
+        }
+        if (offset == SCL && stretching) {
+            // Only the master's own polls count down the stretch.
+            if (inChanged || stretchForever || --stretchLeft > 0) {
+                stretched += inChanged ? 0 : 1;
+                return false;
+            }
+            // Letting go of SCL is a rising edge the master did not write.
+            stretching = false;
+            changed();
+        }
+        return true;
+    }
+
+    void changed() override {
+        inChanged = true;
+        const bool scl = FakeGpio::level(SCL);
+        const bool sda = FakeGpio::level(SDA);
+        inChanged = false;
+        if (scl && prevScl && sda != prevSda) {
+            if (!sda) {
+                ++starts;
+                state = State::Address;
+                count = 0;
+                shift = 0;
+            } else {
+                ++stops;
+                state = State::Idle;
+            }
+            sdaOut = true;
+        } else if (scl && !prevScl) {
+            rise(sda);
+        } else if (!scl && prevScl) {
+            fall();
+        }
+        prevScl = scl;
+        prevSda = sda;
+    }
+
+    /**
+     * @brief Leaves the slave stuck mid-read, holding SDA low.
+     */
+    void jam() {
+        state = State::Read;
+        count = 0;
+        tx = 0x00;
+        sdaOut = false;
+    }
+
+private:
+    enum class State { Idle, Address, Write, ReadPending, Read };
+
+    void rise(bool sda) {
+        if (state == State::Idle) {
+            return;
+        }
+        if ((state == State::Address || state == State::Write) && count < 8) {
+            shift = static_cast<uint8_t>((shift << 1) | (sda ? 1 : 0));
+        } else if (state == State::Read && count == 8) {
+            masterAck = !sda;
+        }
+        ++count;
+    }
+
+    void fall() {
+        if (state == State::Idle) {
+            return;
+        }
+        if (count == 8) {
+            if (state == State::Address) {
+                const bool match = (shift >> 1) == ADDRESS;
+                state = !match ? State::Idle : (shift & 0x1) ? State::ReadPending : State::Write;
+                pointerSet = false;
+                sdaOut = !match;
+            } else if (state == State::Write) {
+                if (!pointerSet) {
+                    pointer = shift;
+                    pointerSet = true;
+                } else {
+                    memory[pointer++] = shift;
+                }
+                sdaOut = false;
+            } else {
+                // Released for the master's ACK/NACK.
+                sdaOut = true;
+            }
+        } else if (count == 9) {
+            count = 0;
+            shift = 0;
+            sdaOut = true;
+            if (state == State::ReadPending || (state == State::Read && masterAck)) {
+                state = State::Read;
+                tx = memory[pointer++];
+                sdaOut = (tx & 0x80) != 0;
+            } else if (state == State::Read) {
+                state = State::Idle;
+            }
+            if (stretchReads > 0 || stretchForever) {
+                stretching = true;
+                stretchLeft = stretchReads;
+            }
+        } else if (state == State::Read) {
+            sdaOut = ((tx >> (7 - count)) & 0x1) != 0;
+        }
+    }
+
+    State state = State::Idle;
+    bool prevScl = true;
+    bool prevSda = true;
+    bool sdaOut = true;
+    bool stretching = false;
+    bool inChanged = false;
+    int stretchLeft = 0;
+    int count = 0;
+    uint8_t shift = 0;
+    uint8_t tx = 0;
+    bool masterAck = false;
+    bool pointerSet = false;
+    uint8_t pointer = 0;
+};
+
+void testProbe() {
+    FakeGpio::reset();
+    I2cSlave slave;
+    FakeGpio::attach(&slave);
+    SoftI2c bus(SDA, SCL, 1000000);
+    CHECK(bus.probe(ADDRESS));
+    CHECK(!bus.probe(ADDRESS + 1));
+    CHECK(slave.starts == 2);
+    CHECK(slave.stops == 2);
+    CHECK(FakeGpio::level(SDA) && FakeGpio::level(SCL));
+}
+
+void testWriteThenRegisterRead() {
+    FakeGpio::reset();
+    I2cSlave slave;
+    FakeGpio::attach(&slave);
+    SoftI2c bus(SDA, SCL, 1000000);
+
+    const uint8_t tx[] = {0x10, 0xA5, 0x00, 0xFF, 0x3C};
+    bus.write(ADDRESS, tx, sizeof(tx));
+    CHECK(slave.memory[0x10] == 0xA5);
+    CHECK(slave.memory[0x11] == 0x00);
+    CHECK(slave.memory[0x12] == 0xFF);
+    CHECK(slave.memory[0x13] == 0x3C);
+
+    const uint8_t reg = 0x11;
+    uint8_t rx[3] = {};
+    bus.writeRead(ADDRESS, &reg, 1, rx, sizeof(rx));
+    CHECK(rx[0] == 0x00);
+    CHECK(rx[1] == 0xFF);
+    CHECK(rx[2] == 0x3C);
+    // One START per write, plus the repeated start of the register read.
+    CHECK(slave.starts == 3);
+    CHECK(slave.stops == 2);
+}
+
+void testNackStillStops() {
+    FakeGpio::reset();
+    I2cSlave slave;
+    FakeGpio::attach(&slave);
+    SoftI2c bus(SDA, SCL, 1000000);
+
+    const uint8_t tx[] = {0x00, 0x01};
+    bool threw = false;
+    try {
+        bus.write(ADDRESS + 1, tx, sizeof(tx));
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(slave.stops == 1);
+    CHECK(FakeGpio::level(SDA) && FakeGpio::level(SCL));
+}
+
+void testClockStretching() {
+    FakeGpio::reset();
+    I2cSlave slave;
+    slave.stretchReads = 5;
+    FakeGpio::attach(&slave);
+    SoftI2c bus(SDA, SCL, 1000000);
+
+    const uint8_t tx[] = {0x20, 0x5A, 0xC3};
+    bus.write(ADDRESS, tx, sizeof(tx));
+    CHECK(slave.memory[0x20] == 0x5A);
+    CHECK(slave.memory[0x21] == 0xC3);
+    CHECK(slave.stretched > 0);
+
+    slave.stretchForever = true;
+    bool threw = false;
+    try {
+        bus.write(ADDRESS, tx, sizeof(tx));
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void testRecoverBus() {
+    FakeGpio::reset();
+    I2cSlave slave;
+    FakeGpio::attach(&slave);
+    SoftI2c bus(SDA, SCL, 1000000);
+
+    slave.jam();
+    CHECK(!FakeGpio::level(SDA));
+    CHECK(bus.recoverBus());
+    CHECK(FakeGpio::level(SDA) && FakeGpio::level(SCL));
+    CHECK(bus.probe(ADDRESS));
+}
+
+} // namespace
+
+int main() {
+    testProbe();
+    testWriteThenRegisterRead();
+    testNackStillStops();
+    testClockStretching();
+    testRecoverBus();
+    return checkResult();
+}
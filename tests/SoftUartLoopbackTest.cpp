@@ -0,0 +1,110 @@
+#include "Check.h"
+#include "EdgeSource.h"
+#include "FakeGpio.h"
+#include "SoftUart.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+constexpr unsigned int TX = 4;
+constexpr unsigned int RX = 5;
+
+/**
+ * @brief Wire from TX to RX.
+ */
+class Loopback : public FakeGpio::Device {
+public:
+    bool drive(unsigned int offset) override {
+        return offset != RX || FakeGpio::level(TX);
+    }
+};
+
+/**
+ * @brief Sends bytes from TX and decodes the edge events that arrive on RX.
+ *
+ * Runs on the virtual clock: every TX bit lands exactly on its deadline and
+ * the RX edges carry those deadlines as timestamps.
+ */
+std::vector<uint8_t> loopback(const SoftUart::Config& config, const std::vector<uint8_t>& sent,
+                              SoftUart::Stats& stats) {
+    SoftUart uart(static_cast<int>(TX), config);
+    EdgeSource source({RX}, "SoftUart-RX");
+    uart.write(sent);
+
+    std::vector<EdgeSource::LineEdge> edges;
+    source.wait(nanoseconds(0), edges);
+    for (const EdgeSource::LineEdge& edge : edges) {
+        uart.onEdge(edge.event);
+    }
+    uart.poll(PreciseTimer::now().time_since_epoch());
+    stats = uart.stats();
+    return uart.readAvailable();
+}
+
+void testLoopback() {
+    FakeGpio::reset();
+    Loopback wire;
+    FakeGpio::attach(&wire);
+    std::vector<uint8_t> sent;
+    for (int i = 0; i < 256; ++i) {
+        sent.push_back(static_cast<uint8_t>(i));
+    }
+
+    for (uint32_t baud : {1200u, 9600u, 115200u, 921600u}) {
+        for (SoftUart::Parity parity : {SoftUart::Parity::None, SoftUart::Parity::Even, SoftUart::Parity::Odd}) {
+            SoftUart::Config config;
+            config.baud = baud;
+            config.parity = parity;
+            config.stopBits = parity == SoftUart::Parity::Odd ? 2 : 1;
+            SoftUart::Stats stats;
+            CHECK(loopback(config, sent, stats) == sent);
+            CHECK(stats.bytesReceived == sent.size());
+            CHECK(stats.parityErrors == 0);
+            CHECK(stats.framingErrors == 0);
+            CHECK(stats.falseStarts == 0);
+        }
+    }
+}
+
+/**
+ * @brief Reports the baud rate this host's TX and RX paths could sustain.
+ *
+ * The virtual clock removes the waits, so the wall time of a loopback is
+ * the cost of the line writes, event reads and decoding alone; one bit
+ * time must cover that cost. The hardware SoftUartBenchmark measures the
+ * same limit on real lines.
+ */
+void reportMaximumBaud() {
+    FakeGpio::reset();
+    Loopback wire;
+    FakeGpio::attach(&wire);
+    std::vector<uint8_t> sent(4096);
+    for (std::size_t i = 0; i < sent.size(); ++i) {
+        sent[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    SoftUart::Config config;
+    config.baud = 115200;
+    SoftUart::Stats stats;
+
+    const auto start = steady_clock::now();
+    const bool intact = loopback(config, sent, stats) == sent;
+    const double seconds = duration<double>(steady_clock::now() - start).count();
+    const double bits = static_cast<double>(sent.size()) * 10;
+    CHECK(intact);
+    std::printf("SoftUart loopback: %.0f ns of CPU per bit, maximum about %.0f baud on this host\n",
+                1e9 * seconds / bits, bits / seconds);
+}
+
+} // namespace
+
+int main() {
+    testLoopback();
+    reportMaximumBaud();
+    return checkResult();
+}
@@ -0,0 +1,152 @@
+#include "Check.h"
+#include "SoftUartReceiver.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+using Config = SoftUartReceiver::Config;
+using Parity = SoftUartReceiver::Parity;
+
+/**
+ * @brief Line levels of one frame, start bit first.
+ * @param corruptParity Send the wrong parity bit.
+ * @param breakStop Send the first stop bit low.
+ */
+std::vector<bool> frameBits(const Config& config, uint8_t data, bool corruptParity = false,
+                            bool breakStop = false) {
+    std::vector<bool> bits{false};
+    for (int i = 0; i < config.dataBits; ++i) {
+        bits.push_back((data >> i) & 0x1);
+    }
+    if (config.parity != Parity::None) {
+        bits.push_back(SoftUartReceiver::parityBit(config, data) != corruptParity);
+    }
+    for (int i = 0; i < config.stopBits; ++i) {
+        bits.push_back(!(breakStop && i == 0));
+    }
+    return bits;
+}
+
+/**
+ * @brief Feeds line levels to the receiver as edges, each bit lasting bitTime.
+ * @return Time at the end of the last bit.
+ */
+nanoseconds play(SoftUartReceiver& receiver, const std::vector<bool>& bits, nanoseconds start,
+                 nanoseconds bitTime, bool& level) {
+    nanoseconds t = start;
+    for (bool bit : bits) {
+        if (bit != level) {
+            receiver.onEdge({bit, t});
+            level = bit;
+        }
+        t += bitTime;
+    }
+    return t;
+}
+
+void testEveryConfiguration() {
+    for (Parity parity : {Parity::None, Parity::Even, Parity::Odd}) {
+        for (int dataBits = 5; dataBits <= 8; ++dataBits) {
+            for (int stopBits = 1; stopBits <= 2; ++stopBits) {
+                Config config;
+                config.baud = 115200;
+                config.dataBits = dataBits;
+                config.parity = parity;
+                config.stopBits = stopBits;
+                SoftUartReceiver receiver(config);
+                const nanoseconds bitTime(1000000000ULL / config.baud);
+
+                std::vector<uint8_t> sent;
+                bool level = true;
+                nanoseconds t = seconds(1);
+                for (int n = 0; n < 64; ++n) {
+                    const uint8_t data = static_cast<uint8_t>((n * 73 + 5) & ((1u << dataBits) - 1));
+                    sent.push_back(data);
+                    t = play(receiver, frameBits(config, data), t, bitTime, level);
+                }
+                receiver.poll(t + bitTime * 2);
+                CHECK(receiver.readAvailable() == sent);
+                const SoftUartReceiver::Stats stats = receiver.stats();
+                CHECK(stats.bytesReceived == sent.size());
+                CHECK(stats.parityErrors == 0);
+                CHECK(stats.framingErrors == 0);
+            }
+        }
+    }
+}
+
+void testClockMismatch() {
+    // Re-synchronising on every start bit tolerates a few percent of baud error.
+    for (double scale : {0.96, 1.04}) {
+        Config config;
+        config.baud = 9600;
+        SoftUartReceiver receiver(config);
+        const nanoseconds bitTime(static_cast<int64_t>(1e9 / config.baud * scale));
+        bool level = true;
+        nanoseconds t = seconds(1);
+        std::vector<uint8_t> sent;
+        for (int n = 0; n < 32; ++n) {
+            sent.push_back(static_cast<uint8_t>(n * 29));
+            t = play(receiver, frameBits(config, sent.back()), t, bitTime, level);
+        }
+        receiver.poll(t + milliseconds(1));
+        CHECK(receiver.readAvailable() == sent);
+    }
+}
+
+void testErrorsAreCounted() {
+    Config config;
+    config.parity = Parity::Even;
+    SoftUartReceiver receiver(config);
+    const nanoseconds bitTime(1000000000ULL / config.baud);
+    bool level = true;
+    nanoseconds t = seconds(1);
+    t = play(receiver, frameBits(config, 0x5A, true), t, bitTime, level);
+    t = play(receiver, frameBits(config, 0x5A, false, true), t, bitTime, level);
+    // Let the broken stop bit end before the next frame starts.
+    t = play(receiver, {true, true}, t, bitTime, level);
+    t = play(receiver, frameBits(config, 0xA5), t, bitTime, level);
+    receiver.poll(t + bitTime * 2);
+
+    CHECK(receiver.readAvailable() == std::vector<uint8_t>{0xA5});
+    const SoftUartReceiver::Stats stats = receiver.stats();
+    CHECK(stats.parityErrors == 1);
+    CHECK(stats.framingErrors == 1);
+    CHECK(stats.bytesReceived == 1);
+}
+
+void testGlitchIsFalseStart() {
+    SoftUartReceiver receiver;
+    const nanoseconds bitTime(1000000000ULL / 9600);
+    receiver.onEdge({false, seconds(1)});
+    receiver.onEdge({true, seconds(1) + bitTime / 4});
+    receiver.poll(seconds(2));
+    CHECK(receiver.stats().falseStarts == 1);
+    CHECK(receiver.readAvailable().empty());
+}
+
+void testFrameEndingHighNeedsPoll() {
+    SoftUartReceiver receiver;
+    const nanoseconds bitTime(1000000000ULL / 9600);
+    bool level = true;
+    const nanoseconds end = play(receiver, frameBits(SoftUartReceiver::Config(), 0xFF), seconds(1), bitTime, level);
+    CHECK(receiver.readAvailable().empty());
+    receiver.poll(end);
+    CHECK(receiver.readAvailable() == std::vector<uint8_t>{0xFF});
+}
+
+} // namespace
+
+int main() {
+    testEveryConfiguration();
+    testClockMismatch();
+    testErrorsAreCounted();
+    testGlitchIsFalseStart();
+    testFrameEndingHighNeedsPoll();
+    return checkResult();
+}
@@ -0,0 +1,269 @@
+#include "Check.h"
+#include "EdgeSource.h"
+#include "FakeGpio.h"
+#include "UltrasonicArray.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+
+constexpr std::size_t SENSORS = 8;
+constexpr unsigned int TRIG0 = 40;
+constexpr unsigned int ECHO0 = 48;
+constexpr microseconds ECHO_DELAY(450);
+
+double distanceOf(std::size_t sensor) {
+    return 0.3 + 0.4 * static_cast<double>(sensor);
+}
+
+/**
+ * @brief Eight HC-SR04 models: the end of a trigger pulse raises ECHO after
+ * a short delay for as long as the sound takes to the sensor's target and back.
+ */
+class Sonar : public FakeGpio::Device {
+public:
+    Sonar() : worker([this]() { run(); }) {}
+
+    ~Sonar() override {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+    bool drive(unsigned int offset) override {
+        if (offset >= ECHO0 && offset < ECHO0 + SENSORS) {
+            return echo[offset - ECHO0];
+        }
+        return true;
+    }
+
+    void changed() override {
+        const auto now = steady_clock::now();
+        for (std::size_t i = 0; i < SENSORS; ++i) {
+            // An unrequested line floats high; only the consumer's pulses count.
+            const unsigned int pin = TRIG0 + static_cast<unsigned int>(i);
+            const bool high = FakeGpio::requested(pin) && FakeGpio::level(pin);
+            if (triggerHigh[i] && !high) {
+                const auto width = duration<double>(2 * distanceOf(i) / UltrasonicArray::SPEED_OF_SOUND);
+                std::lock_guard<std::mutex> lock(mtx);
+                triggers[i].push_back(now);
+                pending.emplace(now + ECHO_DELAY, std::make_pair(i, true));
+                pending.emplace(now + ECHO_DELAY + duration_cast<nanoseconds>(width), std::make_pair(i, false));
+                cv.notify_all();
+            }
+            triggerHigh[i] = high;
+        }
+    }
+
+    std::vector<steady_clock::time_point> triggerTimes(std::size_t sensor) {
+        std::lock_guard<std::mutex> lock(mtx);
+        return triggers[sensor];
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (!stopping) {
+            if (pending.empty()) {
+                cv.wait(lock);
+                continue;
+            }
+            const auto due = pending.begin()->first;
+            if (steady_clock::now() < due) {
+                cv.wait_until(lock, due);
+                continue;
+            }
+            const std::pair<std::size_t, bool> change = pending.begin()->second;
+            pending.erase(pending.begin());
+            lock.unlock();
+            echo[change.first] = change.second;
+            FakeGpio::refresh();
+            lock.lock();
+        }
+    }
+
+    std::array<std::atomic<bool>, SENSORS> echo{};
+    std::array<bool, SENSORS> triggerHigh{};
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::multimap<steady_clock::time_point, std::pair<std::size_t, bool>> pending;
+    std::array<std::vector<steady_clock::time_point>, SENSORS> triggers;
+    bool stopping = false;
+    std::thread worker;
+};
+
+std::vector<int> triggerPins(std::size_t count) {
+    std::vector<int> pins;
+    for (std::size_t i = 0; i < count; ++i) {
+        pins.push_back(static_cast<int>(TRIG0 + i));
+    }
+    return pins;
+}
+
+template<typename Function>
+bool throwsInvalidArgument(Function function) {
+    try {
+        function();
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+void testScheduleLimits() {
+    FakeGpio::reset();
+    // Eight sensors at the defaults fit in two slots of four.
+    CHECK(!throwsInvalidArgument([]() { UltrasonicArray array(triggerPins(SENSORS)); }));
+    CHECK(!throwsInvalidArgument([]() { UltrasonicArray array(triggerPins(1), 40); }));
+    CHECK(throwsInvalidArgument([]() { UltrasonicArray array(triggerPins(SENSORS), 21); }));
+    CHECK(throwsInvalidArgument([]() { UltrasonicArray array(triggerPins(1), 41); }));
+    CHECK(throwsInvalidArgument([]() { UltrasonicArray array(triggerPins(0)); }));
+}
+
+double processCpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+double standardDeviation(const std::vector<double>& values) {
+    if (values.size() < 2) {
+        return 0.0;
+    }
+    double mean = 0.0;
+    for (double value : values) {
+        mean += value;
+    }
+    mean /= static_cast<double>(values.size());
+    double sum = 0.0;
+    for (double value : values) {
+        sum += (value - mean) * (value - mean);
+    }
+    return std::sqrt(sum / static_cast<double>(values.size() - 1));
+}
+
+/**
+ * @brief Ranges eight sensors at 20 Hz through an EdgeSource reactor and
+ * reports CPU, trigger jitter and distance jitter.
+ *
+ * The echo edges are stamped when the simulator's sleeps end, so the range
+ * error includes the simulator's own wake-up latency and is an upper bound
+ * for kernel-timestamped edges; on a loaded single core the odd late wake-up
+ * shows in the 95th percentile, which is why the checks use the median.
+ */
+void reportRanging() {
+    FakeGpio::reset();
+    Sonar sonar;
+    FakeGpio::attach(&sonar);
+
+    std::vector<unsigned int> echoPins;
+    for (unsigned int i = 0; i < SENSORS; ++i) {
+        echoPins.push_back(ECHO0 + i);
+    }
+    EdgeSource echoes(echoPins, "Ultrasonic-ECHO");
+
+    std::mutex resultsMtx;
+    std::array<std::vector<double>, SENSORS> ranges;
+    const milliseconds runTime(2000);
+    UltrasonicArray::Stats stats;
+    double cpu;
+    {
+        UltrasonicArray array(triggerPins(SENSORS), 20, milliseconds(25), [&](std::size_t sensor, double meters) {
+            std::lock_guard<std::mutex> lock(resultsMtx);
+            ranges[sensor].push_back(meters);
+        });
+        std::atomic<bool> reacting(true);
+        std::thread reactor([&]() {
+            std::vector<EdgeSource::LineEdge> edges;
+            while (reacting) {
+                edges.clear();
+                echoes.wait(milliseconds(50), edges);
+                for (const EdgeSource::LineEdge& edge : edges) {
+                    array.onEcho(edge.line, edge.event);
+                }
+            }
+        });
+
+        const double cpuStart = processCpuSeconds();
+        std::this_thread::sleep_for(runTime);
+        cpu = (processCpuSeconds() - cpuStart) / duration<double>(runTime).count();
+        stats = array.stats();
+        reacting = false;
+        reactor.join();
+    }
+    FakeGpio::attach(nullptr);
+
+    // Sensors of one slot fire together, neighbours a slot apart.
+    std::array<std::vector<steady_clock::time_point>, SENSORS> triggers;
+    for (std::size_t i = 0; i < SENSORS; ++i) {
+        triggers[i] = sonar.triggerTimes(i);
+        CHECK(!triggers[i].empty());
+    }
+    for (std::size_t i = 0; i + 1 < SENSORS; ++i) {
+        if (!triggers[i].empty() && !triggers[i + 1].empty()) {
+            const auto apart = triggers[i + 1].front() - triggers[i].front();
+            CHECK(apart >= milliseconds(20) || apart <= -milliseconds(20));
+        }
+        if (i >= 2 && !triggers[i].empty() && !triggers[i % 2].empty()) {
+            CHECK(triggers[i].front() - triggers[i % 2].front() < milliseconds(2));
+        }
+    }
+
+    double triggerJitter = 0.0;
+    std::vector<double> errors;
+    std::lock_guard<std::mutex> lock(resultsMtx);
+    for (std::size_t i = 0; i < SENSORS; ++i) {
+        std::vector<double> intervals;
+        for (std::size_t k = 1; k < triggers[i].size(); ++k) {
+            intervals.push_back(duration<double>(triggers[i][k] - triggers[i][k - 1]).count());
+        }
+        triggerJitter = std::max(triggerJitter, standardDeviation(intervals));
+        for (double meters : ranges[i]) {
+            errors.push_back(std::fabs(meters - distanceOf(i)));
+        }
+
+        CHECK(ranges[i].size() >= 30);
+        if (!ranges[i].empty()) {
+            std::vector<double> sorted = ranges[i];
+            std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+            CHECK(std::fabs(sorted[sorted.size() / 2] - distanceOf(i)) < 0.02);
+        }
+    }
+    CHECK(stats.timeouts <= 2);
+
+    std::sort(errors.begin(), errors.end());
+    auto percentile = [&errors](double p) {
+        return errors.empty() ? 0.0 : errors[static_cast<std::size_t>(p * static_cast<double>(errors.size() - 1))];
+    };
+    std::printf("UltrasonicArray: 8 sensors at 20 Hz: %lu measurements, %lu timeouts, %.2f%% CPU, "
+                "trigger jitter %.1f us (max lateness %.1f us), range error %.2f mm median, %.2f mm p95\n",
+                stats.measurements, stats.timeouts, 100 * cpu, triggerJitter * 1e6,
+                duration<double, std::micro>(stats.maxTriggerLateness).count(), percentile(0.5) * 1e3,
+                percentile(0.95) * 1e3);
+}
+
+} // namespace
+
+int main() {
+    testScheduleLimits();
+    reportRanging();
+    return checkResult();
+}
@@ -0,0 +1,54 @@
+#include "PreciseTimer.h"
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief PreciseTimer on a virtual clock, linked into tests in place of PreciseTimer.cpp.
+ *
+ * now() starts at an arbitrary positive time and only moves when a thread
+ * sleeps: sleepUntil() advances the clock to the deadline and returns at
+ * once, so bit-timed protocols run as fast as the CPU allows while every
+ * deadline is met exactly. The clock is shared by all threads, which suits
+ * tests that sleep from one thread at a time.
+ */
+namespace {
+
+std::atomic<int64_t>& virtualNanoseconds() {
+    static std::atomic<int64_t> value(int64_t(1000) * 1000000000);
+    return value;
+}
+
+} // namespace
+
+PreciseTimer::PreciseTimer(std::chrono::nanoseconds spinThreshold) : spinThreshold(spinThreshold) {}
+
+PreciseTimer::Clock::time_point PreciseTimer::now() {
+    return Clock::time_point(std::chrono::nanoseconds(virtualNanoseconds().load()));
+}
+
+void PreciseTimer::sleepUntil(Clock::time_point deadline) const {
+    const int64_t target = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    int64_t current = virtualNanoseconds().load();
+    while (current < target && !virtualNanoseconds().compare_exchange_weak(current, target)) {
+    }
+}
+
+void PreciseTimer::sleepFor(std::chrono::nanoseconds duration) const {
+    sleepUntil(now() + duration);
+}
+
+void PreciseTimer::setRealtimePriority(int) {
+    // Tests run unprivileged; the policy does not matter on a virtual clock.
+}
+
+std::thread PreciseTimer::startThread(int, std::function<void()> body,
+                                      std::function<void(std::exception_ptr)> onError) {
+    return std::thread([body = std::move(body), onError = std::move(onError)]() {
+        try {
+            body();
+        } catch (...) {
+            onError(std::current_exception());
+        }
+    });
+}
@@ -0,0 +1,166 @@
+#include "Check.h"
+#include "WiegandDecoder.h"
+
+#include <chrono>
+#include <cstdint>
+
+using namespace std::chrono;
+
+namespace {
+
+using Line = WiegandDecoder::Line;
+
+int ones(uint64_t value) {
+    return __builtin_popcountll(value);
+}
+
+/**
+ * @brief Builds a frame: even parity over the first evenSpan data-plus-parity
+ * bits, odd parity over the last oddSpan, around the given data bits.
+ */
+uint64_t frame(uint64_t data, int dataBits, int evenSpan, int oddSpan) {
+    const int bits = dataBits + 2;
+    const uint64_t body = data << 1;  // parity slots at bit 0 and bit bits-1
+    const uint64_t evenMask = ((uint64_t(1) << (evenSpan - 1)) - 1) << (bits - evenSpan);
+    const uint64_t oddMask = ((uint64_t(1) << (oddSpan - 1)) - 1) << 1;
+    uint64_t raw = body;
+    if (ones(body & evenMask) % 2 != 0) {
+        raw |= uint64_t(1) << (bits - 1);
+    }
+    if (ones(body & oddMask) % 2 == 0) {
+        raw |= 1;
+    }
+    return raw;
+}
+
+/**
+ * @brief Plays a frame into the decoder as 50 us pulses every 2 ms.
+ * @return Time of the last edge.
+ */
+nanoseconds play(WiegandDecoder& decoder, uint64_t raw, int bits, nanoseconds start,
+                 nanoseconds width = microseconds(50)) {
+    nanoseconds t = start;
+    for (int i = bits - 1; i >= 0; --i) {
+        const Line line = ((raw >> i) & 1) ? Line::D1 : Line::D0;
+        decoder.onEdge(line, {false, t});
+        decoder.onEdge(line, {true, t + width});
+        t += milliseconds(2);
+    }
+    return t - milliseconds(2) + width;
+}
+
+void testH10301() {
+    WiegandDecoder decoder;
+    const uint64_t raw = frame((uint64_t(18) << 16) | 12345, 24, 13, 13);
+    const nanoseconds end = play(decoder, raw, 26, seconds(1));
+
+    decoder.poll(end + milliseconds(10));
+    CHECK(decoder.readAvailable().empty());
+    CHECK(decoder.nextDeadline() == end + milliseconds(25));
+
+    decoder.poll(end + milliseconds(25));
+    const auto frames = decoder.readAvailable();
+    CHECK(frames.size() == 1);
+    if (frames.size() == 1) {
+        CHECK(frames[0].bits == 26);
+        CHECK(frames[0].known);
+        CHECK(frames[0].parityOk);
+        CHECK(frames[0].facility == 18);
+        CHECK(frames[0].card == 12345);
+        CHECK(frames[0].raw == raw);
+    }
+    CHECK(decoder.nextDeadline() == nanoseconds(0));
+}
+
+void test34Bit() {
+    WiegandDecoder decoder;
+    const uint64_t raw = frame((uint64_t(0xBEEF) << 16) | 0x1234, 32, 17, 17);
+    const nanoseconds end = play(decoder, raw, 34, seconds(1));
+    decoder.poll(end + seconds(1));
+    const auto frames = decoder.readAvailable();
+    CHECK(frames.size() == 1);
+    if (frames.size() == 1) {
+        CHECK(frames[0].known);
+        CHECK(frames[0].parityOk);
+        CHECK(frames[0].facility == 0xBEEF);
+        CHECK(frames[0].card == 0x1234);
+    }
+}
+
+void test37Bit() {
+    // H10304: the two parity spans share bit 18.
+    const uint64_t data = (uint64_t(4242) << 19) | 345678;
+    const int bits = 37;
+    uint64_t raw = data << 1;
+    auto bitAt = [&](int i) { return int((raw >> (bits - 1 - i)) & 1); };
+    int even = 0;
+    for (int i = 1; i < 19; ++i) {
+        even += bitAt(i);
+    }
+    int odd = 0;
+    for (int i = 18; i < 36; ++i) {
+        odd += bitAt(i);
+    }
+    if (even % 2) {
+        raw |= uint64_t(1) << (bits - 1);
+    }
+    if (odd % 2 == 0) {
+        raw |= 1;
+    }
+
+    const WiegandFrame decoded = WiegandDecoder::decode(raw, bits);
+    CHECK(decoded.known);
+    CHECK(decoded.parityOk);
+    CHECK(decoded.facility == 4242);
+    CHECK(decoded.card == 345678);
+}
+
+void testParityError() {
+    WiegandDecoder decoder;
+    const uint64_t raw = frame((uint64_t(7) << 16) | 99, 24, 13, 13) ^ (uint64_t(1) << 5);
+    const nanoseconds end = play(decoder, raw, 26, seconds(1));
+    decoder.poll(end + seconds(1));
+    const auto frames = decoder.readAvailable();
+    CHECK(frames.size() == 1 && frames[0].known && !frames[0].parityOk);
+    CHECK(decoder.stats().parityErrors == 1);
+}
+
+void testFrameTimeoutSeparatesFrames() {
+    WiegandDecoder decoder;
+    const uint64_t first = frame((uint64_t(1) << 16) | 1, 24, 13, 13);
+    const uint64_t second = frame((uint64_t(2) << 16) | 2, 24, 13, 13);
+    nanoseconds end = play(decoder, first, 26, seconds(1));
+    // The second frame's first edge closes the first frame without a poll().
+    end = play(decoder, second, 26, end + milliseconds(30));
+    decoder.poll(end + milliseconds(30));
+    const auto frames = decoder.readAvailable();
+    CHECK(frames.size() == 2);
+    if (frames.size() == 2) {
+        CHECK(frames[0].card == 1 && frames[1].card == 2);
+    }
+}
+
+void testBadPulsesAndUnknownLength() {
+    WiegandDecoder decoder;
+    // A 5 us glitch is rejected; the remaining 8 good bits form an unknown length.
+    nanoseconds end = play(decoder, 0xA5, 8, seconds(1));
+    decoder.onEdge(Line::D0, {false, end + microseconds(100)});
+    decoder.onEdge(Line::D0, {true, end + microseconds(105)});
+    decoder.poll(end + seconds(1));
+    const auto frames = decoder.readAvailable();
+    CHECK(frames.size() == 1 && frames[0].bits == 8 && !frames[0].known && frames[0].raw == 0xA5);
+    CHECK(decoder.stats().badPulses == 1);
+    CHECK(decoder.stats().unknownLengths == 1);
+}
+
+} // namespace
+
+int main() {
+    testH10301();
+    test34Bit();
+    test37Bit();
+    testParityError();
+    testFrameTimeoutSeparatesFrames();
+    testBadPulsesAndUnknownLength();
+    return checkResult();
+}
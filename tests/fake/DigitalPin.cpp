@@ -0,0 +1,40 @@
+#include "DigitalPin.h"
+
+#include <stdexcept>
+
+DigitalPin::DigitalPin(int pin, Direction direction, const std::string& consumer)
+    : chip(nullptr), line(nullptr) {
+    chip = gpiod_chip_open_by_name("gpiochip0");
+    if (!chip) {
+        throw std::runtime_error("Failed to open GPIO chip");
+    }
+    line = gpiod_chip_get_line(chip, static_cast<unsigned int>(pin));
+    const int rc = !line ? -1
+                   : direction == Direction::Output ? gpiod_line_request_output(line, consumer.c_str(), 0)
+                                                    : gpiod_line_request_input(line, consumer.c_str());
+    if (rc < 0) {
+        gpiod_chip_close(chip);
+        throw std::runtime_error("Failed to request GPIO line " + std::to_string(pin));
+    }
+}
+
+DigitalPin::~DigitalPin() {
+    gpiod_line_release(line);
+    gpiod_chip_close(chip);
+}
+
+void DigitalPin::write(bool value) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (gpiod_line_set_value(line, value ? 1 : 0) < 0) {
+        throw std::runtime_error("Failed to write GPIO line");
+    }
+}
+
+bool DigitalPin::read() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    const int value = gpiod_line_get_value(line);
+    if (value < 0) {
+        throw std::runtime_error("Failed to read GPIO line");
+    }
+    return value != 0;
+}
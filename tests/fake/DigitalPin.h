@@ -0,0 +1,40 @@
+#ifndef DIGITALPIN_H
+#define DIGITALPIN_H
+
+#include <gpiod.h>
+
+#include <mutex>
+#include <string>
+
+/**
+ * @brief Stand-in for DigitalPin when the tree does not carry DigitalPin.cpp.
+ *
+ * Same interface as the library class, implemented on libgpiod so the tests
+ * drive it through the simulated lines in FakeGpio.cpp.
+ */
+class DigitalPin {
+public:
+    enum class Direction { Input, Output };
+
+    /**
+     * @brief Requests one line on gpiochip0.
+     * @throws std::runtime_error if the line cannot be requested.
+     */
+    DigitalPin(int pin, Direction direction, const std::string& consumer = "DigitalPin");
+
+    ~DigitalPin();
+
+    DigitalPin(const DigitalPin&) = delete;
+    DigitalPin& operator=(const DigitalPin&) = delete;
+
+    void write(bool value);
+
+    bool read() const;
+
+private:
+    mutable std::mutex mtx;
+    gpiod_chip* chip;
+    gpiod_line* line;
+};
+
+#endif // DIGITALPIN_H
@@ -0,0 +1,100 @@
+#ifndef FAKE_GPIOD_H
+#define FAKE_GPIOD_H
+
+#include <time.h>
+
+/**
+ * @brief Subset of the libgpiod v1 API backed by the simulated lines in FakeGpio.cpp.
+ *
+ * The tests put this directory ahead of the system include path, so the
+ * components compile unchanged and every line they request lands on the
+ * in-memory chip instead of hardware. Chip names are ignored: all chips
+ * share one set of offsets.
+ */
+extern "C" {
+
+struct gpiod_chip;
+struct gpiod_line;
+
+#define GPIOD_LINE_BULK_MAX_LINES 64
+
+struct gpiod_line_bulk {
+    struct gpiod_line* lines[GPIOD_LINE_BULK_MAX_LINES];
+    unsigned int num_lines;
+};
+
+enum {
+    GPIOD_LINE_REQUEST_DIRECTION_AS_IS = 1,
+    GPIOD_LINE_REQUEST_DIRECTION_INPUT,
+    GPIOD_LINE_REQUEST_DIRECTION_OUTPUT,
+    GPIOD_LINE_REQUEST_EVENT_FALLING_EDGE,
+    GPIOD_LINE_REQUEST_EVENT_RISING_EDGE,
+    GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES,
+};
+
+enum {
+    GPIOD_LINE_REQUEST_FLAG_OPEN_DRAIN = 1 << 0,
+    GPIOD_LINE_REQUEST_FLAG_OPEN_SOURCE = 1 << 1,
+    GPIOD_LINE_REQUEST_FLAG_ACTIVE_LOW = 1 << 2,
+};
+
+struct gpiod_line_request_config {
+    const char* consumer;
+    int request_type;
+    int flags;
+};
+
+enum {
+    GPIOD_LINE_EVENT_RISING_EDGE = 1,
+    GPIOD_LINE_EVENT_FALLING_EDGE,
+};
+
+struct gpiod_line_event {
+    struct timespec ts;
+    int event_type;
+};
+
+struct gpiod_chip* gpiod_chip_open(const char* path);
+struct gpiod_chip* gpiod_chip_open_by_name(const char* name);
+struct gpiod_chip* gpiod_chip_open_by_number(unsigned int num);
+void gpiod_chip_close(struct gpiod_chip* chip);
+struct gpiod_line* gpiod_chip_get_line(struct gpiod_chip* chip, unsigned int offset);
+int gpiod_chip_get_lines(struct gpiod_chip* chip, unsigned int* offsets, unsigned int num_offsets,
+                         struct gpiod_line_bulk* bulk);
+
+unsigned int gpiod_line_offset(struct gpiod_line* line);
+
+int gpiod_line_request(struct gpiod_line* line, const struct gpiod_line_request_config* config, int default_val);
+int gpiod_line_request_input(struct gpiod_line* line, const char* consumer);
+int gpiod_line_request_output(struct gpiod_line* line, const char* consumer, int default_val);
+int gpiod_line_request_rising_edge_events(struct gpiod_line* line, const char* consumer);
+int gpiod_line_request_falling_edge_events(struct gpiod_line* line, const char* consumer);
+int gpiod_line_request_both_edges_events(struct gpiod_line* line, const char* consumer);
+int gpiod_line_request_bulk(struct gpiod_line_bulk* bulk, const struct gpiod_line_request_config* config,
+                            const int* default_vals);
+int gpiod_line_request_bulk_input(struct gpiod_line_bulk* bulk, const char* consumer);
+int gpiod_line_request_bulk_output(struct gpiod_line_bulk* bulk, const char* consumer, const int* default_vals);
+int gpiod_line_request_bulk_falling_edge_events(struct gpiod_line_bulk* bulk, const char* consumer);
+int gpiod_line_request_bulk_both_edges_events(struct gpiod_line_bulk* bulk, const char* consumer);
+void gpiod_line_release(struct gpiod_line* line);
+void gpiod_line_release_bulk(struct gpiod_line_bulk* bulk);
+
+int gpiod_line_get_value(struct gpiod_line* line);
+int gpiod_line_get_value_bulk(struct gpiod_line_bulk* bulk, int* values);
+int gpiod_line_set_value(struct gpiod_line* line, int value);
+int gpiod_line_set_value_bulk(struct gpiod_line_bulk* bulk, const int* values);
+int gpiod_line_set_direction_input(struct gpiod_line* line);
+int gpiod_line_set_direction_input_bulk(struct gpiod_line_bulk* bulk);
+int gpiod_line_set_direction_output(struct gpiod_line* line, int value);
+int gpiod_line_set_direction_output_bulk(struct gpiod_line_bulk* bulk, const int* values);
+
+int gpiod_line_event_wait(struct gpiod_line* line, const struct timespec* timeout);
+int gpiod_line_event_wait_bulk(struct gpiod_line_bulk* bulk, const struct timespec* timeout,
+                               struct gpiod_line_bulk* event_bulk);
+int gpiod_line_event_read(struct gpiod_line* line, struct gpiod_line_event* event);
+int gpiod_line_event_read_multiple(struct gpiod_line* line, struct gpiod_line_event* events,
+                                   unsigned int num_events);
+
+} // extern "C"
+
+#endif // FAKE_GPIOD_H